@@ -0,0 +1,89 @@
+/***************************************************************************************************
+ * @file  benchmarks.hpp
+ * @brief Declaration of the benchmarks and of their shared helpers
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include "ThreadPool.hpp"
+
+/// Number of calls to the global operator new since the start of the program.
+extern std::atomic<std::size_t> allocation_count;
+
+/**
+ * @brief Measures the wall-clock duration of a function call.
+ * @param function The function to call.
+ * @return The duration of the call in seconds.
+ */
+template <typename Function>
+double measure(Function&& function) {
+    auto start = std::chrono::steady_clock::now();
+    function();
+    std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+    return duration.count();
+}
+
+/**
+ * @brief Prevents the compiler from optimizing away the computation of a value.
+ * @param value The value to keep.
+ */
+template <typename Type>
+void keep(const Type& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/**
+ * @return The numbers of threads to measure scaling with: the powers of 2 below the default thread
+ * count of ThreadPool, then that count.
+ */
+inline std::vector<std::size_t> thread_counts() {
+    std::size_t max_threads = ThreadPool::default_thread_count();
+    std::vector<std::size_t> counts;
+    for(std::size_t threads = 1 ; threads < max_threads ; threads *= 2) { counts.push_back(threads); }
+    counts.push_back(max_threads);
+    return counts;
+}
+
+/**
+ * @brief Measures the throughput of convolving an Image with a general and a separable kernel,
+ * compared to a naive convolution, and of Gaussian blurs.
+ */
+void benchmark_convolution();
+
+/**
+ * @brief Measures the throughput of the 8-bit <-> float conversions of Image, for every instruction
+ * set, and of the sRGB conversions.
+ */
+void benchmark_image_conversion();
+
+/**
+ * @brief Measures how loading many image files with load_images scales with the number of threads,
+ * compared to loading them one by one.
+ */
+void benchmark_image_loading();
+
+/**
+ * @brief Compares the multithreaded PNG encoder with stb_image_write's, for several compression
+ * levels and numbers of threads.
+ */
+void benchmark_png_encode();
+
+/**
+ * @brief Measures the throughput of resampling an Image with every filter, when shrinking and when
+ * enlarging, compared to a naive bilinear interpolation.
+ */
+void benchmark_resample();
+
+/**
+ * @brief Compares SmallArray and Array on many short-lived tiny arrays.
+ */
+void benchmark_small_array();
+
+/**
+ * @brief Measures how a 3x3 box blur over an Image scales with the number of threads.
+ */
+void benchmark_thread_pool();
@@ -0,0 +1,114 @@
+/***************************************************************************************************
+ * @file  convolution.cpp
+ * @brief Measures the throughput of the convolutions of an Image
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "Array2D.hpp"
+#include "Image.hpp"
+#include "convolution.hpp"
+#include "benchmarks.hpp"
+
+/// Number of convolutions averaged by each measurement.
+static constexpr int repetitions = 3;
+
+/**
+ * @brief Measures a convolution and prints its throughput.
+ * @param name The name to print.
+ * @param image The convolved image.
+ * @param convolve The function convolving the image.
+ */
+template <typename Function>
+static void report(const char* name, const Image& image, Function&& convolve) {
+    convolve(); // Warm-up.
+    double seconds = measure([&] {
+        for(int r = 0 ; r < repetitions ; ++r) { convolve(); }
+    }) / repetitions;
+
+    double pixels = static_cast<double>(image.get_height() * image.get_width());
+    std::printf("%-22s %8.2f ms %8.1f MP/s\n", name, seconds * 1e3, pixels / seconds * 1e-6);
+}
+
+void benchmark_convolution() {
+    Image image(2048, 2048, uninitialized);
+    for(std::size_t i = 0 ; i < image.get_height() ; ++i) {
+        for(std::size_t j = 0 ; j < image.get_width() ; ++j) {
+            image(i, j) = vec3(std::sin(i * 0.05f) * 0.5f + 0.5f, static_cast<float>(j) / image.get_width(),
+                               static_cast<float>((i ^ j) & 255) / 255.0f);
+        }
+    }
+    Image destination(image.get_height(), image.get_width(), uninitialized);
+    std::size_t height = image.get_height();
+    std::size_t width = image.get_width();
+
+    // A 5x5 sharpening kernel, which isn't separable.
+    Array2D<float> sharpen(5, 5);
+    sharpen.fill(-1.0f / 24.0f);
+    sharpen(2, 2) = 2.0f;
+
+    // A convolution per pixel through operator(), with clamped coordinates, like filtering code
+    // written on top of Image.
+    report("reference 5x5", image, [&] {
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            for(std::size_t j = 0 ; j < width ; ++j) {
+                vec3 sum(0.0f);
+                for(std::size_t a = 0 ; a < 5 ; ++a) {
+                    for(std::size_t b = 0 ; b < 5 ; ++b) {
+                        std::size_t y = std::clamp<std::ptrdiff_t>(i + 2 - a, 0, height - 1);
+                        std::size_t x = std::clamp<std::ptrdiff_t>(j + 2 - b, 0, width - 1);
+                        sum += sharpen(a, b) * image(y, x);
+                    }
+                }
+                destination(i, j) = sum;
+            }
+        }
+        keep(destination(height / 2, width / 2));
+    });
+
+    report("convolve 5x5", image, [&] {
+        convolve(image, destination, sharpen);
+        keep(destination(height / 2, width / 2));
+    });
+
+    // A 17x17 Gaussian, detected as separable.
+    std::vector<float> taps = gaussian_kernel(2.5f);
+    Array2D<float> gaussian(taps.size(), taps.size());
+    for(std::size_t a = 0 ; a < taps.size() ; ++a) {
+        for(std::size_t b = 0 ; b < taps.size() ; ++b) { gaussian(a, b) = taps[a] * taps[b]; }
+    }
+    report("convolve 17x17 gaussian", image, [&] {
+        convolve(image, destination, gaussian);
+        keep(destination(height / 2, width / 2));
+    });
+
+    // A 31x31 disk, a bokeh-like blur which isn't separable and is convolved through FFTs.
+    Array2D<float> disk(31, 31);
+    float disk_sum = 0.0f;
+    for(std::size_t a = 0 ; a < 31 ; ++a) {
+        for(std::size_t b = 0 ; b < 31 ; ++b) {
+            float y = static_cast<float>(a) - 15.0f;
+            float x = static_cast<float>(b) - 15.0f;
+            disk(a, b) = x * x + y * y <= 15.5f * 15.5f ? 1.0f : 0.0f;
+            disk_sum += disk(a, b);
+        }
+    }
+    for(std::size_t a = 0 ; a < 31 ; ++a) {
+        for(std::size_t b = 0 ; b < 31 ; ++b) { disk(a, b) /= disk_sum; }
+    }
+    report("convolve 31x31 disk", image, [&] {
+        convolve(image, destination, disk);
+        keep(destination(height / 2, width / 2));
+    });
+
+    for(float sigma : { 2.0f, 8.0f, 32.0f }) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "gaussian_blur %g", sigma);
+        report(name, image, [&] {
+            gaussian_blur(image, destination, sigma);
+            keep(destination(height / 2, width / 2));
+        });
+    }
+}
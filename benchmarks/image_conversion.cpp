@@ -0,0 +1,101 @@
+/***************************************************************************************************
+ * @file  image_conversion.cpp
+ * @brief Measures the 8-bit <-> float conversions of Image::read and Image::write
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+#include <vector>
+
+#include "Array.hpp"
+#include "Image.hpp"
+#include "pixel_conversion.hpp"
+#include "simd.hpp"
+#include "benchmarks.hpp"
+
+/// Dimensions of the converted image.
+static constexpr std::size_t height = 4096;
+static constexpr std::size_t width = 4096;
+
+/// Number of conversions averaged by each measurement.
+static constexpr int repetitions = 5;
+
+/**
+ * @brief Measures a conversion of the whole image and prints its throughput.
+ * @param name The name to print.
+ * @param direction The direction of the conversion.
+ * @param convert The function converting the image.
+ */
+template <typename Function>
+static void report(const char* name, const char* direction, Function&& convert) {
+    convert(); // Warm-up.
+    double seconds = measure([&] {
+        for(int r = 0 ; r < repetitions ; ++r) { convert(); }
+    }) / repetitions;
+
+    std::printf("%-10s %-7s %8.2f ms %8.1f MP/s\n", name, direction, seconds * 1e3, height * width / seconds * 1e-6);
+}
+
+void benchmark_image_conversion() {
+    Array<uint8_t> bytes(height * width * 3, uninitialized);
+    for(std::size_t i = 0 ; i < bytes.get_size() ; ++i) { bytes[i] = static_cast<uint8_t>(i * 7); }
+    Image image(height, width, uninitialized);
+
+    // The per-channel loops Image::read and Image::write used before being vectorized.
+    report("reference", "decode", [&] {
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            for(std::size_t j = 0 ; j < width ; ++j) {
+                std::size_t index = (i * width + j) * 3;
+                image(i, j) = vec3(bytes[index] / 255.0f, bytes[index + 1] / 255.0f, bytes[index + 2] / 255.0f);
+            }
+        }
+        keep(image(height / 2, width / 2));
+    });
+    report("reference", "encode", [&] {
+        std::vector<uint8_t> normalized_data;
+        normalized_data.reserve(height * width * 3);
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            for(std::size_t j = 0 ; j < width ; ++j) {
+                const auto& [r, g, b] = image(i, j);
+                normalized_data.push_back(std::clamp(255.0f * r, 0.0f, 255.0f));
+                normalized_data.push_back(std::clamp(255.0f * g, 0.0f, 255.0f));
+                normalized_data.push_back(std::clamp(255.0f * b, 0.0f, 255.0f));
+            }
+        }
+        keep(normalized_data[height * width]);
+    });
+
+    SimdLevel detected = detect_simd_level();
+    for(SimdLevel level : { SimdLevel::Scalar, SimdLevel::SSE2, SimdLevel::AVX2, SimdLevel::AVX512 }) {
+        if(level > detected) { break; }
+        set_simd_level(level);
+
+        report(to_string(level), "decode", [&] {
+            for(std::size_t i = 0 ; i < height ; ++i) {
+                unorm8_to_float_n(bytes.get_data() + i * width * 3, &image(i, 0).x, width * 3);
+            }
+            keep(image(height / 2, width / 2));
+        });
+        report(to_string(level), "encode", [&] {
+            for(std::size_t i = 0 ; i < height ; ++i) {
+                float_to_unorm8_n(&image(i, 0).x, bytes.get_data() + i * width * 3, width * 3);
+            }
+            keep(bytes[height * width]);
+        });
+    }
+
+    set_simd_level(detected);
+
+    report("sRGB", "decode", [&] {
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            srgb8_to_linear_n(bytes.get_data() + i * width * 3, &image(i, 0).x, width * 3);
+        }
+        keep(image(height / 2, width / 2));
+    });
+    report("sRGB", "encode", [&] {
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            linear_to_srgb8_n(&image(i, 0).x, bytes.get_data() + i * width * 3, width * 3);
+        }
+        keep(bytes[height * width]);
+    });
+}
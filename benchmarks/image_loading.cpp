@@ -0,0 +1,56 @@
+/***************************************************************************************************
+ * @file  image_loading.cpp
+ * @brief Measures how loading many image files with load_images scales with the number of threads
+ **************************************************************************************************/
+
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "Image.hpp"
+#include "image_loading.hpp"
+#include "PixelImage.hpp"
+#include "ThreadPool.hpp"
+#include "benchmarks.hpp"
+
+void benchmark_image_loading() {
+    constexpr std::size_t file_count = 64;
+    constexpr std::size_t height = 512;
+    constexpr std::size_t width = 512;
+
+    std::filesystem::path directory = std::filesystem::temp_directory_path() / "cpp-utils-image-loading";
+    std::filesystem::create_directories(directory);
+
+    Image image(height, width);
+    for(std::size_t i = 0 ; i < height ; ++i) {
+        for(std::size_t j = 0 ; j < width ; ++j) {
+            image(i, j) = vec3(static_cast<float>(i) / height, static_cast<float>(j) / width, static_cast<float>((i * j) % 7) / 7.0f);
+        }
+    }
+
+    std::vector<std::filesystem::path> paths;
+    for(std::size_t i = 0 ; i < file_count ; ++i) {
+        paths.push_back(directory / ("image_" + std::to_string(i) + ".png"));
+        image.write(paths.back());
+    }
+
+    double sequential_seconds = measure([&] {
+        for(const std::filesystem::path& path : paths) { keep(PixelImage<RGB8>(path)(0, 0).r); }
+    });
+    std::printf("%-11s %8.2f ms %8.1f images/s\n", "sequential", sequential_seconds * 1e3, file_count / sequential_seconds);
+
+    for(std::size_t threads : thread_counts()) {
+        ThreadPool pool(threads);
+        ImageLoadOptions options;
+        options.thread_pool = &pool;
+
+        double seconds = measure([&] {
+            load_images<PixelImage<RGB8>>(paths, options, [](std::size_t, PixelImage<RGB8>&& loaded) { keep(loaded(0, 0).r); });
+        });
+        std::printf("%3zu threads %8.2f ms %8.1f images/s %6.2fx speedup\n",
+                    threads, seconds * 1e3, file_count / seconds, sequential_seconds / seconds);
+    }
+
+    std::filesystem::remove_all(directory);
+}
@@ -0,0 +1,74 @@
+/***************************************************************************************************
+ * @file  main.cpp
+ * @brief Runs the benchmarks given on the command line, or all of them
+ **************************************************************************************************/
+
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string_view>
+
+#include "benchmarks.hpp"
+
+std::atomic<std::size_t> allocation_count = 0;
+
+void* operator new(std::size_t size) {
+    ++allocation_count;
+    if(void* pointer = std::malloc(size == 0 ? 1 : size)) { return pointer; }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    ++allocation_count;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    if(void* pointer = std::aligned_alloc(align, (size + align - 1) / align * align)) { return pointer; }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* pointer) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::align_val_t) noexcept { std::free(pointer); }
+
+void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { std::free(pointer); }
+
+/**
+ * @struct Benchmark
+ * @brief A benchmark that can be selected by name on the command line.
+ */
+struct Benchmark {
+    std::string_view name; ///< The name of the benchmark.
+    void (*run)();         ///< The function running the benchmark.
+};
+
+/// All the available benchmarks.
+static constexpr Benchmark benchmarks[] = {
+    { "convolution", benchmark_convolution },
+    { "image_conversion", benchmark_image_conversion },
+    { "image_loading", benchmark_image_loading },
+    { "png_encode", benchmark_png_encode },
+    { "resample", benchmark_resample },
+    { "small_array", benchmark_small_array },
+    { "thread_pool", benchmark_thread_pool },
+};
+
+int main(int argc, char** argv) {
+    try {
+        for(const Benchmark& benchmark : benchmarks) {
+            bool selected = argc == 1;
+            for(int i = 1 ; i < argc ; ++i) { selected |= benchmark.name == argv[i]; }
+            if(!selected) { continue; }
+
+            std::cout << "=== " << benchmark.name << " ===\n";
+            benchmark.run();
+            std::cout << '\n';
+        }
+    } catch(const std::exception& exception) {
+        std::cerr << "ERROR : " << exception.what() << '\n';
+        return -1;
+    }
+
+    return 0;
+}
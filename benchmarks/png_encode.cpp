@@ -0,0 +1,71 @@
+/***************************************************************************************************
+ * @file  png_encode.cpp
+ * @brief Compares the multithreaded PNG encoder with stb_image_write's
+ **************************************************************************************************/
+
+#include <cstdio>
+#include <vector>
+
+#include "Array.hpp"
+#include "png.hpp"
+#include "Random.hpp"
+#include "stb_image_write.h"
+#include "ThreadPool.hpp"
+#include "benchmarks.hpp"
+
+/// Dimensions of the encoded image.
+static constexpr std::size_t height = 1024;
+static constexpr std::size_t width = 1024;
+
+/// Number of encodings averaged by each measurement.
+static constexpr int repetitions = 3;
+
+/**
+ * @brief Measures an encoding of the image and prints its throughput and the size of the result.
+ * @param name The name to print.
+ * @param encode The function encoding the image and returning the encoded size.
+ */
+template <typename Function>
+static void report(const char* name, Function&& encode) {
+    std::size_t size = encode(); // Warm-up.
+    double seconds = measure([&] {
+        for(int r = 0 ; r < repetitions ; ++r) { keep(encode()); }
+    }) / repetitions;
+
+    std::printf("%-16s %8.2f ms %8.1f MB/s %10zu bytes\n",
+                name, seconds * 1e3, height * width * 3 / seconds * 1e-6, size);
+}
+
+void benchmark_png_encode() {
+    // Smooth gradients with a little noise, which compress like a photograph rather than like a
+    // flat color or random bytes.
+    Array<uint8_t> pixels(height * width * 3, uninitialized);
+    for(std::size_t i = 0 ; i < height ; ++i) {
+        for(std::size_t j = 0 ; j < width ; ++j) {
+            uint8_t* pixel = pixels.get_data() + (i * width + j) * 3;
+            pixel[0] = static_cast<uint8_t>(i / 8 + Random::integer(0, 3));
+            pixel[1] = static_cast<uint8_t>(j / 8 + Random::integer(0, 3));
+            pixel[2] = static_cast<uint8_t>((i + j) / 16);
+        }
+    }
+
+    report("stb", [&] {
+        std::vector<unsigned char> encoded;
+        stbi_write_png_to_func([](void* context, void* data, int size) {
+            auto* buffer = static_cast<std::vector<unsigned char>*>(context);
+            buffer->insert(buffer->end(), static_cast<unsigned char*>(data), static_cast<unsigned char*>(data) + size);
+        }, &encoded, static_cast<int>(width), static_cast<int>(height), 3, pixels.get_data(), static_cast<int>(width * 3));
+        return encoded.size();
+    });
+
+    for(int level : { 1, 4, 6 }) {
+        for(std::size_t threads : { 1, 2, 4, 8, 16 }) {
+            ThreadPool pool(threads);
+            char name[32];
+            std::snprintf(name, sizeof(name), "level %d, %2zu thr", level, threads);
+            report(name, [&] {
+                return png_encode(pixels.get_data(), width * 3, width, height, 3, level, pool).size();
+            });
+        }
+    }
+}
@@ -0,0 +1,96 @@
+/***************************************************************************************************
+ * @file  resample.cpp
+ * @brief Measures the throughput of Image::resampled for every filter
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+#include "Image.hpp"
+#include "resample.hpp"
+#include "benchmarks.hpp"
+
+/// Number of resamplings averaged by each measurement.
+static constexpr int repetitions = 5;
+
+/**
+ * @brief Measures a resampling and prints its throughput, in source and destination megapixels.
+ * @param name The name to print.
+ * @param source The resampled image.
+ * @param destination The resampled image's dimensions.
+ * @param resample The function resampling the image.
+ */
+template <typename Function>
+static void report(const char* name, const Image& source, const Image& destination, Function&& resample) {
+    resample(); // Warm-up.
+    double seconds = measure([&] {
+        for(int r = 0 ; r < repetitions ; ++r) { resample(); }
+    }) / repetitions;
+
+    double source_pixels = static_cast<double>(source.get_height() * source.get_width());
+    double destination_pixels = static_cast<double>(destination.get_height() * destination.get_width());
+    std::printf("%-10s %8.2f ms %8.1f MP/s in %8.1f MP/s out\n",
+                name, seconds * 1e3, source_pixels / seconds * 1e-6, destination_pixels / seconds * 1e-6);
+}
+
+/**
+ * @brief Measures every filter resampling an image to some dimensions.
+ * @param source The resampled image.
+ * @param height The number of rows of the resampled image.
+ * @param width The number of columns of the resampled image.
+ */
+static void benchmark_filters(const Image& source, std::size_t height, std::size_t width) {
+    std::printf("%zux%zu -> %zux%zu\n", source.get_width(), source.get_height(), width, height);
+    Image destination(height, width, uninitialized);
+
+    // A bilinear interpolation per pixel through operator(), like resizing code written on top of Image.
+    // It reads 4 source pixels whatever the scale, so it aliases when shrinking.
+    report("reference", source, destination, [&] {
+        float scale_y = static_cast<float>(source.get_height()) / height;
+        float scale_x = static_cast<float>(source.get_width()) / width;
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            for(std::size_t j = 0 ; j < width ; ++j) {
+                float y = std::clamp((i + 0.5f) * scale_y - 0.5f, 0.0f, source.get_height() - 1.0f);
+                float x = std::clamp((j + 0.5f) * scale_x - 0.5f, 0.0f, source.get_width() - 1.0f);
+                std::size_t y0 = static_cast<std::size_t>(y);
+                std::size_t x0 = static_cast<std::size_t>(x);
+                std::size_t y1 = std::min(y0 + 1, source.get_height() - 1);
+                std::size_t x1 = std::min(x0 + 1, source.get_width() - 1);
+                float fy = y - y0;
+                float fx = x - x0;
+                destination(i, j) = (1.0f - fy) * ((1.0f - fx) * source(y0, x0) + fx * source(y0, x1))
+                                    + fy * ((1.0f - fx) * source(y1, x0) + fx * source(y1, x1));
+            }
+        }
+        keep(destination(height / 2, width / 2));
+    });
+
+    static constexpr std::pair<const char*, ResampleFilter> filters[] = {
+        { "nearest", ResampleFilter::Nearest },
+        { "bilinear", ResampleFilter::Bilinear },
+        { "bicubic", ResampleFilter::Bicubic },
+        { "mitchell", ResampleFilter::Mitchell },
+        { "lanczos3", ResampleFilter::Lanczos3 },
+    };
+    for(const auto& [name, filter] : filters) {
+        report(name, source, destination, [&] {
+            resample(source, destination, filter);
+            keep(destination(height / 2, width / 2));
+        });
+    }
+}
+
+void benchmark_resample() {
+    Image image(2048, 2048, uninitialized);
+    for(std::size_t i = 0 ; i < image.get_height() ; ++i) {
+        for(std::size_t j = 0 ; j < image.get_width() ; ++j) {
+            image(i, j) = vec3(std::sin(i * 0.05f) * 0.5f + 0.5f, static_cast<float>(j) / image.get_width(),
+                               static_cast<float>((i ^ j) & 255) / 255.0f);
+        }
+    }
+
+    benchmark_filters(image, 512, 512);
+    std::printf("\n");
+    benchmark_filters(image.resampled(512, 512), 2048, 2048);
+}
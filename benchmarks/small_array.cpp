@@ -0,0 +1,57 @@
+/***************************************************************************************************
+ * @file  small_array.cpp
+ * @brief Compares SmallArray and Array on many short-lived tiny arrays
+ **************************************************************************************************/
+
+#include <cstdio>
+
+#include "Array.hpp"
+#include "SmallArray.hpp"
+#include "benchmarks.hpp"
+
+/**
+ * @brief Creates 'count' arrays of 2 to 16 elements, fills them and sums them.
+ * @tparam ArrayType The type of array to benchmark.
+ * @param count The number of arrays to create.
+ * @return The sum of all the elements, so that the work can't be optimized away.
+ */
+template <typename ArrayType>
+static long long run(std::size_t count) {
+    long long total = 0;
+
+    for(std::size_t i = 0 ; i < count ; ++i) {
+        std::size_t size = 2 + i % 15;
+
+        ArrayType array(size);
+        for(std::size_t j = 0 ; j < size ; ++j) { array[j] = static_cast<int>(i + j); }
+        for(int value : array) { total += value; }
+    }
+
+    return total;
+}
+
+/**
+ * @brief Measures the time and number of allocations of 'run' for an array type.
+ * @tparam ArrayType The type of array to benchmark.
+ * @param name The name to print.
+ * @param count The number of arrays to create.
+ */
+template <typename ArrayType>
+static void report(const char* name, std::size_t count) {
+    std::size_t allocations = allocation_count;
+    long long total = 0;
+    double seconds = measure([&] { total = run<ArrayType>(count); });
+    keep(total);
+    allocations = allocation_count - allocations;
+
+    std::printf("%-20s %8.2f ms %12zu allocations %8.2f ns/array\n",
+                name, seconds * 1e3, allocations, seconds * 1e9 / count);
+}
+
+void benchmark_small_array() {
+    constexpr std::size_t count = 5'000'000;
+
+    report<Array<int>>("Array<int>", count);
+    report<SmallArray<int, 16>>("SmallArray<int, 16>", count);
+    report<SmallArray<int, 8>>("SmallArray<int, 8>", count);
+}
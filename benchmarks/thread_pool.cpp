@@ -0,0 +1,73 @@
+/***************************************************************************************************
+ * @file  thread_pool.cpp
+ * @brief Measures how an Image filter scales with the number of threads of a ThreadPool
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <cstdio>
+
+#include "Image.hpp"
+#include "ThreadPool.hpp"
+#include "parallel.hpp"
+#include "benchmarks.hpp"
+
+/**
+ * @brief Applies a 3x3 box blur to an image, tile by tile, on a thread pool.
+ * @param source The image to blur.
+ * @param destination The blurred image, with the same size as 'source'.
+ * @param pool The pool to run on.
+ */
+static void box_blur(const Image& source, Image& destination, ThreadPool& pool) {
+    std::size_t height = source.get_height();
+    std::size_t width = source.get_width();
+
+    parallel_for_2d(destination, [&](Array2DView<vec3> tile, std::size_t row, std::size_t column) {
+        for(std::size_t i = 0 ; i < tile.get_height() ; ++i) {
+            std::size_t y = row + i;
+            std::size_t top = y > 0 ? y - 1 : 0;
+            std::size_t bottom = std::min(y + 1, height - 1);
+
+            for(std::size_t j = 0 ; j < tile.get_width() ; ++j) {
+                std::size_t x = column + j;
+                std::size_t left = x > 0 ? x - 1 : 0;
+                std::size_t right = std::min(x + 1, width - 1);
+
+                vec3 sum(0.0f);
+                for(std::size_t k : { top, y, bottom }) {
+                    sum += source(k, left) + source(k, x) + source(k, right);
+                }
+                tile(i, j) = sum / 9.0f;
+            }
+        }
+    }, pool);
+}
+
+void benchmark_thread_pool() {
+    constexpr std::size_t height = 2048;
+    constexpr std::size_t width = 2048;
+    constexpr int repetitions = 5;
+
+    Image source(height, width);
+    Image destination(height, width);
+    for(std::size_t i = 0 ; i < height ; ++i) {
+        for(std::size_t j = 0 ; j < width ; ++j) {
+            source(i, j) = vec3(static_cast<float>(i % 256), static_cast<float>(j % 256), 0.5f) / 255.0f;
+        }
+    }
+
+    double single_thread_seconds = 0.0;
+
+    for(std::size_t threads : thread_counts()) {
+        ThreadPool pool(threads);
+        box_blur(source, destination, pool); // Warm-up.
+
+        double seconds = measure([&] {
+            for(int r = 0 ; r < repetitions ; ++r) { box_blur(source, destination, pool); }
+        }) / repetitions;
+        keep(destination(height / 2, width / 2));
+
+        if(threads == 1) { single_thread_seconds = seconds; }
+        std::printf("%3zu threads %8.2f ms %8.1f MP/s %6.2fx speedup\n",
+                    threads, seconds * 1e3, height * width / seconds * 1e-6, single_thread_seconds / seconds);
+    }
+}
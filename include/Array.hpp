@@ -5,47 +5,179 @@
 
 #pragma once
 
+#include <algorithm>
+#include <complex>
+#include <cstring>
 #include <initializer_list>
 #include <iostream>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+template <typename Type> struct Vector2;
+template <typename Type> struct Vector3;
+template <typename Type> struct Vector4;
+
+/// Size in bytes of a cache line, which is also the width of the widest SIMD registers (AVX-512).
+inline constexpr std::size_t cache_line_size = 64;
+
+/**
+ * @struct ArrayAlignment
+ * @brief Alignment policy of the storage of arrays of 'Type'. Defaults to the natural alignment of
+ * the type. Specialize it to align arrays of a custom type differently.
+ * @tparam Type The type of the array's data.
+ */
+template <typename Type>
+struct ArrayAlignment {
+    static constexpr std::size_t value = alignof(Type); ///< The alignment in bytes.
+};
+
+/**
+ * @brief Arrays of arithmetic types start on a cache line so that they can be loaded with aligned
+ * SIMD instructions.
+ */
+template <typename Type> requires std::is_arithmetic_v<Type>
+struct ArrayAlignment<Type> {
+    static constexpr std::size_t value = cache_line_size; ///< The alignment in bytes.
+};
+
+/**
+ * @brief Arrays of vector2 are streams of components, aligned like arrays of their component type.
+ */
+template <typename Type>
+struct ArrayAlignment<Vector2<Type>> : ArrayAlignment<Type> { };
+
+/**
+ * @brief Arrays of vector3 are streams of components, aligned like arrays of their component type.
+ */
+template <typename Type>
+struct ArrayAlignment<Vector3<Type>> : ArrayAlignment<Type> { };
+
+/**
+ * @brief Arrays of vector4 are streams of components, aligned like arrays of their component type.
+ */
+template <typename Type>
+struct ArrayAlignment<Vector4<Type>> : ArrayAlignment<Type> { };
+
+/**
+ * @brief Arrays of complex numbers are streams of components, aligned like arrays of their component
+ * type.
+ */
+template <typename Type>
+struct ArrayAlignment<std::complex<Type>> : ArrayAlignment<Type> { };
+
+/**
+ * @struct UninitializedTag
+ * @brief Tag type selecting the constructors that allocate storage without initializing it.
+ */
+struct UninitializedTag {
+    explicit UninitializedTag() = default;
+};
+
+/// Tag value to pass to the constructors that leave elements uninitialized.
+inline constexpr UninitializedTag uninitialized {};
+
+/**
+ * @brief Whether a type can be left uninitialized in an Array: its objects come into existence with
+ * their storage and never need to be destroyed.
+ * @tparam Type The type of the array's data.
+ */
+template <typename Type>
+concept UninitializableType = std::is_trivially_copyable_v<Type> && std::is_trivially_destructible_v<Type>;
 
 /**
  * @class Array
  * @brief A minimal dynamic array class that manually manages heap memory for a sequence of 'Type'.
+ *
+ * The array keeps track of a capacity separate from its size and grows geometrically, so appending
+ * elements one by one is amortized O(1). Storage is allocated raw and elements are constructed in
+ * place, so each element is only initialized once. The storage is aligned according to the
+ * ArrayAlignment policy, i.e. on a cache line for arithmetic and vector types.
+ *
+ * All the memory is obtained from a std::pmr::memory_resource, the default resource unless one is
+ * given on construction, so arrays can be placed in arenas or pools. The resource sticks to the
+ * array: assignments copy or move elements but never change it, except for swap().
+ *
  * @tparam Type The type of the array's data.
  */
 template <typename Type>
 class Array {
 public:
+    /// Alignment in bytes of the first element of the array.
+    static constexpr std::size_t alignment = std::max(ArrayAlignment<Type>::value, alignof(Type));
+
+    static_assert((alignment & (alignment - 1)) == 0, "Array alignment must be a power of 2.");
+
     /**
      * @brief Default constructor. Does not allocate any data.
      */
     Array();
 
+    /**
+     * @brief Constructs an empty array that will allocate its data from a specific resource.
+     * @param resource The memory resource to allocate from.
+     */
+    explicit Array(std::pmr::memory_resource* resource);
+
     /**
      * @brief Constructs an array with a given size. Elements are default-initialized (Type()).
      * @param size The number of elements.
+     * @param resource The memory resource to allocate from.
      */
-    explicit Array(std::size_t size);
+    explicit Array(std::size_t size,
+                   std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
     * @brief Constructs an array with a given size. Elements are initialized with a specified value.
      * @param size The number of elements.
      * @param default_value The value to fill the array with.
+     * @param resource The memory resource to allocate from.
      */
-    Array(std::size_t size, const Type& default_value);
+    Array(std::size_t size, const Type& default_value,
+          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Constructs an array with a given size without initializing its elements. Useful for
+     * buffers that are about to be entirely overwritten.
+     * @param size The number of elements.
+     * @param resource The memory resource to allocate from.
+     * @note Reading an element before writing to it gives an indeterminate value.
+     */
+    Array(std::size_t size, UninitializedTag,
+          std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        requires UninitializableType<Type>;
 
     /**
      * @brief Constructs an array from an initializer_list.
      * @param values The values to fill the array with.
+     * @param resource The memory resource to allocate from.
      */
-    Array(const std::initializer_list<Type>& values);
+    Array(const std::initializer_list<Type>& values,
+          std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
-     * @brief Copy constructor. Performs a deep copy.
+     * @brief Copy constructor. Performs a deep copy into memory from the default resource.
      * @param other The array to copy.
      */
     Array(const Array& other);
 
+    /**
+     * @brief Performs a deep copy into memory from a specific resource.
+     * @param other The array to copy.
+     * @param resource The memory resource to allocate from.
+     */
+    Array(const Array& other, std::pmr::memory_resource* resource);
+
+    /**
+     * @brief Move constructor. Steals the other array's data and resource, leaving it empty.
+     * @param other The array to move from.
+     */
+    Array(Array&& other) noexcept;
+
     /**
      * @brief Destructor. Releases allocated memory.
      */
@@ -58,6 +190,14 @@ public:
      */
     Array& operator=(const Array& other);
 
+    /**
+     * @brief Move assignment operator. Steals the other array's data, leaving it empty, if both
+     * arrays use equal resources. Otherwise moves the elements one by one.
+     * @param other The array to move from.
+     * @return A reference to the array.
+     */
+    Array& operator=(Array&& other);
+
     /**
      * @brief Access element at 'index'.
      * @param index The index of the wanted element.
@@ -79,6 +219,16 @@ public:
      */
     std::size_t get_size() const;
 
+    /**
+     * @return Number of elements the array can hold before having to reallocate.
+     */
+    std::size_t get_capacity() const;
+
+    /**
+     * @return The memory resource the array allocates from.
+     */
+    std::pmr::memory_resource* get_resource() const;
+
     /**
      * @return A pointer to the first element in the internal array.
      * @note Will return nullptr if the array is empty.
@@ -137,11 +287,90 @@ public:
      */
     void assign(std::size_t new_size, const Type& value);
 
+    /**
+     * @brief Makes sure the array can hold at least 'new_capacity' elements without reallocating.
+     * Does nothing if the capacity is already large enough.
+     * @param new_capacity The minimum wanted capacity.
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     * @brief Appends a copy of a value at the end of the array.
+     * @param value The value to append.
+     */
+    void push_back(const Type& value);
+
+    /**
+     * @brief Appends a value at the end of the array by moving it.
+     * @param value The value to append.
+     */
+    void push_back(Type&& value);
+
+    /**
+     * @brief Appends a value constructed from 'args' at the end of the array.
+     * @param args The arguments to construct the value with.
+     * @return A reference to the appended element.
+     */
+    template <typename... Args>
+    Type& emplace_back(Args&&... args);
+
+    /**
+     * @brief Swaps the contents, and the memory resources, of two arrays without copying any
+     * element.
+     * @param other The array to swap with.
+     */
+    void swap(Array& other) noexcept;
+
 protected:
-    std::size_t size; ///< Number of elements in the array.
-    Type* data;       ///< Pointer to heap-allocated data.
+    /**
+     * @brief Allocates uninitialized storage for 'count' elements from the array's resource.
+     * @param count The number of elements.
+     * @return A pointer to the storage, or nullptr if 'count' is 0.
+     * @note Throws a std::length_error if the storage would be larger than a std::size_t can count.
+     */
+    Type* allocate(std::size_t count);
+
+    /**
+     * @brief Releases storage obtained with allocate(). Does not destroy any element.
+     * @param pointer The storage to release.
+     * @param count The number of elements the storage was allocated for.
+     */
+    void deallocate(Type* pointer, std::size_t count);
+
+    /**
+     * @brief Destroys the elements in [new_size ; size) and sets the size to 'new_size'.
+     * @param new_size The new size of the array. Must be at most 'size'.
+     */
+    void destroy_from(std::size_t new_size);
+
+    /**
+     * @brief Moves the elements to a new buffer able to hold 'new_capacity' elements.
+     * @param new_capacity The capacity of the new buffer. Must be at least 'size'.
+     */
+    void reallocate(std::size_t new_capacity);
+
+    /**
+     * @brief Reallocates geometrically so that at least 'min_capacity' elements fit.
+     * @param min_capacity The minimum wanted capacity.
+     */
+    void grow(std::size_t min_capacity);
+
+    std::pmr::memory_resource* resource; ///< Memory resource the data is allocated from.
+    std::size_t size;                    ///< Number of elements in the array.
+    std::size_t capacity;                ///< Number of elements the allocated data can hold.
+    Type* data;                          ///< Pointer to heap-allocated data.
 };
 
+/**
+ * @brief Swaps the contents of two arrays without copying any element.
+ * @param left The first array.
+ * @param right The second array.
+ */
+template <typename Type>
+void swap(Array<Type>& left, Array<Type>& right) noexcept {
+    left.swap(right);
+}
+
 /**
  * @brief Outputs an array to an output stream.
  * @param stream The stream to output to.
@@ -161,48 +390,121 @@ std::ostream& operator <<(std::ostream& stream, const Array<Type>& array) {
 }
 
 template <typename Type>
-Array<Type>::Array() : size(0), data(nullptr) { }
+Array<Type>::Array() : Array(std::pmr::get_default_resource()) { }
+
+template <typename Type>
+Array<Type>::Array(std::pmr::memory_resource* resource)
+    : resource(resource), size(0), capacity(0), data(nullptr) { }
 
 template <typename Type>
-Array<Type>::Array(std::size_t size)
-    : size(size), data(new Type[size]) {
-    Type default_value = Type();
-    for(unsigned int i = 0 ; i < size ; ++i) { data[i] = default_value; }
+Array<Type>::Array(std::size_t size, std::pmr::memory_resource* resource)
+    : resource(resource), size(size), capacity(size), data(allocate(size)) {
+    try {
+        std::uninitialized_value_construct_n(data, size);
+    } catch(...) {
+        deallocate(data, capacity);
+        throw;
+    }
+}
+
+template <typename Type>
+Array<Type>::Array(std::size_t size, const Type& default_value, std::pmr::memory_resource* resource)
+    : resource(resource), size(size), capacity(size), data(allocate(size)) {
+    try {
+        std::uninitialized_fill_n(data, size, default_value);
+    } catch(...) {
+        deallocate(data, capacity);
+        throw;
+    }
 }
 
 template <typename Type>
-Array<Type>::Array(std::size_t size, const Type& default_value)
-    : size(size), data(new Type[size]) {
-    for(unsigned int i = 0 ; i < size ; ++i) { data[i] = default_value; }
+Array<Type>::Array(std::size_t size, UninitializedTag, std::pmr::memory_resource* resource)
+    requires UninitializableType<Type>
+    : resource(resource), size(size), capacity(size), data(allocate(size)) { }
+
+template <typename Type>
+Array<Type>::Array(const std::initializer_list<Type>& values, std::pmr::memory_resource* resource)
+    : resource(resource), size(values.size()), capacity(size), data(allocate(size)) {
+    try {
+        std::uninitialized_copy(values.begin(), values.end(), data);
+    } catch(...) {
+        deallocate(data, capacity);
+        throw;
+    }
 }
 
 template <typename Type>
-Array<Type>::Array(const std::initializer_list<Type>& values)
-    : size(values.size()), data(new Type[size]) {
-    unsigned int i = 0;
-    for(const Type& value : values) { data[i++] = value; }
+Array<Type>::Array(const Array& other) : Array(other, std::pmr::get_default_resource()) { }
+
+template <typename Type>
+Array<Type>::Array(const Array& other, std::pmr::memory_resource* resource)
+    : resource(resource), size(other.size), capacity(size), data(allocate(size)) {
+    try {
+        std::uninitialized_copy_n(other.data, size, data);
+    } catch(...) {
+        deallocate(data, capacity);
+        throw;
+    }
 }
 
 template <typename Type>
-Array<Type>::Array(const Array& other)
-    : size(other.size), data(new Type[size]) {
-    for(unsigned int i = 0 ; i < size ; ++i) { data[i] = other[i]; }
+Array<Type>::Array(Array&& other) noexcept
+    : resource(other.resource), size(other.size), capacity(other.capacity), data(other.data) {
+    other.size = 0;
+    other.capacity = 0;
+    other.data = nullptr;
 }
 
 template <typename Type>
 Array<Type>::~Array() {
-    delete[] data;
+    std::destroy_n(data, size);
+    deallocate(data, capacity);
 }
 
 template <typename Type>
 Array<Type>& Array<Type>::operator=(const Array& other) {
     if(this == &other) { return *this; }
 
-    delete[] data;
+    if(other.size > capacity) {
+        Array copy(other, resource);
+        swap(copy);
+    } else if(other.size > size) {
+        std::copy_n(other.data, size, data);
+        std::uninitialized_copy_n(other.data + size, other.size - size, data + size);
+        size = other.size;
+    } else {
+        std::copy_n(other.data, other.size, data);
+        destroy_from(other.size);
+    }
+
+    return *this;
+}
+
+template <typename Type>
+Array<Type>& Array<Type>::operator=(Array&& other) {
+    if(this == &other) { return *this; }
+
+    if(*resource != *other.resource) {
+        // The other array's data can't be released through this array's resource.
+        Array moved(resource);
+        moved.reserve(other.size);
+        for(Type& element : other) { moved.emplace_back(std::move(element)); }
+        swap(moved);
+        other.destroy_from(0);
+        return *this;
+    }
+
+    std::destroy_n(data, size);
+    deallocate(data, capacity);
 
     size = other.size;
-    data = new Type[size];
-    for(unsigned int i = 0 ; i < size ; ++i) { data[i] = other[i]; }
+    capacity = other.capacity;
+    data = other.data;
+
+    other.size = 0;
+    other.capacity = 0;
+    other.data = nullptr;
 
     return *this;
 }
@@ -216,6 +518,12 @@ const Type& Array<Type>::operator[](std::size_t index) const { return data[index
 template <typename Type>
 std::size_t Array<Type>::get_size() const { return size; }
 
+template <typename Type>
+std::size_t Array<Type>::get_capacity() const { return capacity; }
+
+template <typename Type>
+std::pmr::memory_resource* Array<Type>::get_resource() const { return resource; }
+
 template <typename Type>
 Type* Array<Type>::get_data() { return data; }
 
@@ -239,34 +547,120 @@ const Type* Array<Type>::end() const { return data + size; }
 
 template <typename Type>
 void Array<Type>::resize(std::size_t new_size) {
-    if(new_size == size) { return; }
-
-    if(new_size > 0) {
-        Type* temp = data;
-        data = new Type[new_size];
-        Type default_value = Type();
-        for(unsigned int i = 0 ; i < new_size ; ++i) { data[i] = i < size ? temp[i] : default_value; }
-        size = new_size;
-        delete[] temp;
-    } else {
-        delete[] data;
-        size = 0;
-        data = nullptr;
+    if(new_size <= size) {
+        destroy_from(new_size);
+        return;
     }
+
+    if(new_size > capacity) { grow(new_size); }
+    std::uninitialized_value_construct_n(data + size, new_size - size);
+    size = new_size;
 }
 
 template <typename Type>
 void Array<Type>::fill(const Type& value) {
-    for(std::size_t i = 0 ; i < size ; ++i) { data[i] = value; }
+    std::fill_n(data, size, value);
 }
 
 template <typename Type>
 void Array<Type>::assign(std::size_t new_size, const Type& value) {
-    if(new_size != size) {
-        delete[] data;
+    if(new_size > capacity) {
+        // The old content is discarded, so there is nothing to relocate.
+        Array filled(new_size, value, resource);
+        swap(filled);
+    } else if(new_size > size) {
+        std::fill_n(data, size, value);
+        std::uninitialized_fill_n(data + size, new_size - size, value);
         size = new_size;
-        data = new Type[size];
+    } else {
+        std::fill_n(data, new_size, value);
+        destroy_from(new_size);
+    }
+}
+
+template <typename Type>
+void Array<Type>::reserve(std::size_t new_capacity) {
+    if(new_capacity > capacity) { reallocate(new_capacity); }
+}
+
+template <typename Type>
+void Array<Type>::push_back(const Type& value) {
+    emplace_back(value);
+}
+
+template <typename Type>
+void Array<Type>::push_back(Type&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename Type>
+template <typename... Args>
+Type& Array<Type>::emplace_back(Args&&... args) {
+    if(size == capacity) {
+        // 'args' may refer to elements of this array, so build the value before reallocating.
+        Type value(std::forward<Args>(args)...);
+        grow(size + 1);
+        std::construct_at(data + size, std::move(value));
+    } else {
+        std::construct_at(data + size, std::forward<Args>(args)...);
+    }
+
+    return data[size++];
+}
+
+template <typename Type>
+void Array<Type>::swap(Array& other) noexcept {
+    std::swap(resource, other.resource);
+    std::swap(size, other.size);
+    std::swap(capacity, other.capacity);
+    std::swap(data, other.data);
+}
+
+template <typename Type>
+Type* Array<Type>::allocate(std::size_t count) {
+    if(count == 0) { return nullptr; }
+    if(count > std::numeric_limits<std::size_t>::max() / sizeof(Type)) {
+        throw std::length_error("Couldn't allocate array: too many elements");
     }
+    return static_cast<Type*>(resource->allocate(count * sizeof(Type), alignment));
+}
+
+template <typename Type>
+void Array<Type>::deallocate(Type* pointer, std::size_t count) {
+    if(pointer != nullptr) { resource->deallocate(pointer, count * sizeof(Type), alignment); }
+}
 
-    fill(value);
+template <typename Type>
+void Array<Type>::destroy_from(std::size_t new_size) {
+    std::destroy_n(data + new_size, size - new_size);
+    size = new_size;
+}
+
+template <typename Type>
+void Array<Type>::reallocate(std::size_t new_capacity) {
+    Type* new_data = allocate(new_capacity);
+
+    if constexpr(std::is_trivially_copyable_v<Type>) {
+        if(size > 0) { std::memcpy(new_data, data, size * sizeof(Type)); }
+    } else if constexpr(std::is_nothrow_move_constructible_v<Type>) {
+        std::uninitialized_move_n(data, size, new_data);
+        std::destroy_n(data, size);
+    } else {
+        try {
+            std::uninitialized_copy_n(data, size, new_data);
+        } catch(...) {
+            deallocate(new_data, new_capacity);
+            throw;
+        }
+        std::destroy_n(data, size);
+    }
+
+    deallocate(data, capacity);
+    data = new_data;
+    capacity = new_capacity;
+}
+
+template <typename Type>
+void Array<Type>::grow(std::size_t min_capacity) {
+    reallocate(std::max(min_capacity, 2 * capacity));
 }
@@ -5,30 +5,99 @@
 
 #pragma once
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
+#include <utility>
 #include "Array.hpp"
+#include "ArrayView.hpp"
 
 /**
  * @class Array2D
  * @brief A minimal dynamic array class that manually manages heap memory for a 2D sequence of
  * 'Type'.
+ *
+ * Elements are stored in a single contiguous row-major buffer. Consecutive rows are 'stride'
+ * elements apart, the stride being padded so that every row starts on an Array::alignment boundary.
+ * The buffer is allocated from a std::pmr::memory_resource, like any Array.
+ *
  * @tparam Type The type of the array's data.
  */
 template <typename Type>
 class Array2D {
 public:
+    /// Alignment in bytes of the first element of every row.
+    static constexpr std::size_t alignment = Array<Type>::alignment;
+
+    /**
+     * @class RowIterator
+     * @brief Iterates over the rows of an Array2D, yielding an ArrayView for each row.
+     * @tparam RowType The type of the rows' elements, const-qualified for read-only iteration.
+     */
+    template <typename RowType>
+    class RowIterator {
+    public:
+        /**
+         * @brief Constructs an iterator pointing to the row starting at 'row'.
+         * @param row A pointer to the first element of the row.
+         * @param width The number of columns.
+         * @param stride The distance in elements between two consecutive rows.
+         */
+        RowIterator(RowType* row, std::size_t width, std::size_t stride)
+            : row(row), width(width), stride(stride) { }
+
+        /**
+         * @return A view over the current row.
+         */
+        ArrayView<RowType> operator *() const { return ArrayView<RowType>(row, width); }
+
+        /**
+         * @brief Moves to the next row.
+         * @return A reference to the iterator.
+         */
+        RowIterator& operator ++() {
+            row += stride;
+            return *this;
+        }
+
+        /**
+         * @param other The iterator to compare with.
+         * @return Whether both iterators point to the same row.
+         */
+        bool operator ==(const RowIterator& other) const { return row == other.row; }
+
+        /**
+         * @param other The iterator to compare with.
+         * @return Whether the iterators point to different rows.
+         */
+        bool operator !=(const RowIterator& other) const { return row != other.row; }
+
+    private:
+        RowType* row;       ///< Pointer to the first element of the current row.
+        std::size_t width;  ///< Number of columns.
+        std::size_t stride; ///< Distance in elements between two consecutive rows.
+    };
+
     /**
      * @brief Default constructor. Does not allocate any data.
      */
     Array2D();
 
+    /**
+     * @brief Constructs an empty 2D array that will allocate its data from a specific resource.
+     * @param resource The memory resource to allocate from.
+     */
+    explicit Array2D(std::pmr::memory_resource* resource);
+
     /**
      * Constructs a 2D array with a given amount of rows and columns. Elements are
      * default-initialized (Type()).
      * @param height The number of rows.
      * @param width The number of columns.
+     * @param resource The memory resource to allocate from.
      */
-    Array2D(std::size_t height, std::size_t width);
+    Array2D(std::size_t height, std::size_t width,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
      * Constructs a 2D array with a given amount of rows and columns. Elements are initialized with
@@ -36,8 +105,22 @@ public:
      * @param height The number of rows.
      * @param width The number of columns.
      * @param default_value The value to fill the array with.
+     * @param resource The memory resource to allocate from.
+     */
+    Array2D(std::size_t height, std::size_t width, Type default_value,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * Constructs a 2D array with a given amount of rows and columns without initializing its
+     * elements. Useful for buffers that are about to be entirely overwritten.
+     * @param height The number of rows.
+     * @param width The number of columns.
+     * @param resource The memory resource to allocate from.
+     * @note Reading an element before writing to it gives an indeterminate value.
      */
-    Array2D(std::size_t height, std::size_t width, Type default_value);
+    Array2D(std::size_t height, std::size_t width, UninitializedTag,
+            std::pmr::memory_resource* resource = std::pmr::get_default_resource())
+        requires UninitializableType<Type>;
 
     /**
      * @brief Access a specific element by its row and column.
@@ -61,17 +144,17 @@ public:
      * @brief Access a specific row.
      * @param row The wanted row's index.
      * @note No bounds checking.
-     * @return A reference to the wanted row.
+     * @return A view over the wanted row.
      */
-    Array<Type>& operator[](std::size_t row);
+    ArrayView<Type> operator[](std::size_t row);
 
     /**
      * @brief Access a specific row.
      * @param row The wanted row's index.
      * @note No bounds checking.
-     * @return A const-reference to the wanted row.
+     * @return A read-only view over the wanted row.
      */
-    const Array<Type>& operator[](std::size_t row) const;
+    ArrayView<const Type> operator[](std::size_t row) const;
 
     /**
      * @return Current number of rows in the array.
@@ -84,14 +167,26 @@ public:
     std::size_t get_width() const;
 
     /**
-     * @return A reference to the internal Array.
+     * @return The distance in elements between the starts of two consecutive rows.
      */
-    Array<Array<Type>>& get_data();
+    std::size_t get_stride() const;
 
     /**
-     * @return A const-reference to the internal Array.
+     * @return A pointer to the first element of the first row.
+     * @note Will return nullptr if the array is empty.
      */
-    const Array<Array<Type>>& get_data() const;
+    Type* get_data();
+
+    /**
+     * @return A const pointer to the first element of the first row.
+     * @note Will return nullptr if the array is empty.
+     */
+    const Type* get_data() const;
+
+    /**
+     * @return The memory resource the array allocates from.
+     */
+    std::pmr::memory_resource* get_resource() const;
 
     /**
      * @return True if the array has no elements.
@@ -99,24 +194,24 @@ public:
     bool empty() const;
 
     /**
-     * @return An iterator to the beginning of the array.
+     * @return An iterator to the first row of the array.
      */
-    Array<Type>* begin();
+    RowIterator<Type> begin();
 
     /**
-     * @return A const iterator to the beginning of the array.
+     * @return A const iterator to the first row of the array.
      */
-    const Array<Type>* begin() const;
+    RowIterator<const Type> begin() const;
 
     /**
      * @return An iterator to the row past the end of the array.
      */
-    Array<Type>* end();
+    RowIterator<Type> end();
 
     /**
      * @return A const iterator to the row past the end of the array.
      */
-    const Array<Type>* end() const;
+    RowIterator<const Type> end() const;
 
     /**
      * @brief Resizes the array. If expanded, new elements are default-constructed. If shrunk,
@@ -142,9 +237,18 @@ public:
     void assign(std::size_t new_height, std::size_t new_width, const Type& value);
 
 protected:
-    std::size_t height;      ///< Number of rows in the array.
-    std::size_t width;       ///< Number of columns in the array.
-    Array<Array<Type>> data; ///< Pointer to heap-allocated data.
+    /**
+     * @brief Computes the stride of rows of 'width' elements, i.e. the smallest number of elements
+     * greater or equal to 'width' that spans a multiple of 'alignment' bytes.
+     * @param width The number of columns.
+     * @return The padded stride.
+     */
+    static std::size_t padded_stride(std::size_t width);
+
+    std::size_t height; ///< Number of rows in the array.
+    std::size_t width;  ///< Number of columns in the array.
+    std::size_t stride; ///< Distance in elements between the starts of two consecutive rows.
+    Array<Type> data;   ///< Contiguous row-major storage of all the rows.
 };
 
 /**
@@ -156,10 +260,10 @@ protected:
 template <typename Type>
 std::ostream& operator <<(std::ostream& stream, const Array2D<Type>& array) {
     stream << '(';
-    for(const Array<Type>& row : array) {
-        if(&row > array.begin()) { stream << ' '; }
-        stream << row;
-        if(&row < array.end() - 1) { stream << ",\n"; }
+    for(std::size_t i = 0 ; i < array.get_height() ; ++i) {
+        if(i > 0) { stream << ' '; }
+        stream << array[i];
+        if(i + 1 < array.get_height()) { stream << ",\n"; }
     }
     stream << ')';
 
@@ -167,38 +271,48 @@ std::ostream& operator <<(std::ostream& stream, const Array2D<Type>& array) {
 }
 
 template <typename Type>
-Array2D<Type>::Array2D() : height(0), width(0), data() { }
+Array2D<Type>::Array2D() : height(0), width(0), stride(0), data() { }
 
 template <typename Type>
-Array2D<Type>::Array2D(std::size_t height, std::size_t width)
-    : height(height), width(width), data(height) {
-    for(Array<Type>& row : data) { row.resize(width); }
-}
+Array2D<Type>::Array2D(std::pmr::memory_resource* resource)
+    : height(0), width(0), stride(0), data(resource) { }
 
 template <typename Type>
-Array2D<Type>::Array2D(std::size_t height, std::size_t width, Type default_value)
-    : height(height), width(width), data(height) {
-    for(Array<Type>& row : data) { row.assign(width, default_value); }
-}
+Array2D<Type>::Array2D(std::size_t height, std::size_t width, std::pmr::memory_resource* resource)
+    : height(height), width(width), stride(padded_stride(width)),
+      data(height * stride, resource) { }
+
+template <typename Type>
+Array2D<Type>::Array2D(std::size_t height, std::size_t width, Type default_value,
+                       std::pmr::memory_resource* resource)
+    : height(height), width(width), stride(padded_stride(width)),
+      data(height * stride, default_value, resource) { }
+
+template <typename Type>
+Array2D<Type>::Array2D(std::size_t height, std::size_t width, UninitializedTag,
+                       std::pmr::memory_resource* resource)
+    requires UninitializableType<Type>
+    : height(height), width(width), stride(padded_stride(width)),
+      data(height * stride, uninitialized, resource) { }
 
 template <typename Type>
 Type& Array2D<Type>::operator()(std::size_t row, std::size_t column) {
-    return data[row][column];
+    return data[row * stride + column];
 }
 
 template <typename Type>
 const Type& Array2D<Type>::operator()(std::size_t row, std::size_t column) const {
-    return data[row][column];
+    return data[row * stride + column];
 }
 
 template <typename Type>
-Array<Type>& Array2D<Type>::operator[](std::size_t row) {
-    return data[row];
+ArrayView<Type> Array2D<Type>::operator[](std::size_t row) {
+    return ArrayView<Type>(data.get_data() + row * stride, width);
 }
 
 template <typename Type>
-const Array<Type>& Array2D<Type>::operator[](std::size_t row) const {
-    return data[row];
+ArrayView<const Type> Array2D<Type>::operator[](std::size_t row) const {
+    return ArrayView<const Type>(data.get_data() + row * stride, width);
 }
 
 template <typename Type>
@@ -212,13 +326,23 @@ std::size_t Array2D<Type>::get_width() const {
 }
 
 template <typename Type>
-Array<Array<Type>>& Array2D<Type>::get_data() {
-    return data;
+std::size_t Array2D<Type>::get_stride() const {
+    return stride;
 }
 
 template <typename Type>
-const Array<Array<Type>>& Array2D<Type>::get_data() const {
-    return data;
+Type* Array2D<Type>::get_data() {
+    return data.get_data();
+}
+
+template <typename Type>
+const Type* Array2D<Type>::get_data() const {
+    return data.get_data();
+}
+
+template <typename Type>
+std::pmr::memory_resource* Array2D<Type>::get_resource() const {
+    return data.get_resource();
 }
 
 template <typename Type>
@@ -227,46 +351,69 @@ bool Array2D<Type>::empty() const {
 }
 
 template <typename Type>
-Array<Type>* Array2D<Type>::begin() {
-    return data.begin();
+typename Array2D<Type>::template RowIterator<Type> Array2D<Type>::begin() {
+    return RowIterator<Type>(data.get_data(), width, stride);
 }
 
 template <typename Type>
-const Array<Type>* Array2D<Type>::begin() const {
-    return data.begin();
+typename Array2D<Type>::template RowIterator<const Type> Array2D<Type>::begin() const {
+    return RowIterator<const Type>(data.get_data(), width, stride);
 }
 
 template <typename Type>
-Array<Type>* Array2D<Type>::end() {
-    return data.end();
+typename Array2D<Type>::template RowIterator<Type> Array2D<Type>::end() {
+    return RowIterator<Type>(data.get_data() + height * stride, width, stride);
 }
 
 template <typename Type>
-const Array<Type>* Array2D<Type>::end() const {
-    return data.end();
+typename Array2D<Type>::template RowIterator<const Type> Array2D<Type>::end() const {
+    return RowIterator<const Type>(data.get_data() + height * stride, width, stride);
 }
 
 template <typename Type>
 void Array2D<Type>::resize(std::size_t new_height, std::size_t new_width) {
-    width = new_width;
+    if(new_height == height && new_width == width) { return; }
+
+    std::size_t new_stride = padded_stride(new_width);
+    Array<Type> new_data(data.get_resource());
+    new_data.reserve(new_height * new_stride);
+
+    // The kept elements are moved into the raw storage and only the others are value-constructed, so
+    // that every element is initialized once.
+    std::size_t kept_rows = std::min(height, new_height);
+    std::size_t kept_columns = std::min(width, new_width);
+    for(std::size_t i = 0 ; i < kept_rows ; ++i) {
+        for(std::size_t j = 0 ; j < kept_columns ; ++j) {
+            new_data.emplace_back(std::move(data[i * stride + j]));
+        }
+        new_data.resize((i + 1) * new_stride);
+    }
+    new_data.resize(new_height * new_stride);
+
     height = new_height;
-    data.resize(height);
-    for(Array<Type>& row : data) { row.resize(width); }
+    width = new_width;
+    stride = new_stride;
+    data = std::move(new_data);
 }
 
 template <typename Type>
 void Array2D<Type>::fill(const Type& value) {
-    for(Array<Type>& row : data) {
-        for(Type& element : row) {
-            element = value;
-        }
-    }
+    data.fill(value);
 }
 
 template <typename Type>
 void Array2D<Type>::assign(std::size_t new_height, std::size_t new_width, const Type& value) {
-    width = new_width;
+    // The dimensions are only changed once the data is, in case the allocation throws.
+    std::size_t new_stride = padded_stride(new_width);
+    data.assign(new_height * new_stride, value);
+
     height = new_height;
-    data.resize(height);
-    for(Array<Type>& row : data) { row.assign(width, value); }
+    width = new_width;
+    stride = new_stride;
+}
+
+template <typename Type>
+std::size_t Array2D<Type>::padded_stride(std::size_t width) {
+    constexpr std::size_t step = std::lcm(sizeof(Type), alignment) / sizeof(Type);
+    return (width + step - 1) / step * step;
 }
@@ -0,0 +1,183 @@
+/***************************************************************************************************
+ * @file  Array2DView.hpp
+ * @brief Declaration of the Array2DView class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <concepts>
+#include <iostream>
+#include <type_traits>
+#include "Array2D.hpp"
+#include "ArrayView.hpp"
+
+/**
+ * @brief Whether a container stores its elements in rows of a strided buffer and exposes them
+ * through get_data(), get_height(), get_width() and get_stride(), like Array2D and Image.
+ * @tparam Container The type of the container.
+ * @tparam Type The type the container's elements must be accessible as.
+ */
+template <typename Container, typename Type>
+concept StridedContainerOf = requires(Container& container) {
+    { container.get_data() } -> std::convertible_to<Type*>;
+    { container.get_height() } -> std::convertible_to<std::size_t>;
+    { container.get_width() } -> std::convertible_to<std::size_t>;
+    { container.get_stride() } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * @class Array2DView
+ * @brief A non-owning view over a 2D grid of 'Type' whose rows are 'stride' elements apart. Copying
+ * a view never copies the elements it refers to, and neither does taking a region of it, so views
+ * can be used to split work into tiles.
+ * @tparam Type The type of the viewed data. Use a const type for a read-only view.
+ */
+template <typename Type>
+class Array2DView {
+public:
+    /// Iterator over the rows of the view.
+    using RowIterator = Array2D<std::remove_const_t<Type>>::template RowIterator<Type>;
+
+    /**
+     * @brief Default constructor. Creates an empty view.
+     */
+    Array2DView() : height(0), width(0), stride(0), data(nullptr) { }
+
+    /**
+     * @brief Constructs a view over a grid starting at 'data'.
+     * @param data A pointer to the first element of the first row.
+     * @param height The number of rows.
+     * @param width The number of columns.
+     * @param stride The distance in elements between the starts of two consecutive rows.
+     */
+    Array2DView(Type* data, std::size_t height, std::size_t width, std::size_t stride)
+        : height(height), width(width), stride(stride), data(data) { }
+
+    /**
+     * @brief Constructs a view over a contiguous grid starting at 'data'.
+     * @param data A pointer to the first element of the first row.
+     * @param height The number of rows.
+     * @param width The number of columns.
+     */
+    Array2DView(Type* data, std::size_t height, std::size_t width)
+        : Array2DView(data, height, width, width) { }
+
+    /**
+     * @brief Constructs a view over all the elements of a 2D container such as an Array2D, an Image
+     * or a MappedArray2D.
+     * @param container The container to view. Must outlive the view.
+     */
+    template <typename Container> requires StridedContainerOf<Container, Type>
+    Array2DView(Container& container)
+        : height(container.get_height()), width(container.get_width()),
+          stride(container.get_stride()), data(container.get_data()) { }
+
+    /**
+     * @brief Constructs a view from another view of a compatible type, e.g. a read-only view from a
+     * mutable one.
+     * @param other The view to convert.
+     */
+    template <typename OtherType> requires std::convertible_to<OtherType*, Type*>
+    Array2DView(const Array2DView<OtherType>& other)
+        : height(other.get_height()), width(other.get_width()),
+          stride(other.get_stride()), data(other.get_data()) { }
+
+    /**
+     * @brief Access a specific element by its row and column.
+     * @param row The wanted element's row's index.
+     * @param column The wanted element's column's index.
+     * @note No bounds checking.
+     * @return A reference to the wanted element.
+     */
+    Type& operator ()(std::size_t row, std::size_t column) const { return data[row * stride + column]; }
+
+    /**
+     * @brief Access a specific row.
+     * @param row The wanted row's index.
+     * @note No bounds checking.
+     * @return A view over the wanted row.
+     */
+    ArrayView<Type> operator[](std::size_t row) const { return ArrayView<Type>(data + row * stride, width); }
+
+    /**
+     * @return Number of rows in the view.
+     */
+    std::size_t get_height() const { return height; }
+
+    /**
+     * @return Number of columns in the view.
+     */
+    std::size_t get_width() const { return width; }
+
+    /**
+     * @return The distance in elements between the starts of two consecutive rows.
+     */
+    std::size_t get_stride() const { return stride; }
+
+    /**
+     * @return A pointer to the first element of the first row.
+     */
+    Type* get_data() const { return data; }
+
+    /**
+     * @return True if the view has no elements.
+     */
+    bool empty() const { return height == 0 || width == 0; }
+
+    /**
+     * @return An iterator to the first row of the view.
+     */
+    RowIterator begin() const { return RowIterator(data, width, stride); }
+
+    /**
+     * @return An iterator to the row past the end of the view.
+     */
+    RowIterator end() const { return RowIterator(data + height * stride, width, stride); }
+
+    /**
+     * @brief Creates a view over a rectangular region of this view.
+     * @param row The index of the first row of the region.
+     * @param column The index of the first column of the region.
+     * @param region_height The number of rows of the region.
+     * @param region_width The number of columns of the region.
+     * @note No bounds checking.
+     * @return The view over the region.
+     */
+    Array2DView region(std::size_t row, std::size_t column,
+                       std::size_t region_height, std::size_t region_width) const {
+        return Array2DView(data + row * stride + column, region_height, region_width, stride);
+    }
+
+    /**
+     * @brief Fills the viewed elements with a value.
+     * @param value The value to fill the view with.
+     */
+    void fill(const Type& value) const requires (!std::is_const_v<Type>) {
+        for(std::size_t i = 0 ; i < height ; ++i) { (*this)[i].fill(value); }
+    }
+
+private:
+    std::size_t height; ///< Number of rows in the view.
+    std::size_t width;  ///< Number of columns in the view.
+    std::size_t stride; ///< Distance in elements between the starts of two consecutive rows.
+    Type* data;         ///< Pointer to the first element of the first row.
+};
+
+/**
+ * @brief Outputs a 2D view to an output stream.
+ * @param stream The stream to output to.
+ * @param view The view to output.
+ * @return A reference to the stream.
+ */
+template <typename Type>
+std::ostream& operator <<(std::ostream& stream, const Array2DView<Type>& view) {
+    stream << '(';
+    for(std::size_t i = 0 ; i < view.get_height() ; ++i) {
+        if(i > 0) { stream << ' '; }
+        stream << view[i];
+        if(i + 1 < view.get_height()) { stream << ",\n"; }
+    }
+    stream << ')';
+
+    return stream;
+}
@@ -0,0 +1,130 @@
+/***************************************************************************************************
+ * @file  ArrayView.hpp
+ * @brief Declaration of the ArrayView class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <iostream>
+#include <type_traits>
+
+/**
+ * @brief Whether a container stores its elements contiguously and exposes them through get_data()
+ * and get_size(), like Array and MappedArray.
+ * @tparam Container The type of the container.
+ * @tparam Type The type the container's elements must be accessible as.
+ */
+template <typename Container, typename Type>
+concept ContiguousContainerOf = requires(Container& container) {
+    { container.get_data() } -> std::convertible_to<Type*>;
+    { container.get_size() } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * @class ArrayView
+ * @brief A non-owning view over a contiguous sequence of 'Type'. Copying a view never copies the
+ * elements it refers to, and neither does slicing it.
+ * @tparam Type The type of the viewed data. Use a const type for a read-only view.
+ */
+template <typename Type>
+class ArrayView {
+public:
+    /**
+     * @brief Default constructor. Creates an empty view.
+     */
+    ArrayView() : size(0), data(nullptr) { }
+
+    /**
+     * @brief Constructs a view over 'size' elements starting at 'data'.
+     * @param data A pointer to the first element.
+     * @param size The number of elements.
+     */
+    ArrayView(Type* data, std::size_t size) : size(size), data(data) { }
+
+    /**
+     * @brief Constructs a view over all the elements of a contiguous container such as an Array.
+     * @param container The container to view. Must outlive the view.
+     */
+    template <typename Container> requires ContiguousContainerOf<Container, Type>
+    ArrayView(Container& container) : size(container.get_size()), data(container.get_data()) { }
+
+    /**
+     * @brief Constructs a view from another view of a compatible type, e.g. a read-only view from a
+     * mutable one.
+     * @param other The view to convert.
+     */
+    template <typename OtherType> requires std::convertible_to<OtherType*, Type*>
+    ArrayView(const ArrayView<OtherType>& other) : size(other.get_size()), data(other.get_data()) { }
+
+    /**
+     * @brief Access element at 'index'.
+     * @param index The index of the wanted element.
+     * @note No bounds checking.
+     * @return A reference to the wanted element.
+     */
+    Type& operator[](std::size_t index) const { return data[index]; }
+
+    /**
+     * @return Number of elements in the view.
+     */
+    std::size_t get_size() const { return size; }
+
+    /**
+     * @return A pointer to the first element of the view.
+     */
+    Type* get_data() const { return data; }
+
+    /**
+     * @return True if the view has no elements.
+     */
+    bool empty() const { return size == 0; }
+
+    /**
+     * @return An iterator to the beginning of the view.
+     */
+    Type* begin() const { return data; }
+
+    /**
+     * @return An iterator to the element past the end of the view.
+     */
+    Type* end() const { return data + size; }
+
+    /**
+     * @brief Creates a view over a part of this view.
+     * @param offset The index of the first element of the subview.
+     * @param count The number of elements of the subview.
+     * @note No bounds checking.
+     * @return The subview.
+     */
+    ArrayView subview(std::size_t offset, std::size_t count) const { return ArrayView(data + offset, count); }
+
+    /**
+     * @brief Fills the viewed elements with a value.
+     * @param value The value to fill the view with.
+     */
+    void fill(const Type& value) const requires (!std::is_const_v<Type>) { std::fill_n(data, size, value); }
+
+private:
+    std::size_t size; ///< Number of elements in the view.
+    Type* data;       ///< Pointer to the first viewed element.
+};
+
+/**
+ * @brief Outputs a view to an output stream.
+ * @param stream The stream to output to.
+ * @param view The view to output.
+ * @return A reference to the stream.
+ */
+template <typename Type>
+std::ostream& operator <<(std::ostream& stream, const ArrayView<Type>& view) {
+    stream << '(';
+    for(const Type& element : view) {
+        stream << element;
+        if(&element < view.end() - 1) { stream << ", "; }
+    }
+    stream << ')';
+
+    return stream;
+}
@@ -0,0 +1,112 @@
+/***************************************************************************************************
+ * @file  AsyncImageWriter.hpp
+ * @brief Declaration of the AsyncImageWriter class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <mutex>
+#include <thread>
+#include "Image.hpp"
+
+/**
+ * @class AsyncImageWriter
+ * @brief Writes snapshots of images to files on a background thread, so that the caller only pays
+ * for copying the pixels, e.g. a renderer saving its progress every few samples.
+ *
+ * Two staging images are recycled: one holds the snapshot being encoded, the other the next one
+ * waiting for the encoder. When the encoder falls behind, a new snapshot replaces the waiting one,
+ * which is dropped as stale, unless the writer was told to keep every snapshot, in which case
+ * submitting waits for the waiting slot to be free. Staging images keep their pixels between
+ * snapshots, so snapshots of a same size don't allocate.
+ */
+class AsyncImageWriter {
+public:
+    /**
+     * @struct Statistics
+     * @brief What the writer did so far, to tune how often snapshots are submitted.
+     */
+    struct Statistics {
+        std::size_t submitted = 0;        ///< The number of snapshots submitted.
+        std::size_t written = 0;          ///< The number of snapshots encoded and written.
+        std::size_t dropped = 0;          ///< The number of snapshots replaced by a newer one before encoding.
+        std::size_t failed = 0;           ///< The number of snapshots that couldn't be written.
+        std::size_t queue_depth = 0;      ///< The number of snapshots waiting or being encoded: 0, 1 or 2.
+        double last_encode_time = 0.0;    ///< The duration in seconds of the last encoding and write.
+        double average_encode_time = 0.0; ///< The average duration in seconds of encodings and writes.
+        double max_encode_time = 0.0;     ///< The longest duration in seconds of an encoding and write.
+    };
+
+    /**
+     * @brief Starts the background thread.
+     * @param options How to encode the files.
+     * @param drop_stale Whether a new snapshot replaces the one waiting for the encoder. Otherwise,
+     * submitting waits for the encoder to take the waiting snapshot, and no snapshot is lost.
+     */
+    explicit AsyncImageWriter(const ImageWriteOptions& options = {}, bool drop_stale = true);
+
+    AsyncImageWriter(const AsyncImageWriter& other) = delete;
+
+    /**
+     * @brief Destructor. Writes the waiting snapshot, if any, then joins the background thread.
+     * Errors are ignored.
+     */
+    ~AsyncImageWriter();
+
+    AsyncImageWriter& operator=(const AsyncImageWriter& other) = delete;
+
+    /**
+     * @brief Copies an image and queues it for writing to a file, in the format matching its
+     * extension (see ImageFormat).
+     * @param image The image to snapshot.
+     * @param path The path to the output image file.
+     * @note Rethrows the error of a previous write that failed since the last call to submit or
+     * flush. Throws a std::runtime_error if the extension is not a supported format.
+     */
+    void submit(const Image& image, const std::filesystem::path& path);
+
+    /**
+     * @brief Waits for every submitted snapshot to be written or dropped.
+     * @note Rethrows the error of a write that failed since the last call to submit or flush.
+     */
+    void flush();
+
+    /**
+     * @return What the writer did so far.
+     */
+    Statistics get_statistics() const;
+
+private:
+    /**
+     * @brief The loop of the background thread, encoding snapshots until the writer is destroyed.
+     */
+    void work();
+
+    /**
+     * @brief Rethrows the error of a failed write, if any, and forgets it.
+     * @note Must be called with the mutex locked.
+     */
+    void rethrow_error();
+
+    ImageWriteOptions options; ///< How to encode the files.
+    bool drop_stale;           ///< Whether a new snapshot replaces the waiting one.
+
+    mutable std::mutex mutex;          ///< Protects everything below but 'encoding'.
+    std::condition_variable condition; ///< Notified whenever a snapshot is submitted or finished.
+
+    Image waiting;                          ///< The snapshot waiting for the encoder.
+    std::filesystem::path waiting_path;     ///< The path to write the waiting snapshot to.
+    bool has_waiting = false;               ///< Whether 'waiting' holds a snapshot.
+    Image encoding;                         ///< The snapshot being encoded, only used by the background thread.
+    bool is_encoding = false;               ///< Whether the background thread is encoding a snapshot.
+    bool is_stopping = false;               ///< Whether the writer is being destroyed.
+    std::exception_ptr error;               ///< The error of a failed write, not rethrown yet.
+    Statistics statistics;                  ///< What the writer did so far.
+    double total_encode_time = 0.0;         ///< The sum of the durations of encodings and writes.
+
+    std::thread thread; ///< The background thread, started last.
+};
@@ -0,0 +1,99 @@
+/***************************************************************************************************
+ * @file  FFTPlan.hpp
+ * @brief Declaration of the FFTPlan class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "Array.hpp"
+
+/**
+ * @enum FFTDirection
+ * @brief The direction of a discrete Fourier transform.
+ */
+enum class FFTDirection {
+    Forward, ///< X[k] = sum of x[j] * e^(-2 pi i j k / n).
+    Inverse  ///< x[j] = sum of X[k] * e^(+2 pi i j k / n), without the 1 / n factor.
+};
+
+/**
+ * @class FFTPlan
+ * @brief The factorization and twiddle factors of the complex discrete Fourier transforms of a
+ * given size, computed once and reused by every transform.
+ *
+ * Transforms are computed by a Stockham autosort FFT: one pass per factor of the size, radix 4 first,
+ * then 2, 3, 5 and any other prime, alternating between the data and a scratch buffer so that no bit
+ * reversal is needed. Every size works, but sizes whose prime factors are 2, 3 and 5 are the fastest,
+ * other primes being transformed by O(p^2) passes.
+ *
+ * Transforms aren't normalized: an inverse transform of a forward transform multiplies the data by
+ * the size. A plan is immutable once built, so several threads can use it at once. get() shares
+ * plans through a cache, so that transforming data of the same size again, e.g. the rows of every
+ * frame of a video, doesn't compute twiddle factors again.
+ */
+class FFTPlan {
+public:
+    /**
+     * @brief Constructor. Factors the size and computes the twiddle factors of every pass.
+     * @param size The number of elements of the transforms, at least 1.
+     */
+    explicit FFTPlan(std::size_t size);
+
+    /**
+     * @param size The number of elements of the transforms, at least 1.
+     * @return The plan of that size, built on the first call and cached for the following ones.
+     * @note Thread-safe.
+     */
+    static std::shared_ptr<const FFTPlan> get(std::size_t size);
+
+    /**
+     * @brief Transforms interleaved sequences in place: element j of sequence b is data[j * batch + b].
+     * Transforming several sequences at once, e.g. the columns of a block of rows, keeps the inner
+     * loops long and contiguous.
+     * @param data The sequences, 'size * batch' elements.
+     * @param scratch A buffer of 'size * batch' elements, overwritten.
+     * @param direction The direction of the transform.
+     * @param batch The number of sequences.
+     */
+    void transform(std::complex<float>* data, std::complex<float>* scratch, FFTDirection direction,
+                   std::size_t batch = 1) const;
+
+    /**
+     * @brief Transforms a sequence in place.
+     * @param data The sequence, 'size' elements.
+     * @param direction The direction of the transform.
+     */
+    void transform(Array<std::complex<float>>& data, FFTDirection direction) const;
+
+    /**
+     * @return The number of elements of the transforms.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @param size A size.
+     * @return The smallest size greater or equal to it whose prime factors are 2, 3 and 5, to pad
+     * data to before transforming it.
+     */
+    static std::size_t get_fast_size(std::size_t size);
+
+private:
+    /**
+     * @struct Pass
+     * @brief A pass of the transform, combining 'radix' transforms of 'length' elements each.
+     */
+    struct Pass {
+        std::size_t radix;  ///< The factor of the size the pass handles.
+        std::size_t length; ///< The number of elements of the transforms the pass combines.
+        std::size_t offset; ///< The index of the pass's first twiddle factor.
+    };
+
+    std::size_t size;                    ///< The number of elements of the transforms.
+    std::vector<Pass> passes;            ///< The passes, in order.
+    Array<std::complex<float>> twiddles; ///< The twiddle factors of every pass, followed by the roots
+                                         ///< of unity of its radix if it isn't 2, 3, 4 or 5.
+};
@@ -5,18 +5,32 @@
 
 #pragma once
 
+#include <cstddef>
 #include <filesystem>
+#include <iosfwd>
+#include <span>
+#include <utility>
+#include <vector>
 #include "Array2D.hpp"
+#include "ImagePyramid.hpp"
+#include "image_io.hpp"
+#include "resample.hpp"
 #include "vec.hpp"
 
 /**
  * @class Image
  * @brief A 2D floating-point RGB image.
  *
- * Extends the Array<vec3> class and supports loading and writing images from and to files using the
- * stb_image and stb_image_write libraries.
+ * Extends the Array<vec3> class and supports loading and writing images from and to files, and
+ * decoding and encoding them from and to memory or streams (see image_io.hpp). QOI, PNG encoding and
+ * the uncompressed formats are handled natively, the rest by the stb_image and stb_image_write
+ * libraries.
  *
- * Pixel values are stored as linear RGB values in the range [0 ; 1].
+ * Pixel values are stored as RGB values in the range [0 ; 1]. They are linear when files are read
+ * and written with ColorSpace::SRGB, which converts from and to the sRGB curve of most image files
+ * through lookup tables. ColorSpace::Linear only rescales the files' values.
+ *
+ * Like any Array2D, the pixels can be allocated from a specific std::pmr::memory_resource.
  */
 class Image : public Array2D<vec3> {
 public:
@@ -26,22 +40,116 @@ public:
      * @brief Construct an image by loading it from a file.
      * @param path The path to the input image file.
      * @param flip_vertically Whether to flip the image vertically on load.
+     * @param color_space The color space of the file's 8-bit values. Float formats (HDR, PFM) are
+     * read as they are.
+     * @param resource The memory resource to allocate the pixels from.
      */
-    explicit Image(const std::filesystem::path& path, bool flip_vertically = false);
+    explicit Image(const std::filesystem::path& path, bool flip_vertically = false,
+                   ColorSpace color_space = ColorSpace::Linear,
+                   std::pmr::memory_resource* resource = std::pmr::get_default_resource());
 
     /**
-     * @brief Loads an image from a file.
+     * @brief Loads an image from a file. The pixels are allocated from the image's resource.
      * @param path The path to the input image file.
      * @param flip_vertically Whether to flip the image vertically on load.
+     * @param color_space The color space of the file's 8-bit values. Float formats (HDR, PFM) are
+     * read as they are.
+     */
+    void read(const std::filesystem::path& path, bool flip_vertically = false,
+              ColorSpace color_space = ColorSpace::Linear);
+
+    /**
+     * @brief Decodes an image from memory, e.g. an uploaded file. The format is recognized from the
+     * content. The pixels are allocated from the image's resource.
+     * @param data The encoded image.
+     * @param flip_vertically Whether to flip the image vertically.
+     * @param color_space The color space of the image's 8-bit values. Float formats (HDR, PFM) are
+     * read as they are.
+     * @note Throws a std::runtime_error if the data can't be decoded.
      */
-    void read(const std::filesystem::path& path, bool flip_vertically = false);
+    void decode(std::span<const std::byte> data, bool flip_vertically = false,
+                ColorSpace color_space = ColorSpace::Linear);
 
     /**
-     * @brief Writes an image to a file.
+     * @brief Encodes an image to memory.
+     * @param format The format to encode to.
+     * @param options How to encode the image.
+     * @return The encoded data, as it would be stored in a file.
+     * @note Throws a std::runtime_error if the image can't be encoded.
+     */
+    std::vector<std::byte> encode(ImageFormat format, const ImageWriteOptions& options = {}) const;
+
+    /**
+     * @brief Encodes an image to a stream, e.g. a socket or a pipe.
+     * @param output The stream to write to.
+     * @param format The format to encode to.
+     * @param options How to encode the image.
+     * @note Throws a std::runtime_error if the image can't be encoded or the stream fails.
+     */
+    void encode_to(std::ostream& output, ImageFormat format, const ImageWriteOptions& options = {}) const;
+
+    /**
+     * @brief Writes an image to a file, in the format matching its extension (see ImageFormat).
      * @param path The path to the output image file.
+     * @param color_space The color space to encode the file's values in. Float formats (HDR, PFM)
+     * always get the pixels' values as they are.
+     * @note Throws a std::runtime_error if the extension is not a supported format.
      */
-    void write(const std::filesystem::path& path);
+    void write(const std::filesystem::path& path, ColorSpace color_space = ColorSpace::Linear);
+
+    /**
+     * @brief Writes an image to a file, in the format matching its extension (see ImageFormat).
+     * @param path The path to the output image file.
+     * @param options How to encode the file, e.g. the quality of JPG files.
+     * @note Throws a std::runtime_error if the extension is not a supported format.
+     */
+    void write(const std::filesystem::path& path, const ImageWriteOptions& options);
+
+    /**
+     * @brief Builds the levels of the image, e.g. the mipmaps of a texture. See ImagePyramid.
+     * @param levels The number of levels, the image included, clamped to the full chain. 0 builds the
+     * full chain, down to 1x1.
+     * @param filter The filter halving the levels.
+     * @return The levels, stored in a single allocation.
+     */
+    ImagePyramid build_pyramid(std::size_t levels = 0, PyramidFilter filter = PyramidFilter::Box) const;
+
+    /**
+     * @brief Resamples the image to other dimensions, e.g. to make a thumbnail. See resample.
+     * @param new_height The number of rows of the resampled image.
+     * @param new_width The number of columns of the resampled image.
+     * @param filter The filter.
+     * @return The resampled image, allocated from the image's resource.
+     */
+    Image resampled(std::size_t new_height, std::size_t new_width, ResampleFilter filter = ResampleFilter::Bicubic) const;
+
+    /**
+     * @brief Reads the dimensions, channel count and format of an image file from its header,
+     * without decoding its pixels.
+     * @param path The path to the image file.
+     * @return The description of the image.
+     * @note Throws a std::runtime_error if the file can't be read or is not a supported image.
+     */
+    static ImageInfo probe(const std::filesystem::path& path);
+
+    /**
+     * @brief Probes every image file of a directory, in parallel on the global thread pool. Files
+     * that can't be read or are not supported images are skipped.
+     * @param directory The path to the directory.
+     * @param recursive Whether to also probe the files of the subdirectories.
+     * @return The path and description of every image, sorted by path.
+     * @note Throws a std::filesystem::filesystem_error if the directory can't be listed.
+     */
+    static std::vector<std::pair<std::filesystem::path, ImageInfo>>
+    probe_directory(const std::filesystem::path& directory, bool recursive = false);
 
 private:
-    bool is_flipped; ///< Whether the image was flipped on load (and thus needs to be flipped on write).
+    /**
+     * @brief Replaces the pixels with decoded ones.
+     * @param image The decoded pixels, with 3 channels.
+     * @param color_space The color space of 8-bit values.
+     */
+    void assign_decoded(const DecodedImage& image, ColorSpace color_space);
+
+    bool is_flipped = false; ///< Whether the image was flipped on load (and thus needs to be flipped on write).
 };
@@ -0,0 +1,106 @@
+/***************************************************************************************************
+ * @file  ImagePyramid.hpp
+ * @brief Declaration of the ImagePyramid class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Array.hpp"
+#include "Array2DView.hpp"
+#include "vec.hpp"
+
+/**
+ * @enum PyramidFilter
+ * @brief The filters halving the levels of an image pyramid.
+ */
+enum class PyramidFilter {
+    Box,    ///< Averages the pixels each one covers, 2x2 of them for even dimensions. The fastest.
+    Kaiser, ///< A Kaiser-windowed sinc, sharper than the box with little ringing.
+    Lanczos ///< A Lanczos-windowed sinc (3 lobes), the sharpest, with some ringing.
+};
+
+/**
+ * @class ImagePyramid
+ * @brief The full chain of levels of an image, e.g. the mipmaps of a texture, each half the size of
+ * the previous one, down to 1x1.
+ *
+ * All levels are stored in a single contiguous allocation, one after the other with tightly packed
+ * rows, each level starting on an Array::alignment boundary. A level's dimensions are those of the
+ * previous one halved and rounded down, at least 1. Odd dimensions are filtered with weights
+ * matching the area each pixel covers, so that no row or column of the previous level is ignored.
+ *
+ * Pixels are filtered as they are, which is gamma-correct for images holding linear values, e.g.
+ * loaded with ColorSpace::SRGB. The negative lobes of the Kaiser and Lanczos filters can ring, so
+ * their results are clamped to be non-negative.
+ */
+class ImagePyramid {
+public:
+    /**
+     * @brief Default constructor. Holds no level.
+     */
+    ImagePyramid();
+
+    /**
+     * @brief Builds the levels of an image. The rows of each level are filtered in parallel on the
+     * global thread pool, except for the smallest levels, which are built by a single thread.
+     * @param image The first level.
+     * @param levels The number of levels, clamped to the full chain. 0 builds the full chain.
+     * @param filter The filter halving the levels.
+     */
+    ImagePyramid(Array2DView<const vec3> image, std::size_t levels = 0, PyramidFilter filter = PyramidFilter::Box);
+
+    /**
+     * @brief Access a specific level.
+     * @param level The wanted level's index, 0 being the full-size image.
+     * @note No bounds checking.
+     * @return A view over the wanted level.
+     */
+    Array2DView<vec3> operator[](std::size_t level);
+
+    /**
+     * @brief Access a specific level.
+     * @param level The wanted level's index, 0 being the full-size image.
+     * @note No bounds checking.
+     * @return A read-only view over the wanted level.
+     */
+    Array2DView<const vec3> operator[](std::size_t level) const;
+
+    /**
+     * @return Number of levels.
+     */
+    std::size_t get_level_count() const;
+
+    /**
+     * @return The storage of all levels, one after the other.
+     */
+    const Array<vec3>& get_storage() const;
+
+    /**
+     * @param level A level's index.
+     * @return The offset in elements of the level's first pixel in the storage.
+     */
+    std::size_t get_offset(std::size_t level) const;
+
+    /**
+     * @param width The number of columns of the first level.
+     * @param height The number of rows of the first level.
+     * @return The number of levels of the full chain of an image.
+     */
+    static std::size_t get_full_level_count(std::size_t width, std::size_t height);
+
+private:
+    /**
+     * @struct Level
+     * @brief The place of a level in the storage.
+     */
+    struct Level {
+        std::size_t offset; ///< Offset in elements of the first pixel.
+        std::size_t height; ///< Number of rows.
+        std::size_t width;  ///< Number of columns.
+    };
+
+    Array<vec3> storage;       ///< The pixels of every level.
+    std::vector<Level> levels; ///< The place of every level in the storage.
+};
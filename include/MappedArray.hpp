@@ -0,0 +1,209 @@
+/***************************************************************************************************
+ * @file  MappedArray.hpp
+ * @brief Declaration of the MappedArray class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include "MappedFile.hpp"
+
+/**
+ * @class MappedArray
+ * @brief A fixed-size array backed by a memory-mapped file holding the raw elements.
+ *
+ * Mapping is O(1) whatever the size of the file: pages are only loaded when accessed, and the page
+ * cache is shared with every other process mapping the same file.
+ *
+ * @tparam Type The type of the array's data. Must be trivially copyable since it is read from and
+ * written to the file as raw bytes.
+ */
+template <typename Type>
+class MappedArray {
+    static_assert(std::is_trivially_copyable_v<Type>, "MappedArray requires a trivially copyable type.");
+
+public:
+    /**
+     * @brief Default constructor. Does not map anything.
+     */
+    MappedArray();
+
+    /**
+     * @brief Maps an existing file. Its size must be a multiple of sizeof(Type).
+     * @param path The path to the file.
+     * @param mode Whether the array can be written to.
+     */
+    explicit MappedArray(const std::filesystem::path& path, MapMode mode = MapMode::ReadOnly);
+
+    /**
+     * @brief Creates a file holding a given number of elements, or truncates an existing one, and
+     * maps it for reading and writing. Elements are zero-filled.
+     * @param path The path to the file.
+     * @param size The number of elements.
+     * @note Throws a std::length_error if the file would be larger than a std::size_t can count.
+     */
+    MappedArray(const std::filesystem::path& path, std::size_t size);
+
+    /**
+     * @brief Access element at 'index'.
+     * @param index The index of the wanted element.
+     * @note No bounds checking. Writing to a read-only array is undefined behavior.
+     * @return A reference to the wanted element.
+     */
+    Type& operator[](std::size_t index);
+
+    /**
+     * @brief Access element at 'index'.
+     * @param index The index of the wanted element.
+     * @note No bounds checking.
+     * @return A const-reference to the wanted element.
+     */
+    const Type& operator[](std::size_t index) const;
+
+    /**
+     * @return Number of elements in the array.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @return A pointer to the first element of the array.
+     * @note Will return nullptr if the array is empty.
+     */
+    Type* get_data();
+
+    /**
+     * @return A const pointer to the first element of the array.
+     * @note Will return nullptr if the array is empty.
+     */
+    const Type* get_data() const;
+
+    /**
+     * @return True if the array has no elements.
+     */
+    bool empty() const;
+
+    /**
+     * @return An iterator to the beginning of the array.
+     */
+    Type* begin();
+
+    /**
+     * @return A const iterator to the beginning of the array.
+     */
+    const Type* begin() const;
+
+    /**
+     * @return An iterator to the element past the end of the array.
+     */
+    Type* end();
+
+    /**
+     * @return A const iterator to the element past the end of the array.
+     */
+    const Type* end() const;
+
+    /**
+     * @brief Fills the array with a value.
+     * @param value The value to fill the array with.
+     * @throw std::logic_error If the array is read-only.
+     */
+    void fill(const Type& value);
+
+    /**
+     * @return Whether the array can be written to.
+     */
+    MapMode get_mode() const;
+
+    /**
+     * @brief Tells the kernel how the array is going to be accessed.
+     * @param advice The expected access pattern.
+     */
+    void advise(MapAdvice advice) const;
+
+    /**
+     * @brief Synchronously writes the modified elements back to the file.
+     */
+    void flush() const;
+
+protected:
+    /**
+     * @param size A number of elements.
+     * @return The number of bytes of that many elements.
+     * @note Throws a std::length_error if it is larger than a std::size_t can count.
+     */
+    static std::size_t byte_size(std::size_t size);
+
+    MappedFile file; ///< The mapping of the file, whose size gives the number of elements.
+};
+
+template <typename Type>
+MappedArray<Type>::MappedArray() : file() { }
+
+template <typename Type>
+MappedArray<Type>::MappedArray(const std::filesystem::path& path, MapMode mode)
+    : file(path, mode) {
+    if(file.get_size() % sizeof(Type) != 0) {
+        throw std::runtime_error("Size of file '" + path.string() + "' isn't a multiple of the element size");
+    }
+}
+
+template <typename Type>
+MappedArray<Type>::MappedArray(const std::filesystem::path& path, std::size_t size)
+    : file(path, byte_size(size)) { }
+
+template <typename Type>
+Type& MappedArray<Type>::operator[](std::size_t index) { return get_data()[index]; }
+
+template <typename Type>
+const Type& MappedArray<Type>::operator[](std::size_t index) const { return get_data()[index]; }
+
+template <typename Type>
+std::size_t MappedArray<Type>::byte_size(std::size_t size) {
+    if(size > std::numeric_limits<std::size_t>::max() / sizeof(Type)) {
+        throw std::length_error("Couldn't map array: too many elements");
+    }
+    return size * sizeof(Type);
+}
+
+template <typename Type>
+std::size_t MappedArray<Type>::get_size() const { return file.get_size() / sizeof(Type); }
+
+template <typename Type>
+Type* MappedArray<Type>::get_data() { return reinterpret_cast<Type*>(file.get_data()); }
+
+template <typename Type>
+const Type* MappedArray<Type>::get_data() const { return reinterpret_cast<const Type*>(file.get_data()); }
+
+template <typename Type>
+bool MappedArray<Type>::empty() const { return get_size() == 0; }
+
+template <typename Type>
+Type* MappedArray<Type>::begin() { return get_data(); }
+
+template <typename Type>
+const Type* MappedArray<Type>::begin() const { return get_data(); }
+
+template <typename Type>
+Type* MappedArray<Type>::end() { return get_data() + get_size(); }
+
+template <typename Type>
+const Type* MappedArray<Type>::end() const { return get_data() + get_size(); }
+
+template <typename Type>
+void MappedArray<Type>::fill(const Type& value) {
+    if(file.get_mode() == MapMode::ReadOnly) { throw std::logic_error("Can't fill a read-only MappedArray"); }
+    std::fill_n(get_data(), get_size(), value);
+}
+
+template <typename Type>
+MapMode MappedArray<Type>::get_mode() const { return file.get_mode(); }
+
+template <typename Type>
+void MappedArray<Type>::advise(MapAdvice advice) const { file.advise(advice); }
+
+template <typename Type>
+void MappedArray<Type>::flush() const { file.flush(); }
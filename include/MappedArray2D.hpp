@@ -0,0 +1,292 @@
+/***************************************************************************************************
+ * @file  MappedArray2D.hpp
+ * @brief Declaration of the MappedArray2D class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <limits>
+#include <stdexcept>
+#include "Array2D.hpp"
+#include "ArrayView.hpp"
+#include "MappedArray.hpp"
+
+/**
+ * @class MappedArray2D
+ * @brief A fixed-size 2D array backed by a memory-mapped file holding the raw elements in row-major
+ * order, without any header or row padding.
+ * @tparam Type The type of the array's data. Must be trivially copyable.
+ */
+template <typename Type>
+class MappedArray2D {
+public:
+    /**
+     * @brief Default constructor. Does not map anything.
+     */
+    MappedArray2D();
+
+    /**
+     * @brief Maps an existing file. Its size must be a multiple of the size of a row.
+     * @param path The path to the file.
+     * @param width The number of columns. The number of rows is deduced from the file's size.
+     * @param mode Whether the array can be written to.
+     */
+    MappedArray2D(const std::filesystem::path& path, std::size_t width, MapMode mode = MapMode::ReadOnly);
+
+    /**
+     * @brief Creates a file holding a given amount of rows and columns, or truncates an existing
+     * one, and maps it for reading and writing. Elements are zero-filled.
+     * @param path The path to the file.
+     * @param height The number of rows.
+     * @param width The number of columns.
+     * @note Throws a std::length_error if the number of elements is larger than a std::size_t can
+     * count.
+     */
+    MappedArray2D(const std::filesystem::path& path, std::size_t height, std::size_t width);
+
+    /**
+     * @brief Access a specific element by its row and column.
+     * @param row The wanted element's row's index.
+     * @param column The wanted element's column's index.
+     * @note No bounds checking. Writing to a read-only array is undefined behavior.
+     * @return A reference to the wanted element.
+     */
+    Type& operator ()(std::size_t row, std::size_t column);
+
+    /**
+     * @brief Access a specific element by its row and column.
+     * @param row The wanted element's row's index.
+     * @param column The wanted element's column's index.
+     * @note No bounds checking.
+     * @return A const-reference to the wanted element.
+     */
+    const Type& operator ()(std::size_t row, std::size_t column) const;
+
+    /**
+     * @brief Access a specific row.
+     * @param row The wanted row's index.
+     * @note No bounds checking.
+     * @return A view over the wanted row.
+     */
+    ArrayView<Type> operator[](std::size_t row);
+
+    /**
+     * @brief Access a specific row.
+     * @param row The wanted row's index.
+     * @note No bounds checking.
+     * @return A read-only view over the wanted row.
+     */
+    ArrayView<const Type> operator[](std::size_t row) const;
+
+    /**
+     * @return Number of rows in the array.
+     */
+    std::size_t get_height() const;
+
+    /**
+     * @return Number of columns in the array.
+     */
+    std::size_t get_width() const;
+
+    /**
+     * @return The distance in elements between the starts of two consecutive rows, which is always
+     * the width since the file has no row padding.
+     */
+    std::size_t get_stride() const;
+
+    /**
+     * @return Total number of elements in the array.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @return A pointer to the first element of the first row.
+     * @note Will return nullptr if the array is empty.
+     */
+    Type* get_data();
+
+    /**
+     * @return A const pointer to the first element of the first row.
+     * @note Will return nullptr if the array is empty.
+     */
+    const Type* get_data() const;
+
+    /**
+     * @return True if the array has no elements.
+     */
+    bool empty() const;
+
+    /**
+     * @return An iterator to the first row of the array.
+     */
+    Array2D<Type>::template RowIterator<Type> begin();
+
+    /**
+     * @return A const iterator to the first row of the array.
+     */
+    Array2D<Type>::template RowIterator<const Type> begin() const;
+
+    /**
+     * @return An iterator to the row past the end of the array.
+     */
+    Array2D<Type>::template RowIterator<Type> end();
+
+    /**
+     * @return A const iterator to the row past the end of the array.
+     */
+    Array2D<Type>::template RowIterator<const Type> end() const;
+
+    /**
+     * @brief Fills the array with a value.
+     * @param value The value to fill the array with.
+     * @throw std::logic_error If the array is read-only.
+     */
+    void fill(const Type& value);
+
+    /**
+     * @return Whether the array can be written to.
+     */
+    MapMode get_mode() const;
+
+    /**
+     * @brief Tells the kernel how the array is going to be accessed.
+     * @param advice The expected access pattern.
+     */
+    void advise(MapAdvice advice) const;
+
+    /**
+     * @brief Synchronously writes the modified elements back to the file.
+     */
+    void flush() const;
+
+protected:
+    /**
+     * @param height A number of rows.
+     * @param width A number of columns.
+     * @return The number of elements of that many rows and columns.
+     * @note Throws a std::length_error if it is larger than a std::size_t can count.
+     */
+    static std::size_t element_count(std::size_t height, std::size_t width);
+
+    std::size_t width;      ///< Number of columns in the array.
+    MappedArray<Type> data; ///< The mapped elements, row after row.
+};
+
+template <typename Type>
+MappedArray2D<Type>::MappedArray2D() : width(0), data() { }
+
+template <typename Type>
+MappedArray2D<Type>::MappedArray2D(const std::filesystem::path& path, std::size_t width, MapMode mode)
+    : width(width), data(path, mode) {
+    if(width == 0 || data.get_size() % width != 0) {
+        throw std::runtime_error("Size of file '" + path.string() + "' isn't a multiple of the row size");
+    }
+}
+
+template <typename Type>
+MappedArray2D<Type>::MappedArray2D(const std::filesystem::path& path, std::size_t height, std::size_t width)
+    : width(width), data(path, element_count(height, width)) { }
+
+template <typename Type>
+std::size_t MappedArray2D<Type>::element_count(std::size_t height, std::size_t width) {
+    if(width != 0 && height > std::numeric_limits<std::size_t>::max() / width) {
+        throw std::length_error("Couldn't map array: too many elements");
+    }
+    return height * width;
+}
+
+template <typename Type>
+Type& MappedArray2D<Type>::operator()(std::size_t row, std::size_t column) {
+    return data[row * width + column];
+}
+
+template <typename Type>
+const Type& MappedArray2D<Type>::operator()(std::size_t row, std::size_t column) const {
+    return data[row * width + column];
+}
+
+template <typename Type>
+ArrayView<Type> MappedArray2D<Type>::operator[](std::size_t row) {
+    return ArrayView<Type>(data.get_data() + row * width, width);
+}
+
+template <typename Type>
+ArrayView<const Type> MappedArray2D<Type>::operator[](std::size_t row) const {
+    return ArrayView<const Type>(data.get_data() + row * width, width);
+}
+
+template <typename Type>
+std::size_t MappedArray2D<Type>::get_height() const {
+    return width == 0 ? 0 : data.get_size() / width;
+}
+
+template <typename Type>
+std::size_t MappedArray2D<Type>::get_width() const {
+    return width;
+}
+
+template <typename Type>
+std::size_t MappedArray2D<Type>::get_stride() const {
+    return width;
+}
+
+template <typename Type>
+std::size_t MappedArray2D<Type>::get_size() const {
+    return data.get_size();
+}
+
+template <typename Type>
+Type* MappedArray2D<Type>::get_data() {
+    return data.get_data();
+}
+
+template <typename Type>
+const Type* MappedArray2D<Type>::get_data() const {
+    return data.get_data();
+}
+
+template <typename Type>
+bool MappedArray2D<Type>::empty() const {
+    return data.empty();
+}
+
+template <typename Type>
+Array2D<Type>::template RowIterator<Type> MappedArray2D<Type>::begin() {
+    return typename Array2D<Type>::template RowIterator<Type>(data.begin(), width, width);
+}
+
+template <typename Type>
+Array2D<Type>::template RowIterator<const Type> MappedArray2D<Type>::begin() const {
+    return typename Array2D<Type>::template RowIterator<const Type>(data.begin(), width, width);
+}
+
+template <typename Type>
+Array2D<Type>::template RowIterator<Type> MappedArray2D<Type>::end() {
+    return typename Array2D<Type>::template RowIterator<Type>(data.end(), width, width);
+}
+
+template <typename Type>
+Array2D<Type>::template RowIterator<const Type> MappedArray2D<Type>::end() const {
+    return typename Array2D<Type>::template RowIterator<const Type>(data.end(), width, width);
+}
+
+template <typename Type>
+void MappedArray2D<Type>::fill(const Type& value) {
+    data.fill(value);
+}
+
+template <typename Type>
+MapMode MappedArray2D<Type>::get_mode() const {
+    return data.get_mode();
+}
+
+template <typename Type>
+void MappedArray2D<Type>::advise(MapAdvice advice) const {
+    data.advise(advice);
+}
+
+template <typename Type>
+void MappedArray2D<Type>::flush() const {
+    data.flush();
+}
@@ -0,0 +1,130 @@
+/***************************************************************************************************
+ * @file  MappedFile.hpp
+ * @brief Declaration of the MappedFile class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+
+/**
+ * @enum MapMode
+ * @brief Access rights of a memory-mapped file.
+ */
+enum class MapMode {
+    ReadOnly, ///< The mapping can only be read. Writing to it is undefined behavior.
+    ReadWrite ///< The mapping can be read and written, writes go to the file.
+};
+
+/**
+ * @enum MapAdvice
+ * @brief Hints about how a memory-mapped file is going to be accessed (see madvise).
+ */
+enum class MapAdvice {
+    Normal,     ///< No particular access pattern.
+    Sequential, ///< Pages will be accessed in order, read ahead aggressively.
+    Random,     ///< Pages will be accessed randomly, don't read ahead.
+    WillNeed,   ///< The whole mapping will be needed soon, start loading it.
+    DontNeed    ///< The mapping won't be needed soon, its pages can be dropped.
+};
+
+/**
+ * @class MappedFile
+ * @brief Owns a shared memory mapping of a whole file. The pages are loaded lazily by the kernel
+ * and shared with every other process mapping the same file.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Default constructor. Does not map anything.
+     */
+    MappedFile();
+
+    /**
+     * @brief Maps an existing file.
+     * @param path The path to the file.
+     * @param mode Whether the mapping can be written to.
+     */
+    MappedFile(const std::filesystem::path& path, MapMode mode);
+
+    /**
+     * @brief Creates a file of a given size, or truncates an existing one, and maps it for reading
+     * and writing. The file's content is zero-filled.
+     * @param path The path to the file.
+     * @param size The size of the file in bytes.
+     */
+    MappedFile(const std::filesystem::path& path, std::size_t size);
+
+    /**
+     * @brief Move constructor. Steals the other file's mapping, leaving it empty.
+     * @param other The mapped file to move from.
+     */
+    MappedFile(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile& other) = delete;
+
+    /**
+     * @brief Destructor. Unmaps the file. Written pages are flushed by the kernel eventually.
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Move assignment operator. Unmaps the current file and steals the other's mapping.
+     * @param other The mapped file to move from.
+     * @return A reference to the mapped file.
+     */
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile& operator=(const MappedFile& other) = delete;
+
+    /**
+     * @return A pointer to the first byte of the mapping, or nullptr if nothing is mapped.
+     */
+    std::byte* get_data() const;
+
+    /**
+     * @return The size of the mapping in bytes.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @return The access rights of the mapping.
+     */
+    MapMode get_mode() const;
+
+    /**
+     * @brief Tells the kernel how the mapping is going to be accessed.
+     * @param advice The expected access pattern.
+     */
+    void advise(MapAdvice advice) const;
+
+    /**
+     * @brief Tells the kernel how a range of the mapping is going to be accessed. The range is shrunk
+     * to whole pages, so that DontNeed never drops bytes outside of it.
+     * @param advice The expected access pattern.
+     * @param offset The offset in bytes of the range.
+     * @param size The size in bytes of the range.
+     */
+    void advise(MapAdvice advice, std::size_t offset, std::size_t size) const;
+
+    /**
+     * @return The size in bytes of the pages of mappings.
+     */
+    static std::size_t get_page_size();
+
+    /**
+     * @brief Synchronously writes the modified pages back to the file.
+     */
+    void flush() const;
+
+private:
+    /**
+     * @brief Unmaps the file, if any.
+     */
+    void unmap();
+
+    std::byte* data;  ///< Pointer to the first byte of the mapping.
+    std::size_t size; ///< Size of the mapping in bytes.
+    MapMode mode;     ///< Access rights of the mapping.
+};
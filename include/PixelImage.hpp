@@ -0,0 +1,150 @@
+/***************************************************************************************************
+ * @file  PixelImage.hpp
+ * @brief Declaration of the PixelImage class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <filesystem>
+#include <type_traits>
+#include <utility>
+#include "Array2D.hpp"
+#include "Array2DView.hpp"
+#include "Image.hpp"
+#include "image_io.hpp"
+#include "pixel.hpp"
+#include "pixel_conversion.hpp"
+
+/**
+ * @brief The pixel format of the elements of a 2D container.
+ * @tparam Container The type of the container.
+ */
+template <typename Container>
+using PixelOf = std::remove_cvref_t<decltype(*std::declval<Container&>().get_data())>;
+
+/**
+ * @class PixelImage
+ * @brief A 2D image storing its pixels in a specific format, e.g. RGB8 to use 3 bytes per pixel
+ * instead of the 12 of Image.
+ *
+ * Jobs that only crop, composite or re-encode images can stay in their compact format end to end,
+ * and convert from or to another format, or to an Image, only at the edges. Integer channels span
+ * their whole range and float channels span [0 ; 1].
+ *
+ * Like any Array2D, the pixels can be allocated from a specific std::pmr::memory_resource.
+ *
+ * @tparam Pixel The pixel format: RGB8, RGBA8, RGB16 or RGB32F.
+ */
+template <PixelFormat Pixel>
+class PixelImage : public Array2D<Pixel> {
+public:
+    using Array2D<Pixel>::Array2D; // Inheriting constructors.
+
+    /**
+     * @brief Construct an image by loading it from a file.
+     * @param path The path to the input image file.
+     * @param flip_vertically Whether to flip the image vertically on load.
+     * @param resource The memory resource to allocate the pixels from.
+     */
+    explicit PixelImage(const std::filesystem::path& path, bool flip_vertically = false,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Constructs an image by converting the pixels of another image, of any format.
+     * @param source The image to convert: a PixelImage, an Image or a view of either.
+     * @param resource The memory resource to allocate the pixels from.
+     */
+    template <typename Container>
+        requires PixelFormat<PixelOf<const Container>> && StridedContainerOf<const Container, const PixelOf<const Container>>
+    explicit PixelImage(const Container& source,
+                        std::pmr::memory_resource* resource = std::pmr::get_default_resource());
+
+    /**
+     * @brief Loads an image from a file. The pixels are allocated from the image's resource.
+     * @param path The path to the input image file.
+     * @param flip_vertically Whether to flip the image vertically on load.
+     */
+    void read(const std::filesystem::path& path, bool flip_vertically = false);
+
+    /**
+     * @brief Writes an image to a file, in the format matching its extension (see ImageFormat).
+     * 16-bit pixels are converted to the 8-bit or float channels of the format.
+     * @param path The path to the output image file.
+     * @param options How to encode the file, e.g. the quality of JPG files.
+     * @note Throws a std::runtime_error if the extension is not a supported format.
+     */
+    void write(const std::filesystem::path& path, const ImageWriteOptions& options = {}) const;
+
+    /**
+     * @return A copy of the image converted to another pixel format.
+     * @tparam Other The pixel format to convert to.
+     */
+    template <PixelFormat Other>
+    PixelImage<Other> convert() const;
+
+    /**
+     * @return A copy of the image converted to a floating-point Image.
+     */
+    Image to_image() const;
+
+private:
+    bool is_flipped = false; ///< Whether the image was flipped on load (and thus needs to be flipped on write).
+};
+
+extern template class PixelImage<RGB8>;
+extern template class PixelImage<RGBA8>;
+extern template class PixelImage<RGB16>;
+extern template class PixelImage<RGB32F>;
+
+/**
+ * @brief Converts the pixels of a 2D container into another one of the same size. Conversions
+ * between RGB8 and RGB32F are vectorized.
+ * @param source The pixels to convert.
+ * @param destination The converted pixels.
+ */
+template <PixelFormat To, PixelFormat From>
+void convert_pixels(Array2DView<const From> source, Array2DView<To> destination) {
+    for(std::size_t i = 0 ; i < source.get_height() ; ++i) {
+        const From* source_row = source.get_data() + i * source.get_stride();
+        To* destination_row = destination.get_data() + i * destination.get_stride();
+
+        if constexpr(std::is_same_v<From, RGB8> && std::is_same_v<To, RGB32F>) {
+            unorm8_to_float_n(&source_row->r, &destination_row->x, source.get_width() * 3);
+        } else if constexpr(std::is_same_v<From, RGB32F> && std::is_same_v<To, RGB8>) {
+            float_to_unorm8_n(&source_row->x, &destination_row->r, source.get_width() * 3);
+        } else {
+            for(std::size_t j = 0 ; j < source.get_width() ; ++j) {
+                destination_row[j] = convert_pixel<To>(source_row[j]);
+            }
+        }
+    }
+}
+
+template <PixelFormat Pixel>
+PixelImage<Pixel>::PixelImage(const std::filesystem::path& path, bool flip_vertically,
+                              std::pmr::memory_resource* resource)
+    : Array2D<Pixel>(resource) {
+    read(path, flip_vertically);
+}
+
+template <PixelFormat Pixel>
+template <typename Container>
+    requires PixelFormat<PixelOf<const Container>> && StridedContainerOf<const Container, const PixelOf<const Container>>
+PixelImage<Pixel>::PixelImage(const Container& source, std::pmr::memory_resource* resource)
+    : Array2D<Pixel>(source.get_height(), source.get_width(), uninitialized, resource) {
+    convert_pixels(Array2DView<const PixelOf<const Container>>(source), Array2DView<Pixel>(*this));
+}
+
+template <PixelFormat Pixel>
+template <PixelFormat Other>
+PixelImage<Other> PixelImage<Pixel>::convert() const {
+    return PixelImage<Other>(*this, this->get_resource());
+}
+
+template <PixelFormat Pixel>
+Image PixelImage<Pixel>::to_image() const {
+    Image image(this->height, this->width, uninitialized, this->get_resource());
+    convert_pixels(Array2DView<const Pixel>(*this), Array2DView<vec3>(image));
+
+    return image;
+}
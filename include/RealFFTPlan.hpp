@@ -0,0 +1,70 @@
+/***************************************************************************************************
+ * @file  RealFFTPlan.hpp
+ * @brief Declaration of the RealFFTPlan class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include "Array.hpp"
+#include "FFTPlan.hpp"
+
+/**
+ * @class RealFFTPlan
+ * @brief The discrete Fourier transforms of real sequences of a given size, whose spectra are
+ * Hermitian: only their first size / 2 + 1 elements are computed, the others being the conjugates of
+ * these.
+ *
+ * Even sizes are transformed as complex sequences of half the size, whose elements are pairs of real
+ * elements, which halves the work. Odd sizes are transformed as complex sequences of the same size.
+ * Like FFTPlan, transforms aren't normalized, plans are immutable and get() shares them through a
+ * cache.
+ */
+class RealFFTPlan {
+public:
+    /**
+     * @brief Constructor. Plans the complex transforms and computes the twiddle factors.
+     * @param size The number of elements of the real sequences, at least 1.
+     */
+    explicit RealFFTPlan(std::size_t size);
+
+    /**
+     * @param size The number of elements of the real sequences, at least 1.
+     * @return The plan of that size, built on the first call and cached for the following ones.
+     * @note Thread-safe.
+     */
+    static std::shared_ptr<const RealFFTPlan> get(std::size_t size);
+
+    /**
+     * @brief Computes the spectrum of a real sequence.
+     * @param input The sequence, 'size' elements.
+     * @param output The first 'size / 2 + 1' elements of its spectrum.
+     * @param scratch A buffer of get_scratch_size() elements, overwritten.
+     */
+    void forward(const float* input, std::complex<float>* output, std::complex<float>* scratch) const;
+
+    /**
+     * @brief Computes the real sequence of a Hermitian spectrum, multiplied by the size.
+     * @param input The first 'size / 2 + 1' elements of the spectrum.
+     * @param output The sequence, 'size' elements.
+     * @param scratch A buffer of get_scratch_size() elements, overwritten.
+     */
+    void inverse(const std::complex<float>* input, float* output, std::complex<float>* scratch) const;
+
+    /**
+     * @return The number of elements of the real sequences.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @return The number of elements of the scratch buffers of the transforms.
+     */
+    std::size_t get_scratch_size() const;
+
+private:
+    std::size_t size;                    ///< The number of elements of the real sequences.
+    std::shared_ptr<const FFTPlan> plan; ///< The plan of the complex transforms.
+    Array<std::complex<float>> twiddles; ///< e^(-2 pi i k / size) for k in [0 ; size / 2), for even sizes.
+};
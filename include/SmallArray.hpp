@@ -0,0 +1,473 @@
+/***************************************************************************************************
+ * @file  SmallArray.hpp
+ * @brief Declaration of the SmallArray class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/**
+ * @class SmallArray
+ * @brief A dynamic array with the interface of Array that stores up to 'N' elements inline, inside
+ * the object itself, and only allocates heap memory once it grows past that.
+ *
+ * Short-lived arrays that stay small therefore never touch the heap.
+ *
+ * @tparam Type The type of the array's data.
+ * @tparam N The number of elements stored inline.
+ */
+template <typename Type, std::size_t N>
+class SmallArray {
+    static_assert(N > 0, "SmallArray needs room for at least one inline element.");
+
+public:
+    /**
+     * @brief Default constructor. Does not allocate any data.
+     */
+    SmallArray();
+
+    /**
+     * @brief Constructs an array with a given size. Elements are default-initialized (Type()).
+     * @param size The number of elements.
+     */
+    explicit SmallArray(std::size_t size);
+
+    /**
+     * @brief Constructs an array with a given size. Elements are initialized with a specified value.
+     * @param size The number of elements.
+     * @param default_value The value to fill the array with.
+     */
+    SmallArray(std::size_t size, const Type& default_value);
+
+    /**
+     * @brief Constructs an array from an initializer_list.
+     * @param values The values to fill the array with.
+     */
+    SmallArray(const std::initializer_list<Type>& values);
+
+    /**
+     * @brief Copy constructor. Performs a deep copy.
+     * @param other The array to copy.
+     */
+    SmallArray(const SmallArray& other);
+
+    /**
+     * @brief Move constructor. Steals the other array's heap data, or moves its inline elements one
+     * by one, leaving it empty.
+     * @param other The array to move from.
+     */
+    SmallArray(SmallArray&& other) noexcept(std::is_nothrow_move_constructible_v<Type>);
+
+    /**
+     * @brief Destructor. Releases allocated memory.
+     */
+    ~SmallArray();
+
+    /**
+     * @brief Copy assignment operator. Performs a deep copy.
+     * @param other The array to copy.
+     * @return A reference to the array.
+     */
+    SmallArray& operator=(const SmallArray& other);
+
+    /**
+     * @brief Move assignment operator. Steals the other array's heap data, or moves its inline
+     * elements one by one, leaving it empty.
+     * @param other The array to move from.
+     * @return A reference to the array.
+     */
+    SmallArray& operator=(SmallArray&& other) noexcept(std::is_nothrow_move_constructible_v<Type>);
+
+    /**
+     * @brief Access element at 'index'.
+     * @param index The index of the wanted element.
+     * @note No bounds checking.
+     * @return A reference to the wanted element.
+     */
+    Type& operator[](std::size_t index);
+
+    /**
+     * @brief Access element at 'index'.
+     * @param index The index of the wanted element.
+     * @note No bounds checking.
+     * @return A const-reference to the wanted element.
+     */
+    const Type& operator[](std::size_t index) const;
+
+    /**
+     * @return Current number of elements in the array.
+     */
+    std::size_t get_size() const;
+
+    /**
+     * @return Number of elements the array can hold before having to reallocate.
+     */
+    std::size_t get_capacity() const;
+
+    /**
+     * @return Whether the elements are stored inline, i.e. the array doesn't own any heap memory.
+     */
+    bool is_inline() const;
+
+    /**
+     * @return A pointer to the first element in the internal array.
+     */
+    Type* get_data();
+
+    /**
+     * @return A const pointer to the first element in the internal array.
+     */
+    const Type* get_data() const;
+
+    /**
+     * @return True if the array has no elements.
+     */
+    bool empty() const;
+
+    /**
+     * @return An iterator to the beginning of the array.
+     */
+    Type* begin();
+
+    /**
+     * @return A const iterator to the beginning of the array.
+     */
+    const Type* begin() const;
+
+    /**
+     * @return An iterator to the element past the end of the array.
+     */
+    Type* end();
+
+    /**
+     * @return A const iterator to the element past the end of the array.
+     */
+    const Type* end() const;
+
+    /**
+     * @brief Resizes the array. If expanded, new elements are default-constructed. If shrunk,
+     * extra elements are discarded.
+     * @param new_size The new size of the array.
+     */
+    void resize(std::size_t new_size);
+
+    /**
+     * @brief Fills the array with a value.
+     * @param value The value to fill the array with.
+     */
+    void fill(const Type& value);
+
+    /**
+     * @brief Assigns new content to the array, replacing its contents and modifying its size
+     * accordingly.
+     * @param new_size The new size of the array.
+     * @param value The value to fill the array with.
+     */
+    void assign(std::size_t new_size, const Type& value);
+
+    /**
+     * @brief Makes sure the array can hold at least 'new_capacity' elements without reallocating.
+     * Does nothing if the capacity is already large enough.
+     * @param new_capacity The minimum wanted capacity.
+     */
+    void reserve(std::size_t new_capacity);
+
+    /**
+     * @brief Appends a copy of a value at the end of the array.
+     * @param value The value to append.
+     */
+    void push_back(const Type& value);
+
+    /**
+     * @brief Appends a value at the end of the array by moving it.
+     * @param value The value to append.
+     */
+    void push_back(Type&& value);
+
+    /**
+     * @brief Appends a value constructed from 'args' at the end of the array.
+     * @param args The arguments to construct the value with.
+     * @return A reference to the appended element.
+     */
+    template <typename... Args>
+    Type& emplace_back(Args&&... args);
+
+private:
+    /**
+     * @return A pointer to the inline storage.
+     */
+    Type* inline_data();
+
+    /**
+     * @brief Destroys the elements in [new_size ; size) and sets the size to 'new_size'.
+     * @param new_size The new size of the array. Must be at most 'size'.
+     */
+    void destroy_from(std::size_t new_size);
+
+    /**
+     * @brief Destroys all the elements and releases the heap memory, if any, going back to the
+     * empty inline state.
+     */
+    void reset();
+
+    /**
+     * @brief Takes the content of another array, which must be empty or reset beforehand.
+     * @param other The array to move from. Left empty.
+     */
+    void take(SmallArray& other) noexcept(std::is_nothrow_move_constructible_v<Type>);
+
+    /**
+     * @brief Moves the elements to a new heap buffer able to hold 'new_capacity' elements.
+     * @param new_capacity The capacity of the new buffer. Must be greater than N and 'size'.
+     */
+    void reallocate(std::size_t new_capacity);
+
+    std::size_t size;     ///< Number of elements in the array.
+    std::size_t capacity; ///< Number of elements the current storage can hold, N while inline.
+    Type* data;           ///< Pointer to the inline storage or to heap-allocated data.
+
+    alignas(Type) std::byte storage[N * sizeof(Type)]; ///< Inline storage for up to N elements.
+};
+
+/**
+ * @brief Outputs an array to an output stream.
+ * @param stream The stream to output to.
+ * @param array The array to output.
+ * @return A reference to the stream.
+ */
+template <typename Type, std::size_t N>
+std::ostream& operator <<(std::ostream& stream, const SmallArray<Type, N>& array) {
+    stream << '(';
+    for(const Type& element : array) {
+        stream << element;
+        if(&element < array.end() - 1) { stream << ", "; }
+    }
+    stream << ')';
+
+    return stream;
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>::SmallArray() : size(0), capacity(N), data(inline_data()) { }
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>::SmallArray(std::size_t size) : SmallArray() {
+    resize(size);
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>::SmallArray(std::size_t size, const Type& default_value) : SmallArray() {
+    assign(size, default_value);
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>::SmallArray(const std::initializer_list<Type>& values) : SmallArray() {
+    reserve(values.size());
+    for(const Type& value : values) { emplace_back(value); }
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>::SmallArray(const SmallArray& other) : SmallArray() {
+    reserve(other.size);
+    for(const Type& value : other) { emplace_back(value); }
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>::SmallArray(SmallArray&& other) noexcept(std::is_nothrow_move_constructible_v<Type>)
+    : SmallArray() {
+    take(other);
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>::~SmallArray() {
+    reset();
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>& SmallArray<Type, N>::operator=(const SmallArray& other) {
+    if(this == &other) { return *this; }
+
+    destroy_from(0);
+    reserve(other.size);
+    for(const Type& value : other) { emplace_back(value); }
+
+    return *this;
+}
+
+template <typename Type, std::size_t N>
+SmallArray<Type, N>& SmallArray<Type, N>::operator=(SmallArray&& other)
+    noexcept(std::is_nothrow_move_constructible_v<Type>) {
+    if(this == &other) { return *this; }
+
+    reset();
+    take(other);
+
+    return *this;
+}
+
+template <typename Type, std::size_t N>
+Type& SmallArray<Type, N>::operator[](std::size_t index) { return data[index]; }
+
+template <typename Type, std::size_t N>
+const Type& SmallArray<Type, N>::operator[](std::size_t index) const { return data[index]; }
+
+template <typename Type, std::size_t N>
+std::size_t SmallArray<Type, N>::get_size() const { return size; }
+
+template <typename Type, std::size_t N>
+std::size_t SmallArray<Type, N>::get_capacity() const { return capacity; }
+
+template <typename Type, std::size_t N>
+bool SmallArray<Type, N>::is_inline() const { return capacity == N; }
+
+template <typename Type, std::size_t N>
+Type* SmallArray<Type, N>::get_data() { return data; }
+
+template <typename Type, std::size_t N>
+const Type* SmallArray<Type, N>::get_data() const { return data; }
+
+template <typename Type, std::size_t N>
+bool SmallArray<Type, N>::empty() const { return size == 0; }
+
+template <typename Type, std::size_t N>
+Type* SmallArray<Type, N>::begin() { return data; }
+
+template <typename Type, std::size_t N>
+const Type* SmallArray<Type, N>::begin() const { return data; }
+
+template <typename Type, std::size_t N>
+Type* SmallArray<Type, N>::end() { return data + size; }
+
+template <typename Type, std::size_t N>
+const Type* SmallArray<Type, N>::end() const { return data + size; }
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::resize(std::size_t new_size) {
+    if(new_size <= size) {
+        destroy_from(new_size);
+        return;
+    }
+
+    if(new_size > capacity) { reallocate(std::max(new_size, 2 * capacity)); }
+    std::uninitialized_value_construct_n(data + size, new_size - size);
+    size = new_size;
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::fill(const Type& value) {
+    std::fill_n(data, size, value);
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::assign(std::size_t new_size, const Type& value) {
+    if(new_size > capacity) {
+        // The old content is discarded, so there is nothing to relocate.
+        destroy_from(0);
+        reallocate(new_size);
+    }
+
+    if(new_size > size) {
+        std::fill_n(data, size, value);
+        std::uninitialized_fill_n(data + size, new_size - size, value);
+        size = new_size;
+    } else {
+        std::fill_n(data, new_size, value);
+        destroy_from(new_size);
+    }
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::reserve(std::size_t new_capacity) {
+    if(new_capacity > capacity) { reallocate(new_capacity); }
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::push_back(const Type& value) {
+    emplace_back(value);
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::push_back(Type&& value) {
+    emplace_back(std::move(value));
+}
+
+template <typename Type, std::size_t N>
+template <typename... Args>
+Type& SmallArray<Type, N>::emplace_back(Args&&... args) {
+    if(size == capacity) {
+        // 'args' may refer to elements of this array, so build the value before reallocating.
+        Type value(std::forward<Args>(args)...);
+        reallocate(2 * capacity);
+        std::construct_at(data + size, std::move(value));
+    } else {
+        std::construct_at(data + size, std::forward<Args>(args)...);
+    }
+
+    return data[size++];
+}
+
+template <typename Type, std::size_t N>
+Type* SmallArray<Type, N>::inline_data() {
+    return reinterpret_cast<Type*>(storage);
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::destroy_from(std::size_t new_size) {
+    std::destroy_n(data + new_size, size - new_size);
+    size = new_size;
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::reset() {
+    destroy_from(0);
+    if(!is_inline()) { ::operator delete(data, std::align_val_t(alignof(Type))); }
+    capacity = N;
+    data = inline_data();
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::take(SmallArray& other) noexcept(std::is_nothrow_move_constructible_v<Type>) {
+    if(other.is_inline()) {
+        std::uninitialized_move_n(other.data, other.size, data);
+        size = other.size;
+        other.destroy_from(0);
+    } else {
+        size = std::exchange(other.size, 0);
+        capacity = std::exchange(other.capacity, N);
+        data = std::exchange(other.data, other.inline_data());
+    }
+}
+
+template <typename Type, std::size_t N>
+void SmallArray<Type, N>::reallocate(std::size_t new_capacity) {
+    Type* new_data = static_cast<Type*>(::operator new(new_capacity * sizeof(Type), std::align_val_t(alignof(Type))));
+
+    if constexpr(std::is_trivially_copyable_v<Type>) {
+        if(size > 0) { std::memcpy(new_data, data, size * sizeof(Type)); }
+    } else {
+        try {
+            if constexpr(std::is_nothrow_move_constructible_v<Type>) {
+                std::uninitialized_move_n(data, size, new_data);
+            } else {
+                std::uninitialized_copy_n(data, size, new_data);
+            }
+        } catch(...) {
+            ::operator delete(new_data, std::align_val_t(alignof(Type)));
+            throw;
+        }
+        std::destroy_n(data, size);
+    }
+
+    if(!is_inline()) { ::operator delete(data, std::align_val_t(alignof(Type))); }
+    data = new_data;
+    capacity = new_capacity;
+}
@@ -0,0 +1,144 @@
+/***************************************************************************************************
+ * @file  ThreadPool.hpp
+ * @brief Declaration of the ThreadPool class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @class ThreadPool
+ * @brief A reusable pool of threads running fork-join parallel loops with work stealing.
+ *
+ * Every thread owns a deque of tasks: it pushes and pops its own tasks at the back, while idle
+ * threads steal from the front of the others' deques, which hold the largest pieces of work. The
+ * thread waiting for a loop to finish runs tasks too, so a pool of N threads starts N - 1 workers,
+ * and loops can be nested.
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Creates a pool computing with a given number of threads, the calling one included.
+     * @param thread_count The number of threads. A pool of 1 thread runs everything on the caller.
+     */
+    explicit ThreadPool(std::size_t thread_count = default_thread_count());
+
+    ThreadPool(const ThreadPool& other) = delete;
+
+    /**
+     * @brief Destructor. Stops and joins the workers.
+     */
+    ~ThreadPool();
+
+    ThreadPool& operator=(const ThreadPool& other) = delete;
+
+    /**
+     * @return The number of threads computing, the calling one included.
+     */
+    std::size_t get_thread_count() const;
+
+    /**
+     * @brief Calls 'function(chunk_begin, chunk_end)' on chunks covering [begin ; end) in parallel
+     * and waits for all of them. The range is split in halves until chunks are at most 'grain' long.
+     * @param begin The first index.
+     * @param end The index past the last one.
+     * @param grain The maximum length of a chunk.
+     * @param function The function to call on each chunk.
+     * @note If calls throw, the first exception is rethrown once all chunks are done.
+     */
+    template <typename Function>
+    void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Function&& function);
+
+    /**
+     * @return The pool shared by the whole program, with one thread per hardware thread.
+     */
+    static ThreadPool& get_global();
+
+    /**
+     * @return The number of hardware threads, at least 1.
+     */
+    static std::size_t default_thread_count();
+
+private:
+    /// Type-erased function called on a chunk.
+    using ChunkFunction = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    /**
+     * @struct Loop
+     * @brief The shared state of a running parallel_for.
+     */
+    struct Loop;
+
+    /**
+     * @struct Worker
+     * @brief The deque of tasks of one thread.
+     */
+    struct Worker {
+        std::mutex mutex;                        ///< Protects the tasks.
+        std::deque<std::function<void()>> tasks; ///< The tasks, the newest at the back.
+    };
+
+    /**
+     * @brief Runs a parallel loop and waits for it. See parallel_for.
+     */
+    void run_loop(std::size_t begin, std::size_t end, std::size_t grain, ChunkFunction function, void* context);
+
+    /**
+     * @brief Splits a range in halves, pushing the upper halves as tasks, then runs the remaining
+     * chunk.
+     * @param loop The loop the range belongs to.
+     * @param begin The first index.
+     * @param end The index past the last one.
+     */
+    void split(Loop& loop, std::size_t begin, std::size_t end);
+
+    /**
+     * @brief Pushes a task at the back of the calling thread's deque and wakes a worker up.
+     * @param task The task.
+     */
+    void push(std::function<void()> task);
+
+    /**
+     * @brief Runs one task, taken from the calling thread's deque or stolen from another one.
+     * @return Whether a task was run.
+     */
+    bool try_run_one();
+
+    /**
+     * @return The index of the calling thread's deque. Threads outside the pool share deque 0.
+     */
+    std::size_t current_index() const;
+
+    /**
+     * @brief The loop of the worker threads: runs tasks, sleeping while there are none.
+     * @param index The index of the worker's deque.
+     */
+    void work(std::size_t index);
+
+    std::vector<std::unique_ptr<Worker>> workers; ///< One deque per thread.
+    std::vector<std::thread> threads;             ///< The worker threads.
+
+    std::atomic<std::size_t> pending;  ///< Number of tasks waiting in the deques.
+    std::atomic<bool> stopping;        ///< Whether the workers must exit.
+    std::mutex sleep_mutex;            ///< Mutex of the sleeping workers' condition variable.
+    std::condition_variable wake_up;   ///< Wakes sleeping workers up when tasks are pushed.
+};
+
+template <typename Function>
+void ThreadPool::parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Function&& function) {
+    using FunctionType = std::remove_reference_t<Function>;
+
+    run_loop(begin, end, grain, [](void* context, std::size_t chunk_begin, std::size_t chunk_end) {
+        (*static_cast<FunctionType*>(context))(chunk_begin, chunk_end);
+    }, const_cast<void*>(static_cast<const void*>(&function)));
+}
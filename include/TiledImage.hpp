@@ -0,0 +1,268 @@
+/***************************************************************************************************
+ * @file  TiledImage.hpp
+ * @brief Declaration of the TiledImage class
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <list>
+#include <mutex>
+#include <vector>
+#include "Array2DView.hpp"
+#include "image_io.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
+#include "vec.hpp"
+
+/**
+ * @struct TiledImageOptions
+ * @brief How a TiledImage stores its tiles.
+ */
+struct TiledImageOptions {
+    std::size_t tile_size = 256;             ///< The number of rows and columns of a tile.
+    std::size_t max_resident_tiles = 64;     ///< The number of tiles kept in memory.
+    std::filesystem::path scratch_directory; ///< Where to create the scratch file, the temporary directory if empty.
+};
+
+/**
+ * @class TiledImage
+ * @brief A 2D floating-point RGB image too large to be held in memory, split in square tiles that
+ * are spilled to a scratch file.
+ *
+ * The tiles are stored one after the other in a memory-mapped scratch file, which is deleted as soon
+ * as it is created, so that it goes away with the image even if the program crashes. Each tile
+ * starts on a page boundary, so the pages of a tile can be dropped from memory without touching its
+ * neighbours. Only a bounded working set of tiles is kept in memory: accessing a tile pins it, and
+ * once more than 'max_resident_tiles' tiles were accessed, the least recently used unpinned one is
+ * dropped, its modified pages being written back to the scratch file by the kernel. Tiles that are
+ * pinned are never dropped, so the working set only exceeds its bound while more tiles than that are
+ * pinned at once.
+ *
+ * The scratch file should live on a disk rather than on a memory-backed file system such as tmpfs,
+ * or the spilled tiles still end up in memory or swap.
+ *
+ * Pixels are accessed by tiles, with for_each_tile, or by regions, with read_region and
+ * write_region. PPM and PFM files are read and written band by band, without ever holding the whole
+ * image. Other formats go through a whole Image.
+ */
+class TiledImage {
+public:
+    /**
+     * @brief Creates an image whose pixels are all black.
+     * @param height The number of rows.
+     * @param width The number of columns.
+     * @param options How to store the tiles.
+     * @note Throws a std::runtime_error if the scratch file can't be created.
+     */
+    TiledImage(std::size_t height, std::size_t width, const TiledImageOptions& options = {});
+
+    /**
+     * @brief Loads an image from a file. PPM (8-bit) and PFM files are read band by band, other
+     * formats are decoded whole first.
+     * @param path The path to the input image file.
+     * @param color_space The color space of the file's 8-bit values. Float formats (HDR, PFM) are
+     * read as they are.
+     * @param options How to store the tiles.
+     * @note Throws a std::runtime_error if the file can't be read or the scratch file created.
+     */
+    explicit TiledImage(const std::filesystem::path& path, ColorSpace color_space = ColorSpace::Linear,
+                        const TiledImageOptions& options = {});
+
+    TiledImage(const TiledImage& other) = delete;
+
+    TiledImage& operator=(const TiledImage& other) = delete;
+
+    /**
+     * @brief Calls 'function(tile, row, column)' on every tile in parallel, with a view over the
+     * tile's pixels and the row and column of its first pixel. Tiles of the last row and column are
+     * cropped to the image. The tile is pinned during the call.
+     * @param function The function to call on each tile.
+     * @param pool The pool to run the calls on.
+     * @note Calls can read other tiles with read_region, which pins them one at a time. Since other
+     * calls may be modifying them, filters needing neighbouring pixels should read from another
+     * image, e.g. through the const overload, and write to this one.
+     */
+    template <typename Function>
+    void for_each_tile(Function&& function, ThreadPool& pool = ThreadPool::get_global());
+
+    /**
+     * @brief Calls 'function(tile, row, column)' on every tile in parallel, with a read-only view over
+     * the tile's pixels and the row and column of its first pixel. See the non-const overload.
+     * @param function The function to call on each tile.
+     * @param pool The pool to run the calls on.
+     */
+    template <typename Function>
+    void for_each_tile(Function&& function, ThreadPool& pool = ThreadPool::get_global()) const;
+
+    /**
+     * @brief Copies a region of the image, which may extend past its borders, whose pixels are then
+     * clamped to the closest edge pixel, e.g. to read a tile with the apron a filter needs.
+     * @param row The row of the first pixel of the region, possibly negative.
+     * @param column The column of the first pixel of the region, possibly negative.
+     * @param destination The view to copy the region to, whose dimensions are the region's.
+     * @note Throws a std::out_of_range if the image is empty and the region isn't.
+     */
+    void read_region(std::ptrdiff_t row, std::ptrdiff_t column, Array2DView<vec3> destination) const;
+
+    /**
+     * @brief Copies pixels to a region of the image.
+     * @param row The row of the first pixel of the region.
+     * @param column The column of the first pixel of the region.
+     * @param source The pixels to copy, whose dimensions are the region's.
+     * @note Throws a std::out_of_range if the region doesn't fit in the image.
+     */
+    void write_region(std::size_t row, std::size_t column, Array2DView<const vec3> source);
+
+    /**
+     * @brief Writes the image to a file, in the format matching its extension (see ImageFormat).
+     * PPM and PFM files are written band by band, other formats from a whole Image.
+     * @param path The path to the output image file.
+     * @param options How to encode the file.
+     * @note Throws a std::runtime_error if the extension is not a supported format or the file can't
+     * be written.
+     */
+    void write(const std::filesystem::path& path, const ImageWriteOptions& options = {}) const;
+
+    /**
+     * @return Number of rows in the image.
+     */
+    std::size_t get_height() const;
+
+    /**
+     * @return Number of columns in the image.
+     */
+    std::size_t get_width() const;
+
+    /**
+     * @return Number of rows and columns of a tile.
+     */
+    std::size_t get_tile_size() const;
+
+    /**
+     * @return Number of rows of tiles.
+     */
+    std::size_t get_tile_rows() const;
+
+    /**
+     * @return Number of columns of tiles.
+     */
+    std::size_t get_tile_columns() const;
+
+    /**
+     * @return Number of tiles currently kept in memory.
+     */
+    std::size_t get_resident_tile_count() const;
+
+private:
+    /**
+     * @struct TileState
+     * @brief The bookkeeping of the working set for a tile.
+     */
+    struct TileState {
+        std::size_t pins = 0;                   ///< The number of accesses in progress.
+        bool is_resident = false;               ///< Whether the tile is part of the working set.
+        std::list<std::size_t>::iterator entry; ///< The tile's entry in 'evictable', if resident and unpinned.
+    };
+
+    /**
+     * @class TilePin
+     * @brief Pins a tile for the duration of a scope.
+     */
+    class TilePin {
+    public:
+        TilePin(const TiledImage& image, std::size_t index) : image(image), index(index) { image.pin(index); }
+        ~TilePin() { image.unpin(index); }
+
+        TilePin(const TilePin& other) = delete;
+        TilePin& operator=(const TilePin& other) = delete;
+
+    private:
+        const TiledImage& image; ///< The image the tile belongs to.
+        std::size_t index;       ///< The index of the tile.
+    };
+
+    /**
+     * @brief Creates an image of the dimensions of an image file, whose pixels are all black.
+     * @param info The description of the image file.
+     * @param options How to store the tiles.
+     */
+    TiledImage(const ImageInfo& info, const TiledImageOptions& options);
+
+    /**
+     * @brief Makes a tile part of the working set, dropping the least recently used unpinned tile if
+     * the working set is full, and prevents it from being dropped until it is unpinned.
+     * @param index The index of the tile.
+     */
+    void pin(std::size_t index) const;
+
+    /**
+     * @brief Allows a tile to be dropped once it isn't pinned anymore.
+     * @param index The index of the tile.
+     */
+    void unpin(std::size_t index) const;
+
+    /**
+     * @param index The index of the tile.
+     * @return A view over the tile's pixels, cropped to the image.
+     */
+    Array2DView<vec3> get_tile(std::size_t index) const;
+
+    /**
+     * @brief Copies a region lying inside the image, tile by tile.
+     * @param row The row of the first pixel of the region.
+     * @param column The column of the first pixel of the region.
+     * @param destination The view to copy the region to.
+     */
+    void copy_from_tiles(std::size_t row, std::size_t column, Array2DView<vec3> destination) const;
+
+    /**
+     * @brief Calls 'function(part, row, column)' on the part of every tile a region lying inside the
+     * image overlaps, with the row and column of the part in the region. The tile is pinned during the
+     * call.
+     * @param row The row of the first pixel of the region.
+     * @param column The column of the first pixel of the region.
+     * @param region_height The number of rows of the region.
+     * @param region_width The number of columns of the region.
+     * @param function The function to call on each part.
+     */
+    template <typename Function>
+    void visit_region(std::size_t row, std::size_t column, std::size_t region_height, std::size_t region_width,
+                      Function&& function) const;
+
+    std::size_t height;       ///< Number of rows in the image.
+    std::size_t width;        ///< Number of columns in the image.
+    std::size_t tile_size;    ///< Number of rows and columns of a tile.
+    std::size_t tile_rows;    ///< Number of rows of tiles.
+    std::size_t tile_columns; ///< Number of columns of tiles.
+    std::size_t tile_bytes;   ///< Size in bytes of a tile in the scratch file, a multiple of the page size.
+    std::size_t max_resident; ///< Number of tiles kept in memory.
+
+    MappedFile scratch; ///< The tiles, one after the other.
+
+    mutable std::mutex mutex;                 ///< Protects the working set.
+    mutable std::vector<TileState> tiles;     ///< The bookkeeping of every tile.
+    mutable std::list<std::size_t> evictable; ///< The resident unpinned tiles, the least recently used first.
+    mutable std::size_t resident_count = 0;   ///< Number of tiles in the working set.
+};
+
+template <typename Function>
+void TiledImage::for_each_tile(Function&& function, ThreadPool& pool) {
+    pool.parallel_for(0, tiles.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin ; i < end ; ++i) {
+            TilePin pin(*this, i);
+            function(get_tile(i), i / tile_columns * tile_size, i % tile_columns * tile_size);
+        }
+    });
+}
+
+template <typename Function>
+void TiledImage::for_each_tile(Function&& function, ThreadPool& pool) const {
+    pool.parallel_for(0, tiles.size(), 1, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin ; i < end ; ++i) {
+            TilePin pin(*this, i);
+            function(Array2DView<const vec3>(get_tile(i)), i / tile_columns * tile_size, i % tile_columns * tile_size);
+        }
+    });
+}
@@ -0,0 +1,376 @@
+/***************************************************************************************************
+ * @file  array_math.hpp
+ * @brief Declaration of vectorized reductions and elementwise kernels over arrays
+ *
+ * The functions work on any contiguous container exposing get_data() and get_size() (Array,
+ * ArrayView, MappedArray, SmallArray...) of float, double or int, or of Vector2/3/4 of those, which
+ * are treated as flat streams of components. Each call dispatches to the widest instruction set
+ * available at runtime (see simd.hpp).
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <stdexcept>
+#include <type_traits>
+#include "Vector2.hpp"
+#include "Vector3.hpp"
+#include "Vector4.hpp"
+
+/**
+ * @enum Reduction
+ * @brief How a floating-point reduction may order its operations.
+ */
+enum class Reduction {
+    Fast,         ///< Uses as many accumulators as fill the registers, the result depends on the CPU.
+    Deterministic ///< Uses a fixed set of accumulators, giving bit-identical results on every CPU.
+};
+
+/**
+ * @struct MathTraits
+ * @brief Describes how an element type is seen by the array math functions.
+ * @tparam Type The type of the elements.
+ */
+template <typename Type>
+struct MathTraits {
+    using Component = Type;                     ///< The type of the element's components.
+    static constexpr std::size_t components = 1; ///< The number of components per element.
+
+    template <typename Other>
+    using Rebind = Other; ///< The same kind of element with components of type 'Other'.
+};
+
+/**
+ * @brief Vector2 elements are streams of 2 components.
+ */
+template <typename Type>
+struct MathTraits<Vector2<Type>> {
+    using Component = Type;                     ///< The type of the element's components.
+    static constexpr std::size_t components = 2; ///< The number of components per element.
+    template <typename Other>
+    using Rebind = Vector2<Other>; ///< The same kind of element with components of type 'Other'.
+};
+
+/**
+ * @brief Vector3 elements are streams of 3 components.
+ */
+template <typename Type>
+struct MathTraits<Vector3<Type>> {
+    using Component = Type;                     ///< The type of the element's components.
+    static constexpr std::size_t components = 3; ///< The number of components per element.
+    template <typename Other>
+    using Rebind = Vector3<Other>; ///< The same kind of element with components of type 'Other'.
+};
+
+/**
+ * @brief Vector4 elements are streams of 4 components.
+ */
+template <typename Type>
+struct MathTraits<Vector4<Type>> {
+    using Component = Type;                     ///< The type of the element's components.
+    static constexpr std::size_t components = 4; ///< The number of components per element.
+    template <typename Other>
+    using Rebind = Vector4<Other>; ///< The same kind of element with components of type 'Other'.
+};
+
+/**
+ * @brief Whether the array math functions support a component type.
+ * @tparam Type The type of the components.
+ */
+template <typename Type>
+concept MathComponent = std::is_same_v<Type, float> || std::is_same_v<Type, double> || std::is_same_v<Type, int>;
+
+/// Type of the sums of components of type 'Type'. Sums of ints are computed on 64 bits.
+template <typename Type>
+using MathSum = std::conditional_t<std::is_same_v<Type, int>, long long, Type>;
+
+/**
+ * @brief Whether a container can be used with the array math functions.
+ * @tparam Container The type of the container.
+ */
+template <typename Container>
+concept MathContainer = requires(Container& container) {
+    { container.get_size() } -> std::convertible_to<std::size_t>;
+    requires MathComponent<typename MathTraits<std::remove_cvref_t<decltype(*container.get_data())>>::Component>;
+};
+
+/// Type of the elements of a container.
+template <typename Container>
+using ElementOf = std::remove_cvref_t<decltype(*std::declval<Container&>().get_data())>;
+
+/// Type of the components of the elements of a container.
+template <typename Container>
+using ComponentOf = MathTraits<ElementOf<Container>>::Component;
+
+/**
+ * @brief Sums interleaved components.
+ * @param data A pointer to the first component.
+ * @param count The number of components, a multiple of 'components'.
+ * @param components The number of interleaved components, from 1 to 4.
+ * @param result Receives the sum of each component.
+ * @param mode How the additions may be ordered.
+ */
+void sum_n(const float* data, std::size_t count, std::size_t components, float* result, Reduction mode);
+
+/// @brief Sums interleaved components. See the float overload.
+void sum_n(const double* data, std::size_t count, std::size_t components, double* result, Reduction mode);
+
+/// @brief Sums interleaved components on 64 bits. See the float overload.
+void sum_n(const int* data, std::size_t count, std::size_t components, long long* result, Reduction mode);
+
+/**
+ * @brief Computes the minimum of interleaved components.
+ * @param data A pointer to the first component.
+ * @param count The number of components, a multiple of 'components'.
+ * @param components The number of interleaved components, from 1 to 4.
+ * @param result Receives the minimum of each component, the largest value of the type if empty.
+ */
+void min_n(const float* data, std::size_t count, std::size_t components, float* result);
+
+/// @brief Computes the minimum of interleaved components. See the float overload.
+void min_n(const double* data, std::size_t count, std::size_t components, double* result);
+
+/// @brief Computes the minimum of interleaved components. See the float overload.
+void min_n(const int* data, std::size_t count, std::size_t components, int* result);
+
+/**
+ * @brief Computes the maximum of interleaved components.
+ * @param data A pointer to the first component.
+ * @param count The number of components, a multiple of 'components'.
+ * @param components The number of interleaved components, from 1 to 4.
+ * @param result Receives the maximum of each component, the lowest value of the type if empty.
+ */
+void max_n(const float* data, std::size_t count, std::size_t components, float* result);
+
+/// @brief Computes the maximum of interleaved components. See the float overload.
+void max_n(const double* data, std::size_t count, std::size_t components, double* result);
+
+/// @brief Computes the maximum of interleaved components. See the float overload.
+void max_n(const int* data, std::size_t count, std::size_t components, int* result);
+
+/**
+ * @brief Computes the sum of the products of two sequences.
+ * @param x A pointer to the first element of the first sequence.
+ * @param y A pointer to the first element of the second sequence.
+ * @param count The number of elements of each sequence.
+ * @param mode How the additions may be ordered.
+ * @return The dot product.
+ */
+float dot_n(const float* x, const float* y, std::size_t count, Reduction mode);
+
+/// @brief Computes the sum of the products of two sequences. See the float overload.
+double dot_n(const double* x, const double* y, std::size_t count, Reduction mode);
+
+/// @brief Computes the sum of the products of two sequences on 64 bits. See the float overload.
+long long dot_n(const int* x, const int* y, std::size_t count, Reduction mode);
+
+/**
+ * @brief Computes y = a * x + y.
+ * @param a The factor.
+ * @param x A pointer to the first element of x.
+ * @param y A pointer to the first element of y.
+ * @param count The number of elements of each sequence.
+ */
+void axpy_n(float a, const float* x, float* y, std::size_t count);
+
+/// @brief Computes y = a * x + y. See the float overload.
+void axpy_n(double a, const double* x, double* y, std::size_t count);
+
+/// @brief Computes y = a * x + y. See the float overload.
+void axpy_n(int a, const int* x, int* y, std::size_t count);
+
+/**
+ * @brief Computes the weighted sum of several sequences, e.g. the vertical pass of an image filter
+ * over rows.
+ * @param sources Pointers to the first element of each sequence.
+ * @param weights The weight of each sequence.
+ * @param source_count The number of sequences.
+ * @param destination A pointer to the first element of the result, which may be one of the sources.
+ * @param count The number of elements of each sequence.
+ */
+void weighted_sum_n(const float* const* sources, const float* weights, std::size_t source_count,
+                    float* destination, std::size_t count);
+
+/// @brief Computes the weighted sum of several sequences. See the float overload.
+void weighted_sum_n(const double* const* sources, const double* weights, std::size_t source_count,
+                    double* destination, std::size_t count);
+
+/**
+ * @brief Correlates a sequence with weights: destination[i] is the sum of weights[t] * source[i + t *
+ * step], e.g. the horizontal pass of an image filter over a row of pixels with 'step' interleaved
+ * components.
+ * @param source A pointer to the first element of the sequence, which holds count + (taps - 1) * step
+ * elements.
+ * @param step The distance in elements between two taps.
+ * @param weights The weight of each tap.
+ * @param taps The number of taps.
+ * @param destination A pointer to the first element of the result, which must not overlap the source.
+ * @param count The number of elements of the result.
+ */
+void correlate_n(const float* source, std::size_t step, const float* weights, std::size_t taps,
+                 float* destination, std::size_t count);
+
+/// @brief Correlates a sequence with weights. See the float overload.
+void correlate_n(const double* source, std::size_t step, const double* weights, std::size_t taps,
+                 double* destination, std::size_t count);
+
+/**
+ * @brief Multiplies a sequence by a factor.
+ * @param data A pointer to the first element.
+ * @param count The number of elements.
+ * @param factor The factor.
+ */
+void scale_n(float* data, std::size_t count, float factor);
+
+/// @brief Multiplies a sequence by a factor. See the float overload.
+void scale_n(double* data, std::size_t count, double factor);
+
+/// @brief Multiplies a sequence by a factor. See the float overload.
+void scale_n(int* data, std::size_t count, int factor);
+
+/**
+ * @brief Clamps a sequence to a range.
+ * @param data A pointer to the first element.
+ * @param count The number of elements.
+ * @param min The lower bound.
+ * @param max The upper bound.
+ */
+void clamp_n(float* data, std::size_t count, float min, float max);
+
+/// @brief Clamps a sequence to a range. See the float overload.
+void clamp_n(double* data, std::size_t count, double min, double max);
+
+/// @brief Clamps a sequence to a range. See the float overload.
+void clamp_n(int* data, std::size_t count, int min, int max);
+
+/**
+ * @brief Reinterprets the elements of a container as a flat stream of components.
+ * @param values The container.
+ * @return A pointer to the first component.
+ */
+template <typename Container>
+auto* components_of(Container& values) {
+    using Component = ComponentOf<Container>;
+    using Pointer = std::conditional_t<std::is_const_v<std::remove_reference_t<decltype(*values.get_data())>>,
+                                       const Component*, Component*>;
+    static_assert(sizeof(ElementOf<Container>) == MathTraits<ElementOf<Container>>::components * sizeof(Component));
+    return reinterpret_cast<Pointer>(values.get_data());
+}
+
+/**
+ * @brief Builds an element from its components.
+ * @param components The components.
+ * @return The element.
+ */
+template <typename Element, typename Component>
+Element from_components(const Component* components) {
+    constexpr std::size_t count = MathTraits<Element>::components;
+    if constexpr(count == 1) { return components[0]; }
+    else if constexpr(count == 2) { return Element(components[0], components[1]); }
+    else if constexpr(count == 3) { return Element(components[0], components[1], components[2]); }
+    else { return Element(components[0], components[1], components[2], components[3]); }
+}
+
+/**
+ * @brief Computes the sum of the elements of a container, component-wise for vectors.
+ * @param values The container.
+ * @param mode How the additions may be ordered.
+ * @return The sum, a long long (or vector of long long) for ints.
+ */
+template <MathContainer Container>
+auto sum(const Container& values, Reduction mode = Reduction::Fast) {
+    using Traits = MathTraits<ElementOf<Container>>;
+    using Sum = MathSum<typename Traits::Component>;
+
+    Sum result[Traits::components];
+    sum_n(components_of(values), values.get_size() * Traits::components, Traits::components, result, mode);
+    return from_components<typename Traits::template Rebind<Sum>>(result);
+}
+
+/**
+ * @brief Computes the minimum of the elements of a container, component-wise for vectors.
+ * @param values The container.
+ * @return The minimum.
+ * @note Throws a std::invalid_argument if the container is empty.
+ */
+template <MathContainer Container>
+ElementOf<Container> min(const Container& values) {
+    if(values.get_size() == 0) { throw std::invalid_argument("Couldn't compute the minimum of an empty array"); }
+    using Traits = MathTraits<ElementOf<Container>>;
+
+    typename Traits::Component result[Traits::components];
+    min_n(components_of(values), values.get_size() * Traits::components, Traits::components, result);
+    return from_components<ElementOf<Container>>(result);
+}
+
+/**
+ * @brief Computes the maximum of the elements of a container, component-wise for vectors.
+ * @param values The container.
+ * @return The maximum.
+ * @note Throws a std::invalid_argument if the container is empty.
+ */
+template <MathContainer Container>
+ElementOf<Container> max(const Container& values) {
+    if(values.get_size() == 0) { throw std::invalid_argument("Couldn't compute the maximum of an empty array"); }
+    using Traits = MathTraits<ElementOf<Container>>;
+
+    typename Traits::Component result[Traits::components];
+    max_n(components_of(values), values.get_size() * Traits::components, Traits::components, result);
+    return from_components<ElementOf<Container>>(result);
+}
+
+/**
+ * @brief Computes the sum of the products of the components of two containers.
+ * @param x The first container.
+ * @param y The second container, with the same size and type of elements.
+ * @param mode How the additions may be ordered.
+ * @return The dot product, a long long for ints.
+ * @note Throws a std::invalid_argument if the containers have different sizes.
+ */
+template <MathContainer ContainerX, MathContainer ContainerY>
+    requires std::is_same_v<ElementOf<ContainerX>, ElementOf<ContainerY>>
+MathSum<ComponentOf<ContainerX>> dot(const ContainerX& x, const ContainerY& y, Reduction mode = Reduction::Fast) {
+    if(x.get_size() != y.get_size()) {
+        throw std::invalid_argument("Couldn't compute the dot product of arrays of different sizes");
+    }
+    constexpr std::size_t components = MathTraits<ElementOf<ContainerX>>::components;
+    return dot_n(components_of(x), components_of(y), x.get_size() * components, mode);
+}
+
+/**
+ * @brief Computes y = a * x + y, component-wise for vectors.
+ * @param a The factor.
+ * @param x The container to scale and add.
+ * @param y The container to add to, with the same size and type of elements.
+ * @note Throws a std::invalid_argument if the containers have different sizes.
+ */
+template <MathContainer ContainerX, MathContainer ContainerY>
+    requires std::is_same_v<ElementOf<ContainerX>, ElementOf<ContainerY>>
+void axpy(ComponentOf<ContainerX> a, const ContainerX& x, ContainerY&& y) {
+    if(x.get_size() != y.get_size()) { throw std::invalid_argument("Couldn't add arrays of different sizes"); }
+    constexpr std::size_t components = MathTraits<ElementOf<ContainerX>>::components;
+    axpy_n(a, components_of(x), components_of(y), x.get_size() * components);
+}
+
+/**
+ * @brief Multiplies the components of the elements of a container by a factor.
+ * @param values The container.
+ * @param factor The factor.
+ */
+template <MathContainer Container>
+void scale(Container&& values, ComponentOf<Container> factor) {
+    constexpr std::size_t components = MathTraits<ElementOf<Container>>::components;
+    scale_n(components_of(values), values.get_size() * components, factor);
+}
+
+/**
+ * @brief Clamps the components of the elements of a container to a range.
+ * @param values The container.
+ * @param min The lower bound.
+ * @param max The upper bound.
+ */
+template <MathContainer Container>
+void clamp(Container&& values, ComponentOf<Container> min, ComponentOf<Container> max) {
+    constexpr std::size_t components = MathTraits<ElementOf<Container>>::components;
+    clamp_n(components_of(values), values.get_size() * components, min, max);
+}
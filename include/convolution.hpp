@@ -0,0 +1,127 @@
+/***************************************************************************************************
+ * @file  convolution.hpp
+ * @brief Declaration of the 2D convolutions of Array2D<float> and Image, e.g. blurs, sharpening and
+ * edge detection
+ *
+ * The functions work on views, so any Array2D<float> or Image can be filtered, as a whole or by
+ * region. Pixels are processed as flat streams of channels with the vectorized kernels of
+ * array_math.hpp, by bands of rows in parallel. Pixels outside of the source are given by a border
+ * mode. The source and the destination must have the same dimensions and must not overlap.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+#include "Array2DView.hpp"
+#include "ThreadPool.hpp"
+#include "vec.hpp"
+
+/**
+ * @enum BorderMode
+ * @brief How the pixels outside of an image are extrapolated, here for a row 'abcd'.
+ */
+enum class BorderMode {
+    Clamp,  ///< The closest edge pixel: 'aaa|abcd|ddd'.
+    Wrap,   ///< The image repeats: 'bcd|abcd|abc'.
+    Mirror, ///< The image is reflected, without repeating the edge pixel: 'dcb|abcd|cba'.
+    Zero    ///< Zero.
+};
+
+/**
+ * @brief Factors a kernel into a vertical and a horizontal 1D kernel, if it is separable, i.e. if
+ * kernel(a, b) = vertical[a] * horizontal[b], like box, Gaussian or Sobel kernels.
+ * @param kernel The kernel.
+ * @param vertical Receives the vertical kernel, with as many taps as the kernel has rows.
+ * @param horizontal Receives the horizontal kernel, with as many taps as the kernel has columns.
+ * @param tolerance The largest difference allowed between the kernel and the product of the 1D
+ * kernels, relative to the largest absolute value of the kernel.
+ * @return Whether the kernel is separable. The 1D kernels are left unspecified otherwise.
+ */
+bool separate_kernel(Array2DView<const float> kernel, std::vector<float>& vertical, std::vector<float>& horizontal,
+                     float tolerance = 1e-6f);
+
+/**
+ * @param sigma The standard deviation, in pixels.
+ * @return A normalized 1D Gaussian kernel, with a radius of ceil(3 * sigma) taps.
+ */
+std::vector<float> gaussian_kernel(float sigma);
+
+/**
+ * @brief Convolves an image with a kernel. The kernel is centered on its element (rows / 2,
+ * columns / 2). Separable kernels are detected and applied as two 1D passes, other kernels with all
+ * their non-zero taps at once. Kernels that would take too many taps per pixel either way, e.g.
+ * non-separable kernels larger than about 20x20, are applied through FFTs with convolve_fft.
+ * @param source The image to convolve.
+ * @param destination The convolved image.
+ * @param kernel The kernel.
+ * @param border How the pixels outside of the source are extrapolated.
+ * @param pool The pool to process bands of rows on.
+ * @note Throws a std::invalid_argument if the source and the destination have different dimensions.
+ */
+void convolve(Array2DView<const float> source, Array2DView<float> destination, Array2DView<const float> kernel,
+              BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
+
+/// @brief Convolves the channels of an image with a kernel. See the float overload.
+void convolve(Array2DView<const vec3> source, Array2DView<vec3> destination, Array2DView<const float> kernel,
+              BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
+
+/**
+ * @brief Convolves an image with a kernel through FFTs: the source, extended by the border mode, and
+ * the kernel are transformed, multiplied and transformed back, a channel at a time. Its cost depends
+ * on the dimensions of the image and of the kernel, padded to sizes that are fast to transform, but
+ * not on the number of taps of the kernel. The FFT plans are cached, so convolving images of the same
+ * dimensions again, e.g. the frames of a video, doesn't plan the transforms again.
+ * @param source The image to convolve.
+ * @param destination The convolved image.
+ * @param kernel The kernel, centered like for convolve.
+ * @param border How the pixels outside of the source are extrapolated.
+ * @param pool The pool to process bands of rows and columns on.
+ * @note Throws a std::invalid_argument if the source and the destination have different dimensions.
+ */
+void convolve_fft(Array2DView<const float> source, Array2DView<float> destination, Array2DView<const float> kernel,
+                  BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
+
+/// @brief Convolves the channels of an image with a kernel through FFTs. See the float overload.
+void convolve_fft(Array2DView<const vec3> source, Array2DView<vec3> destination, Array2DView<const float> kernel,
+                  BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
+
+/**
+ * @brief Convolves an image with a separable kernel, given as a vertical and a horizontal 1D
+ * kernel, each centered on its element size / 2. The vertical pass is done first, a row at a time,
+ * then the horizontal one.
+ * @param source The image to convolve.
+ * @param destination The convolved image.
+ * @param vertical The vertical kernel.
+ * @param horizontal The horizontal kernel.
+ * @param border How the pixels outside of the source are extrapolated.
+ * @param pool The pool to process bands of rows on.
+ * @note Throws a std::invalid_argument if the source and the destination have different dimensions.
+ */
+void convolve_separable(Array2DView<const float> source, Array2DView<float> destination,
+                        std::span<const float> vertical, std::span<const float> horizontal,
+                        BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
+
+/// @brief Convolves the channels of an image with a separable kernel. See the float overload.
+void convolve_separable(Array2DView<const vec3> source, Array2DView<vec3> destination,
+                        std::span<const float> vertical, std::span<const float> horizontal,
+                        BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
+
+/**
+ * @brief Blurs an image with a Gaussian. Small blurs (sigma < 4) use an exact Gaussian kernel. Larger
+ * ones are approximated by 3 successive box blurs per axis, computed with running sums, so that their
+ * cost per pixel doesn't depend on sigma.
+ * @param source The image to blur.
+ * @param destination The blurred image.
+ * @param sigma The standard deviation, in pixels. The source is copied if it is not positive.
+ * @param border How the pixels outside of the source are extrapolated.
+ * @param pool The pool to process bands of rows and columns on.
+ * @note Throws a std::invalid_argument if the source and the destination have different dimensions.
+ */
+void gaussian_blur(Array2DView<const float> source, Array2DView<float> destination, float sigma,
+                   BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
+
+/// @brief Blurs the channels of an image with a Gaussian. See the float overload.
+void gaussian_blur(Array2DView<const vec3> source, Array2DView<vec3> destination, float sigma,
+                   BorderMode border = BorderMode::Clamp, ThreadPool& pool = ThreadPool::get_global());
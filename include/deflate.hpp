@@ -0,0 +1,65 @@
+/***************************************************************************************************
+ * @file  deflate.hpp
+ * @brief Declaration of a deflate compressor and of the zlib and PNG checksums
+ *
+ * The compressor produces raw deflate data (RFC 1951) that can be split into independently
+ * compressed pieces: every piece but the last ends with a sync flush, i.e. an empty stored block that
+ * realigns the stream on a byte boundary, so that the pieces can simply be concatenated. The zlib
+ * checksum of the whole stream is then combined from the checksums of the pieces.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @enum DeflateFlush
+ * @brief How a piece of compressed data ends.
+ */
+enum class DeflateFlush {
+    Sync,  ///< With an empty stored block, so that another piece can follow it.
+    Finish ///< With the final block of the stream.
+};
+
+/// The highest compression level.
+inline constexpr int max_compression_level = 9;
+
+/**
+ * @brief Compresses data to raw deflate blocks, appended to an output buffer.
+ * @param data A pointer to the data to compress.
+ * @param size The number of bytes to compress.
+ * @param level The compression level: 0 stores the data, 1 to 9 search longer and longer for
+ * matches.
+ * @param flush How the compressed data ends.
+ * @param output The buffer to append the compressed data to.
+ */
+void deflate(const uint8_t* data, std::size_t size, int level, DeflateFlush flush, std::vector<std::byte>& output);
+
+/**
+ * @brief Computes or updates the Adler-32 checksum of zlib streams.
+ * @param data A pointer to the data.
+ * @param size The number of bytes.
+ * @param adler The checksum of the preceding data, 1 for none.
+ * @return The checksum of the preceding data followed by this data.
+ */
+uint32_t adler32(const uint8_t* data, std::size_t size, uint32_t adler = 1);
+
+/**
+ * @brief Combines the Adler-32 checksums of two consecutive pieces of data.
+ * @param first The checksum of the first piece.
+ * @param second The checksum of the second piece.
+ * @param second_size The number of bytes of the second piece.
+ * @return The checksum of the first piece followed by the second one.
+ */
+uint32_t adler32_combine(uint32_t first, uint32_t second, std::size_t second_size);
+
+/**
+ * @brief Computes or updates the CRC-32 checksum of PNG chunks.
+ * @param data A pointer to the data.
+ * @param size The number of bytes.
+ * @param crc The checksum of the preceding data, 0 for none.
+ * @return The checksum of the preceding data followed by this data.
+ */
+uint32_t crc32(const uint8_t* data, std::size_t size, uint32_t crc = 0);
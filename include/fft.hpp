@@ -0,0 +1,54 @@
+/***************************************************************************************************
+ * @file  fft.hpp
+ * @brief Declaration of the discrete Fourier transforms of arrays and 2D arrays
+ *
+ * The transforms use the plans cached by FFTPlan::get() and RealFFTPlan::get(), so transforming data
+ * of the same dimensions again only pays for the transforms themselves. Like the plans, the
+ * transforms aren't normalized: an inverse transform of a forward transform multiplies the data by
+ * its number of elements.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <complex>
+#include "Array2DView.hpp"
+#include "ArrayView.hpp"
+#include "FFTPlan.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @brief Transforms a sequence in place.
+ * @param data The sequence.
+ * @param direction The direction of the transform.
+ */
+void fft(ArrayView<std::complex<float>> data, FFTDirection direction);
+
+/**
+ * @brief Transforms a 2D array in place, its rows then its columns, in parallel.
+ * @param data The 2D array.
+ * @param direction The direction of the transform.
+ * @param pool The pool to transform rows and bands of columns on.
+ */
+void fft(Array2DView<std::complex<float>> data, FFTDirection direction, ThreadPool& pool = ThreadPool::get_global());
+
+/**
+ * @brief Computes the spectrum of a real 2D array: the first 'width / 2 + 1' columns of its complex
+ * transform, the others being the conjugates of these.
+ * @param input The 2D array.
+ * @param spectrum The spectrum, with as many rows as the input and 'width / 2 + 1' columns.
+ * @param pool The pool to transform rows and bands of columns on.
+ * @note Throws a std::invalid_argument if the spectrum doesn't have the right dimensions.
+ */
+void real_fft(Array2DView<const float> input, Array2DView<std::complex<float>> spectrum,
+              ThreadPool& pool = ThreadPool::get_global());
+
+/**
+ * @brief Computes the real 2D array of a spectrum computed by real_fft, multiplied by its number of
+ * elements.
+ * @param spectrum The spectrum, overwritten.
+ * @param output The 2D array, whose width gives the width of the transform.
+ * @param pool The pool to transform rows and bands of columns on.
+ * @note Throws a std::invalid_argument if the spectrum doesn't have the right dimensions.
+ */
+void inverse_real_fft(Array2DView<std::complex<float>> spectrum, Array2DView<float> output,
+                      ThreadPool& pool = ThreadPool::get_global());
@@ -0,0 +1,257 @@
+/***************************************************************************************************
+ * @file  image_io.hpp
+ * @brief Declaration of the functions reading and writing image files in the supported formats
+ *
+ * These functions work on raw interleaved pixels, with 8-bit, 16-bit or float channels, and are
+ * shared by Image and PixelImage, which convert the pixels from and to their own format. Images can
+ * be decoded from and encoded to memory or streams as well as files.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <iosfwd>
+#include <optional>
+#include <span>
+#include <vector>
+#include "pixel_conversion.hpp"
+
+class ThreadPool;
+
+/**
+ * @enum ImageFormat
+ * @brief The file formats images can be written in.
+ */
+enum class ImageFormat {
+    PNG, ///< Lossless, deflate-compressed.
+    QOI, ///< Lossless, much faster to encode and decode than PNG.
+    BMP, ///< Uncompressed.
+    TGA, ///< Run-length encoded.
+    JPG, ///< Lossy, with a quality setting.
+    HDR, ///< Radiance RGBE, storing float channels with a shared exponent.
+    PPM, ///< Uncompressed binary netpbm, the cheapest to write.
+    PFM  ///< Uncompressed float channels.
+};
+
+/**
+ * @param path The path of an image file.
+ * @return The format matching the extension of the path, case-insensitively, if any. '.jpeg' and
+ * '.jpg' are both JPG.
+ */
+std::optional<ImageFormat> image_format_from_extension(const std::filesystem::path& path);
+
+/**
+ * @param data The beginning of encoded image data.
+ * @return The format recognized from the signature of the data, if any. TGA has no signature and is
+ * never recognized.
+ */
+std::optional<ImageFormat> image_format_from_data(std::span<const std::byte> data);
+
+/**
+ * @param format An image format.
+ * @return Whether the format stores float channels instead of 8-bit ones.
+ */
+bool stores_floats(ImageFormat format);
+
+/**
+ * @struct ImageWriteOptions
+ * @brief How images are encoded by the functions writing them.
+ */
+struct ImageWriteOptions {
+    ColorSpace color_space = ColorSpace::Linear; ///< The color space of the files' 8-bit values.
+    int jpg_quality = 90;                        ///< The quality of JPG files, from 1 to 100.
+    int compression_level = 4;                   ///< The compression level of PNG files, from 0 to 9.
+    ThreadPool* thread_pool = nullptr;           ///< The pool encoding PNG files, the global one if null.
+};
+
+/**
+ * @struct DecodedImage
+ * @brief The pixels of a decoded image file, with interleaved channels and tightly packed rows.
+ */
+struct DecodedImage {
+    std::size_t width = 0;                                                ///< The number of columns.
+    std::size_t height = 0;                                               ///< The number of rows.
+    std::size_t channels = 0;                                             ///< The number of channels.
+    std::size_t bytes_per_channel = 1;                                    ///< 1, 2, or 4 for floats.
+    std::unique_ptr<uint8_t[], void (*)(void*)> pixels { nullptr, std::free }; ///< The pixels.
+};
+
+/**
+ * @struct ImageInfo
+ * @brief The description of an encoded image, read from its header.
+ */
+struct ImageInfo {
+    std::size_t width = 0;             ///< The number of columns.
+    std::size_t height = 0;            ///< The number of rows.
+    std::size_t channels = 0;          ///< The number of channels stored in the file, from 1 to 4.
+    std::optional<ImageFormat> format; ///< The format, if it is one of ImageFormat.
+};
+
+/**
+ * @brief Reads the description of an image from its header, without decoding its pixels. QOI and
+ * PFM headers are parsed natively, other formats by stb_image.
+ * @param data The encoded data.
+ * @return The description of the image.
+ * @note Throws a std::runtime_error if the data is not a supported image.
+ */
+ImageInfo probe_image(std::span<const std::byte> data);
+
+/**
+ * @brief Reads the description of an image file from its header. The file is mapped, so that only the
+ * pages holding the header are read. See probe_image.
+ * @param path The path to the image file.
+ * @return The description of the image. TGA files are recognized from their extension.
+ * @note Throws a std::runtime_error if the file can't be read or is not a supported image.
+ */
+ImageInfo probe_image_file(const std::filesystem::path& path);
+
+/**
+ * @brief Decodes an image. QOI and PFM data are decoded natively, and other formats by stb_image,
+ * which all recognize them from their content.
+ * @param data The encoded data.
+ * @param channels The number of channels to decode to: 3 (RGB) or 4 (RGBA).
+ * @param bytes_per_channel 1 to decode 8-bit channels, 2 to decode 16-bit channels, 4 to decode float
+ * channels. Float channels of 8-bit images are gamma-corrected by stb_image.
+ * @param flip_vertically Whether to flip the image vertically.
+ * @return The decoded pixels.
+ * @note Throws a std::runtime_error if the data can't be decoded.
+ */
+DecodedImage decode_image(std::span<const std::byte> data, std::size_t channels, std::size_t bytes_per_channel,
+                          bool flip_vertically);
+
+/**
+ * @brief Reads and decodes an image file. See decode_image.
+ * @param path The path to the image file.
+ * @param channels The number of channels to decode to: 3 (RGB) or 4 (RGBA).
+ * @param bytes_per_channel 1 to decode 8-bit channels, 2 to decode 16-bit channels, 4 to decode float
+ * channels.
+ * @param flip_vertically Whether to flip the image vertically.
+ * @return The decoded pixels.
+ * @note Throws a std::runtime_error if the file can't be read or decoded.
+ */
+DecodedImage read_image_file(const std::filesystem::path& path, std::size_t channels,
+                             std::size_t bytes_per_channel, bool flip_vertically);
+
+/**
+ * @brief Encodes 8-bit pixels. Float formats get the pixels' linear values, decoded according to the
+ * options' color space.
+ * @param format The format to encode to.
+ * @param pixels A pointer to the first pixel of the first row, with interleaved channels.
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @param channels The number of channels: 3 (RGB) or 4 (RGBA). Formats without alpha drop it.
+ * @param stride The distance in bytes between the starts of two consecutive rows.
+ * @param flip_vertically Whether to flip the image vertically.
+ * @param options How to encode the image.
+ * @return The encoded data, as it would be stored in a file.
+ * @note Throws a std::runtime_error if the image can't be encoded.
+ */
+std::vector<std::byte> encode_image(ImageFormat format, const uint8_t* pixels, std::size_t width,
+                                    std::size_t height, std::size_t channels, std::size_t stride,
+                                    bool flip_vertically, const ImageWriteOptions& options);
+
+/**
+ * @brief Encodes float pixels. 8-bit formats get the pixels encoded according to the options' color
+ * space. See the 8-bit overload for the parameters.
+ * @return The encoded data, as it would be stored in a file.
+ * @note Throws a std::runtime_error if the image can't be encoded.
+ */
+std::vector<std::byte> encode_image(ImageFormat format, const float* pixels, std::size_t width,
+                                    std::size_t height, std::size_t channels, std::size_t stride,
+                                    bool flip_vertically, const ImageWriteOptions& options);
+
+/**
+ * @brief Encodes 8-bit pixels to a stream. The uncompressed formats (PPM, PFM) are streamed row by
+ * row, the others are written once encoded. See the overload returning the data for the parameters.
+ * @param output The stream to write the encoded data to.
+ * @note Throws a std::runtime_error if the image can't be encoded or the stream fails.
+ */
+void encode_image(std::ostream& output, ImageFormat format, const uint8_t* pixels, std::size_t width,
+                  std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                  const ImageWriteOptions& options);
+
+/**
+ * @brief Encodes float pixels to a stream. See the overload returning the data for the parameters.
+ * @param output The stream to write the encoded data to.
+ * @note Throws a std::runtime_error if the image can't be encoded or the stream fails.
+ */
+void encode_image(std::ostream& output, ImageFormat format, const float* pixels, std::size_t width,
+                  std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                  const ImageWriteOptions& options);
+
+/**
+ * @brief Encodes 8-bit pixels and writes them to an image file. Float formats get the pixels'
+ * linear values, decoded according to the options' color space.
+ * @param path The path to the image file.
+ * @param format The format of the file.
+ * @param pixels A pointer to the first pixel of the first row, with interleaved channels.
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @param channels The number of channels: 3 (RGB) or 4 (RGBA). Formats without alpha drop it.
+ * @param stride The distance in bytes between the starts of two consecutive rows.
+ * @param flip_vertically Whether to flip the image vertically.
+ * @param options How to encode the image.
+ * @note Throws a std::runtime_error if the file can't be written.
+ */
+void write_image_file(const std::filesystem::path& path, ImageFormat format, const uint8_t* pixels,
+                      std::size_t width, std::size_t height, std::size_t channels, std::size_t stride,
+                      bool flip_vertically, const ImageWriteOptions& options);
+
+/**
+ * @brief Encodes float pixels and writes them to an image file. 8-bit formats get the pixels
+ * encoded according to the options' color space.
+ * @param path The path to the image file.
+ * @param format The format of the file.
+ * @param pixels A pointer to the first pixel of the first row, with interleaved channels.
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @param channels The number of channels: 3 (RGB) or 4 (RGBA). Formats without alpha drop it.
+ * @param stride The distance in bytes between the starts of two consecutive rows.
+ * @param flip_vertically Whether to flip the image vertically.
+ * @param options How to encode the image.
+ * @note Throws a std::runtime_error if the file can't be written.
+ */
+void write_image_file(const std::filesystem::path& path, ImageFormat format, const float* pixels,
+                      std::size_t width, std::size_t height, std::size_t channels, std::size_t stride,
+                      bool flip_vertically, const ImageWriteOptions& options);
+
+/**
+ * @param format An image format.
+ * @return Whether files of the format can be read and written band by band, with read_image_bands and
+ * write_image_bands: PPM and PFM.
+ */
+bool supports_bands(ImageFormat format);
+
+/**
+ * @brief Reads a PPM (8-bit) or PFM file band by band, without ever holding the whole image: the file
+ * is mapped, and the pages of every band are dropped once it is consumed.
+ * @param path The path to the image file.
+ * @param band_height The number of rows of every band but the last one.
+ * @param color_space The color space of PPM values.
+ * @param function Called as 'function(first_row, row_count, pixels)' on the bands from the top, with
+ * their RGB float pixels, tightly packed.
+ * @note Throws a std::runtime_error if the file can't be read or is not an 8-bit PPM or a PFM file.
+ */
+void read_image_bands(const std::filesystem::path& path, std::size_t band_height, ColorSpace color_space,
+                      const std::function<void(std::size_t, std::size_t, const float*)>& function);
+
+/**
+ * @brief Writes a PPM or PFM file band by band, without ever holding the whole image.
+ * @param path The path to the image file.
+ * @param format PPM or PFM.
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @param band_height The number of rows of every band but the last one.
+ * @param color_space The color space to encode PPM values in.
+ * @param function Called as 'function(first_row, row_count, pixels)' on the bands from the top, to
+ * fill their RGB float pixels, tightly packed.
+ * @note Throws a std::runtime_error if the file can't be written or the format is not PPM or PFM.
+ */
+void write_image_bands(const std::filesystem::path& path, ImageFormat format, std::size_t width, std::size_t height,
+                       std::size_t band_height, ColorSpace color_space,
+                       const std::function<void(std::size_t, std::size_t, float*)>& function);
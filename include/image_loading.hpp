@@ -0,0 +1,164 @@
+/***************************************************************************************************
+ * @file  image_loading.hpp
+ * @brief Declaration of the parallel loading of many image files
+ *
+ * Image files are read and decoded on a thread pool, then handed to the caller through a callback,
+ * in the order of their paths or as soon as they are decoded. The number of decoded images not
+ * handed over yet is bounded, so that loading a dataset larger than memory only keeps a few images
+ * alive at a time.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <concepts>
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <map>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+#include "Image.hpp"
+#include "ThreadPool.hpp"
+
+/**
+ * @struct ImageLoadOptions
+ * @brief How load_images schedules and decodes the files.
+ */
+struct ImageLoadOptions {
+    std::size_t max_in_flight = 0;               ///< The maximum number of images being decoded or waiting to be
+                                                 ///< handed over. 0 means twice the threads of the pool.
+    bool in_order = true;                        ///< Whether images are handed over in the order of the paths,
+                                                 ///< rather than as soon as they are decoded.
+    bool flip_vertically = false;                ///< Whether to flip the images vertically.
+    ColorSpace color_space = ColorSpace::Linear; ///< The color space of the files' 8-bit values, for Image.
+    ThreadPool* thread_pool = nullptr;           ///< The pool decoding the files, the global one if null.
+};
+
+/**
+ * @concept LoadableImage
+ * @brief An image type that can be read from a file: Image or any PixelImage, which converts the
+ * files' pixels to its own format.
+ */
+template <typename ImageType>
+concept LoadableImage = std::default_initializable<ImageType> && std::movable<ImageType>
+                        && requires(ImageType image, const std::filesystem::path& path) { image.read(path, false); };
+
+/**
+ * @brief Loads image files in parallel and hands them over one at a time.
+ * @param paths The paths to the image files.
+ * @param options How to schedule and decode the files.
+ * @param callback Called as 'callback(index, image)' with the index of each path and its image, as
+ * an rvalue. Calls never overlap, but happen on the threads of the pool.
+ * @note Stops at the first file that can't be loaded or call that throws, and rethrows its exception
+ * once the files being decoded are done. Threads of the pool wait while 'max_in_flight' images are
+ * pending.
+ */
+template <LoadableImage ImageType, typename Callback>
+void load_images(std::span<const std::filesystem::path> paths, const ImageLoadOptions& options, Callback&& callback);
+
+/**
+ * @brief Loads image files in parallel.
+ * @param paths The paths to the image files.
+ * @param options How to decode the files. All images are returned, so 'max_in_flight' and
+ * 'in_order' are ignored.
+ * @return The images, in the order of the paths.
+ * @note Rethrows the exception of the first file that can't be loaded.
+ */
+template <LoadableImage ImageType>
+std::vector<ImageType> load_images(std::span<const std::filesystem::path> paths, const ImageLoadOptions& options = {});
+
+template <LoadableImage ImageType, typename Callback>
+void load_images(std::span<const std::filesystem::path> paths, const ImageLoadOptions& options, Callback&& callback) {
+    ThreadPool& pool = options.thread_pool != nullptr ? *options.thread_pool : ThreadPool::get_global();
+    std::size_t max_in_flight = options.max_in_flight > 0 ? options.max_in_flight : 2 * pool.get_thread_count();
+
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::size_t next_path = 0;             // The index of the next path to decode.
+    std::size_t next_handover = 0;         // The index of the next image to hand over, in order.
+    std::size_t in_flight = 0;             // The number of images being decoded or waiting.
+    std::map<std::size_t, ImageType> done; // The decoded images waiting to be handed over.
+    bool is_handing_over = false;          // Whether a thread is calling the callback.
+    std::exception_ptr error;
+
+    auto fail = [&](std::exception_ptr exception) {
+        std::lock_guard lock(mutex);
+        if(!error) { error = exception; }
+        condition.notify_all();
+    };
+
+    // Every task decodes the next path rather than its own index, so that paths start in order and
+    // the next image to hand over is always being decoded, which keeps the bound from deadlocking.
+    pool.parallel_for(0, paths.size(), 1, [&](std::size_t, std::size_t) {
+        std::unique_lock lock(mutex);
+        condition.wait(lock, [&] { return in_flight < max_in_flight || error; });
+        if(error) { return; }
+        std::size_t index = next_path++;
+        ++in_flight;
+        lock.unlock();
+
+        ImageType image;
+        try {
+            if constexpr(std::same_as<ImageType, Image>) {
+                image.read(paths[index], options.flip_vertically, options.color_space);
+            } else {
+                image.read(paths[index], options.flip_vertically);
+            }
+        } catch(...) {
+            fail(std::current_exception());
+            return;
+        }
+
+        lock.lock();
+        done.emplace(index, std::move(image));
+
+        // A single thread hands images over at a time, so that calls never overlap and stay in order.
+        // The others leave their image to it.
+        if(is_handing_over) { return; }
+        is_handing_over = true;
+
+        while(!error) {
+            auto next = options.in_order ? done.find(next_handover) : done.begin();
+            if(next == done.end()) { break; }
+
+            std::size_t handed_index = next->first;
+            ImageType handed = std::move(next->second);
+            done.erase(next);
+            lock.unlock();
+
+            try {
+                callback(handed_index, std::move(handed));
+            } catch(...) {
+                fail(std::current_exception());
+                lock.lock();
+                break;
+            }
+
+            lock.lock();
+            ++next_handover;
+            --in_flight;
+            condition.notify_all();
+        }
+
+        is_handing_over = false;
+    });
+
+    if(error) { std::rethrow_exception(error); }
+}
+
+template <LoadableImage ImageType>
+std::vector<ImageType> load_images(std::span<const std::filesystem::path> paths, const ImageLoadOptions& options) {
+    std::vector<ImageType> images(paths.size());
+
+    ImageLoadOptions unbounded = options;
+    unbounded.in_order = false;
+    unbounded.max_in_flight = paths.size() + 1;
+    load_images<ImageType>(paths, unbounded, [&](std::size_t index, ImageType&& image) {
+        images[index] = std::move(image);
+    });
+
+    return images;
+}
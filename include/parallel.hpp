@@ -0,0 +1,80 @@
+/***************************************************************************************************
+ * @file  parallel.hpp
+ * @brief Declaration of parallel loops over ranges and 2D arrays
+ **************************************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include "Array2DView.hpp"
+#include "ThreadPool.hpp"
+
+/// Approximate size in bytes of the tiles picked by parallel_for_2d, small enough to stay in L2.
+inline constexpr std::size_t default_tile_bytes = 64 * 1024;
+
+/**
+ * @brief Calls 'function(chunk_begin, chunk_end)' on chunks of at most 'grain' indices covering
+ * [begin ; end), in parallel on a thread pool, and waits for all of them.
+ * @param begin The first index.
+ * @param end The index past the last one.
+ * @param grain The maximum length of a chunk.
+ * @param function The function to call on each chunk.
+ * @param pool The pool to run on.
+ */
+template <typename Function>
+void parallel_for(std::size_t begin, std::size_t end, std::size_t grain, Function&& function,
+                  ThreadPool& pool = ThreadPool::get_global()) {
+    pool.parallel_for(begin, end, grain, std::forward<Function>(function));
+}
+
+/**
+ * @brief Splits a 2D container into tiles and calls 'function(tile, row, column)' on each of them in
+ * parallel on a thread pool, where 'tile' is an Array2DView of the tile and ('row', 'column') the
+ * position of its first element.
+ * @param container The container to process: an Array2D, Image, MappedArray2D or Array2DView.
+ * @param tile_height The number of rows of a tile.
+ * @param tile_width The number of columns of a tile.
+ * @param function The function to call on each tile.
+ * @param pool The pool to run on.
+ */
+template <typename Container, typename Function>
+void parallel_for_2d(Container&& container, std::size_t tile_height, std::size_t tile_width, Function&& function,
+                     ThreadPool& pool = ThreadPool::get_global()) {
+    using Type = std::remove_reference_t<decltype(*container.get_data())>;
+    Array2DView<Type> view(container);
+
+    tile_height = std::max<std::size_t>(tile_height, 1);
+    tile_width = std::max<std::size_t>(tile_width, 1);
+    std::size_t tile_rows = (view.get_height() + tile_height - 1) / tile_height;
+    std::size_t tile_columns = (view.get_width() + tile_width - 1) / tile_width;
+
+    pool.parallel_for(0, tile_rows * tile_columns, 1, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t tile = begin ; tile < end ; ++tile) {
+            std::size_t row = tile / tile_columns * tile_height;
+            std::size_t column = tile % tile_columns * tile_width;
+            std::size_t height = std::min(tile_height, view.get_height() - row);
+            std::size_t width = std::min(tile_width, view.get_width() - column);
+            function(view.region(row, column, height, width), row, column);
+        }
+    });
+}
+
+/**
+ * @brief Same as parallel_for_2d, with tiles of about default_tile_bytes bytes. Tiles span whole
+ * rows when possible, otherwise they are as wide as a few cache lines allow.
+ * @param container The container to process: an Array2D, Image, MappedArray2D or Array2DView.
+ * @param function The function to call on each tile.
+ * @param pool The pool to run on.
+ */
+template <typename Container, typename Function>
+void parallel_for_2d(Container&& container, Function&& function, ThreadPool& pool = ThreadPool::get_global()) {
+    using Type = std::remove_reference_t<decltype(*container.get_data())>;
+
+    std::size_t tile_elements = std::max<std::size_t>(default_tile_bytes / sizeof(Type), 1);
+    std::size_t tile_width = std::min<std::size_t>(container.get_width(), std::max<std::size_t>(tile_elements / 16, 1));
+    std::size_t tile_height = std::max<std::size_t>(tile_elements / std::max<std::size_t>(tile_width, 1), 1);
+
+    parallel_for_2d(container, tile_height, tile_width, std::forward<Function>(function), pool);
+}
@@ -0,0 +1,191 @@
+/***************************************************************************************************
+ * @file  pixel.hpp
+ * @brief Declaration of the pixel formats and of the conversions between them
+ **************************************************************************************************/
+
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "Array.hpp"
+#include "vec.hpp"
+
+/**
+ * @struct RGB8
+ * @brief An RGB pixel with 8 bits per channel.
+ */
+struct RGB8 {
+    uint8_t r; ///< The red channel.
+    uint8_t g; ///< The green channel.
+    uint8_t b; ///< The blue channel.
+};
+
+/**
+ * @struct RGBA8
+ * @brief An RGBA pixel with 8 bits per channel.
+ */
+struct RGBA8 {
+    uint8_t r; ///< The red channel.
+    uint8_t g; ///< The green channel.
+    uint8_t b; ///< The blue channel.
+    uint8_t a; ///< The alpha channel.
+};
+
+/**
+ * @struct RGB16
+ * @brief An RGB pixel with 16 bits per channel.
+ */
+struct RGB16 {
+    uint16_t r; ///< The red channel.
+    uint16_t g; ///< The green channel.
+    uint16_t b; ///< The blue channel.
+};
+
+/// An RGB pixel with a 32-bit float per channel, the pixel type of Image.
+using RGB32F = vec3;
+
+/**
+ * @struct PixelTraits
+ * @brief Describes the layout of a pixel format. Only specialized for the supported formats.
+ * @tparam Pixel The pixel format.
+ */
+template <typename Pixel>
+struct PixelTraits;
+
+/**
+ * @brief Traits of the RGB8 format.
+ */
+template <>
+struct PixelTraits<RGB8> {
+    using Channel = uint8_t;                    ///< The type of a channel.
+    static constexpr std::size_t channels = 3; ///< The number of channels.
+};
+
+/**
+ * @brief Traits of the RGBA8 format.
+ */
+template <>
+struct PixelTraits<RGBA8> {
+    using Channel = uint8_t;                    ///< The type of a channel.
+    static constexpr std::size_t channels = 4; ///< The number of channels.
+};
+
+/**
+ * @brief Traits of the RGB16 format.
+ */
+template <>
+struct PixelTraits<RGB16> {
+    using Channel = uint16_t;                   ///< The type of a channel.
+    static constexpr std::size_t channels = 3; ///< The number of channels.
+};
+
+/**
+ * @brief Traits of the RGB32F format.
+ */
+template <>
+struct PixelTraits<RGB32F> {
+    using Channel = float;                      ///< The type of a channel.
+    static constexpr std::size_t channels = 3; ///< The number of channels.
+};
+
+/**
+ * @brief Whether a type is one of the supported pixel formats.
+ * @tparam Pixel The type to check.
+ */
+template <typename Pixel>
+concept PixelFormat = requires {
+    typename PixelTraits<Pixel>::Channel;
+    { PixelTraits<Pixel>::channels } -> std::convertible_to<std::size_t>;
+};
+
+/**
+ * @brief Rows of pixels start on a cache line so that they can be converted with SIMD instructions.
+ */
+template <>
+struct ArrayAlignment<RGB8> {
+    static constexpr std::size_t value = cache_line_size; ///< The alignment in bytes.
+};
+
+/**
+ * @brief Rows of pixels start on a cache line so that they can be converted with SIMD instructions.
+ */
+template <>
+struct ArrayAlignment<RGBA8> {
+    static constexpr std::size_t value = cache_line_size; ///< The alignment in bytes.
+};
+
+/**
+ * @brief Rows of pixels start on a cache line so that they can be converted with SIMD instructions.
+ */
+template <>
+struct ArrayAlignment<RGB16> {
+    static constexpr std::size_t value = cache_line_size; ///< The alignment in bytes.
+};
+
+/**
+ * @brief Converts a channel value between types. Integer channels span [0 ; max], float channels
+ * span [0 ; 1]. Float values are clamped and integer values are rounded to the nearest.
+ * @tparam To The type of the result.
+ * @tparam From The type of the value.
+ * @param value The value to convert.
+ * @return The converted value.
+ */
+template <typename To, typename From>
+To convert_channel(From value) {
+    if constexpr(std::is_same_v<To, From>) {
+        return value;
+    } else if constexpr(std::is_floating_point_v<From>) {
+        if constexpr(std::is_floating_point_v<To>) {
+            return static_cast<To>(value);
+        } else {
+            From clamped = value > From(0) ? (value < From(1) ? value : From(1)) : From(0); // NaN gives 0.
+            return static_cast<To>(clamped * std::numeric_limits<To>::max() + From(0.5));
+        }
+    } else if constexpr(std::is_floating_point_v<To>) {
+        return static_cast<To>(value) * (To(1) / static_cast<To>(std::numeric_limits<From>::max()));
+    } else if constexpr(sizeof(To) > sizeof(From)) {
+        // Replicating the bits maps max to max, e.g. 0xAB to 0xABAB.
+        return static_cast<To>(value * (std::numeric_limits<To>::max() / std::numeric_limits<From>::max()));
+    } else {
+        constexpr uint32_t to_max = std::numeric_limits<To>::max();
+        constexpr uint32_t from_max = std::numeric_limits<From>::max();
+        return static_cast<To>((value * to_max + from_max / 2) / from_max);
+    }
+}
+
+/**
+ * @brief Converts a pixel between formats. Alpha is dropped when the target has none, and set to
+ * opaque when the source has none.
+ * @tparam To The format of the result.
+ * @tparam From The format of the pixel.
+ * @param pixel The pixel to convert.
+ * @return The converted pixel.
+ */
+template <PixelFormat To, PixelFormat From>
+To convert_pixel(const From& pixel) {
+    if constexpr(std::is_same_v<To, From>) {
+        return pixel;
+    } else {
+        using ToChannel = PixelTraits<To>::Channel;
+        using FromChannel = PixelTraits<From>::Channel;
+
+        // Pixel formats are plain sequences of channels, like the VectorN structs.
+        const FromChannel* source = &reinterpret_cast<const FromChannel&>(pixel);
+        To result;
+        ToChannel* destination = &reinterpret_cast<ToChannel&>(result);
+
+        for(std::size_t i = 0 ; i < 3 ; ++i) { destination[i] = convert_channel<ToChannel>(source[i]); }
+
+        if constexpr(PixelTraits<To>::channels == 4) {
+            if constexpr(PixelTraits<From>::channels == 4) {
+                destination[3] = convert_channel<ToChannel>(source[3]);
+            } else {
+                destination[3] = convert_channel<ToChannel>(1.0f);
+            }
+        }
+
+        return result;
+    }
+}
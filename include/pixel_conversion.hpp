@@ -0,0 +1,57 @@
+/***************************************************************************************************
+ * @file  pixel_conversion.hpp
+ * @brief Declaration of vectorized conversions between 8-bit and floating-point channels
+ *
+ * The functions work on flat streams of channels, e.g. a row of RGB8 or vec3 pixels seen as 3 times
+ * as many channels. Each call dispatches to the widest instruction set available at runtime (see
+ * simd.hpp), and every instruction set gives the exact same results.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @enum ColorSpace
+ * @brief How the 8-bit values of an image file encode light intensities.
+ */
+enum class ColorSpace {
+    Linear, ///< Values are proportional to the intensities and are only rescaled.
+    SRGB    ///< Values follow the sRGB transfer curve, and are converted from or to linear values.
+};
+
+/**
+ * @brief Converts 8-bit channels in [0 ; 255] to floats in [0 ; 1].
+ * @param source A pointer to the first channel to convert.
+ * @param destination A pointer to the first converted channel.
+ * @param count The number of channels.
+ */
+void unorm8_to_float_n(const uint8_t* source, float* destination, std::size_t count);
+
+/**
+ * @brief Converts float channels in [0 ; 1] to 8-bit channels in [0 ; 255], clamping out of range
+ * values and rounding to the nearest. NaNs give 0.
+ * @param source A pointer to the first channel to convert.
+ * @param destination A pointer to the first converted channel.
+ * @param count The number of channels.
+ */
+void float_to_unorm8_n(const float* source, uint8_t* destination, std::size_t count);
+
+/**
+ * @brief Decodes 8-bit sRGB channels to linear floats in [0 ; 1], through a 256-entry lookup table.
+ * @param source A pointer to the first channel to convert.
+ * @param destination A pointer to the first converted channel.
+ * @param count The number of channels.
+ */
+void srgb8_to_linear_n(const uint8_t* source, float* destination, std::size_t count);
+
+/**
+ * @brief Encodes linear float channels in [0 ; 1] to 8-bit sRGB channels, clamping out of range
+ * values. NaNs give 0. The sRGB curve is approximated by 104 linear segments, so that the result is
+ * at most 0.6 away from the exact value before rounding, instead of 0.5.
+ * @param source A pointer to the first channel to convert.
+ * @param destination A pointer to the first converted channel.
+ * @param count The number of channels.
+ */
+void linear_to_srgb8_n(const float* source, uint8_t* destination, std::size_t count);
@@ -0,0 +1,32 @@
+/***************************************************************************************************
+ * @file  png.hpp
+ * @brief Declaration of a multithreaded PNG encoder
+ *
+ * The image is cut into bands of rows, which are filtered and compressed in parallel. Each band is a
+ * separately compressed piece of the zlib stream, ended by a sync flush, and is stored in its own
+ * IDAT chunk. The Adler-32 checksum of the stream is combined from the checksums of the bands.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * @brief Encodes 8-bit pixels to PNG.
+ * @param pixels A pointer to the first pixel of the first row, with interleaved channels.
+ * @param stride The distance in bytes between the starts of two consecutive rows. Can be negative to
+ * encode rows in reverse order.
+ * @param width The number of columns.
+ * @param height The number of rows.
+ * @param channels The number of channels: 1 (gray), 2 (gray and alpha), 3 (RGB) or 4 (RGBA).
+ * @param level The compression level, from 0 (no compression) to 9 (smallest files).
+ * @param pool The thread pool compressing the bands.
+ * @return The encoded data.
+ * @note Throws a std::runtime_error if the image is empty or the channel count is unsupported.
+ */
+std::vector<std::byte> png_encode(const uint8_t* pixels, std::ptrdiff_t stride, std::size_t width,
+                                  std::size_t height, std::size_t channels, int level, ThreadPool& pool);
@@ -0,0 +1,52 @@
+/***************************************************************************************************
+ * @file  qoi.hpp
+ * @brief Declaration of the encoder and decoder of the QOI image format
+ *
+ * QOI ("Quite OK Image", https://qoiformat.org) is a lossless format for 8-bit RGB and RGBA images
+ * that encodes and decodes an order of magnitude faster than PNG, at similar sizes.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @struct QoiHeader
+ * @brief The description of a QOI image, stored in the first 14 bytes of the file.
+ */
+struct QoiHeader {
+    uint32_t width;     ///< The number of columns.
+    uint32_t height;    ///< The number of rows.
+    uint8_t channels;   ///< The number of channels of the file: 3 (RGB) or 4 (RGBA).
+    uint8_t colorspace; ///< 0 if the color channels are sRGB, 1 if all channels are linear.
+};
+
+/**
+ * @brief Encodes pixels to QOI.
+ * @param pixels A pointer to the first pixel of the first row, with interleaved 8-bit channels.
+ * @param stride The distance in bytes between the starts of two consecutive rows. Can be negative to
+ * encode rows in reverse order.
+ * @param header The description of the image. Its channels are the ones of 'pixels'.
+ * @return The encoded data.
+ */
+std::vector<std::byte> qoi_encode(const uint8_t* pixels, std::ptrdiff_t stride, const QoiHeader& header);
+
+/**
+ * @brief Reads the header of QOI data.
+ * @param data The encoded data.
+ * @return The description of the image.
+ * @note Throws a std::runtime_error if the data is not valid QOI.
+ */
+QoiHeader qoi_read_header(std::span<const std::byte> data);
+
+/**
+ * @brief Decodes QOI data.
+ * @param data The encoded data.
+ * @param pixels Receives width * height pixels, tightly packed, with 'channels' channels.
+ * @param channels The number of channels to decode to: 3 (RGB) or 4 (RGBA), whatever the file has.
+ * @note Throws a std::runtime_error if the data is not valid QOI.
+ */
+void qoi_decode(std::span<const std::byte> data, uint8_t* pixels, std::size_t channels);
@@ -0,0 +1,63 @@
+/***************************************************************************************************
+ * @file  resample.hpp
+ * @brief Declaration of the separable resampling of images to other dimensions
+ *
+ * Every axis is resampled through a table of weights computed once per call: each destination pixel
+ * is the weighted sum of a fixed number of consecutive source pixels, clamped to the edges. When
+ * shrinking, filters are widened by the scale factor so that every source pixel contributes.
+ **************************************************************************************************/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include "Array2DView.hpp"
+#include "ThreadPool.hpp"
+#include "vec.hpp"
+
+/**
+ * @enum ResampleFilter
+ * @brief The filters images can be resampled with, from the fastest to the sharpest.
+ */
+enum class ResampleFilter {
+    Nearest,  ///< The source pixel closest to the destination one, without any filtering.
+    Bilinear, ///< A triangle of radius 1, a linear interpolation when enlarging.
+    Bicubic,  ///< Keys' cubic (a = -0.5, Catmull-Rom) of radius 2.
+    Mitchell, ///< Mitchell-Netravali's cubic (B = C = 1/3) of radius 2, smoother with less ringing.
+    Lanczos3  ///< A Lanczos-windowed sinc of radius 3, the sharpest.
+};
+
+/**
+ * @struct ResampleWeights
+ * @brief The weights resampling an axis: destination pixel j is the sum, for t in [0 ; taps), of
+ * weights[j * taps + t] times source pixel first[j] + t, clamped to the axis.
+ */
+struct ResampleWeights {
+    std::size_t taps = 0;              ///< Number of taps per destination pixel.
+    std::vector<std::ptrdiff_t> first; ///< The index of the first tap of every destination pixel.
+    std::vector<float> weights;        ///< The weight of every tap of every destination pixel.
+};
+
+/**
+ * @brief Computes the weights resampling an axis.
+ * @param source_size The number of source pixels.
+ * @param destination_size The number of destination pixels.
+ * @param filter The filter.
+ * @return The weights, normalized so that the weights of a pixel sum to 1.
+ */
+ResampleWeights compute_resample_weights(std::size_t source_size, std::size_t destination_size, ResampleFilter filter);
+
+/**
+ * @brief Resamples an image to the dimensions of the destination, by bands of destination rows
+ * processed in parallel. Each axis is resampled by its own pass, with vectorized kernels: the
+ * horizontal pass first when enlarging vertically, the vertical pass first otherwise, so that the
+ * horizontal pass, the costliest, always runs on the fewest rows.
+ * @param source The image to resample.
+ * @param destination The resampled image, which must not overlap the source.
+ * @param filter The filter.
+ * @param pool The pool to process the bands on.
+ * @note Does nothing if the destination is empty. Throws a std::invalid_argument if only the source
+ * is.
+ */
+void resample(Array2DView<const vec3> source, Array2DView<vec3> destination, ResampleFilter filter,
+              ThreadPool& pool = ThreadPool::get_global());
@@ -0,0 +1,42 @@
+/***************************************************************************************************
+ * @file  simd.hpp
+ * @brief Declaration of the runtime SIMD instruction set selection
+ **************************************************************************************************/
+
+#pragma once
+
+/**
+ * @enum SimdLevel
+ * @brief The instruction sets the vectorized kernels can be run with, from the most portable to the
+ * widest.
+ */
+enum class SimdLevel {
+    Scalar, ///< Plain scalar code.
+    SSE2,   ///< 128-bit vectors.
+    AVX2,   ///< 256-bit vectors.
+    AVX512  ///< 512-bit vectors (AVX-512F).
+};
+
+/**
+ * @return The widest instruction set supported by the CPU and the operating system.
+ */
+SimdLevel detect_simd_level();
+
+/**
+ * @return The instruction set the vectorized kernels currently dispatch to. Defaults to the
+ * detected one.
+ */
+SimdLevel get_simd_level();
+
+/**
+ * @brief Restricts the instruction set the vectorized kernels dispatch to, e.g. to compare paths.
+ * Levels wider than the detected one are clamped to it.
+ * @param level The wanted instruction set.
+ */
+void set_simd_level(SimdLevel level);
+
+/**
+ * @param level An instruction set.
+ * @return The name of the instruction set.
+ */
+const char* to_string(SimdLevel level);
@@ -0,0 +1,108 @@
+/***************************************************************************************************
+ * @file  AsyncImageWriter.cpp
+ * @brief Implementation of the AsyncImageWriter class
+ **************************************************************************************************/
+
+#include "AsyncImageWriter.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+AsyncImageWriter::AsyncImageWriter(const ImageWriteOptions& options, bool drop_stale)
+    : options(options), drop_stale(drop_stale) {
+    thread = std::thread(&AsyncImageWriter::work, this);
+}
+
+AsyncImageWriter::~AsyncImageWriter() {
+    {
+        std::lock_guard lock(mutex);
+        is_stopping = true;
+    }
+    condition.notify_all();
+    thread.join();
+}
+
+void AsyncImageWriter::submit(const Image& image, const std::filesystem::path& path) {
+    if(!image_format_from_extension(path)) {
+        throw std::runtime_error("Couldn't write image '" + path.string() + "': unknown extension");
+    }
+
+    std::unique_lock lock(mutex);
+    rethrow_error();
+
+    if(!drop_stale) {
+        condition.wait(lock, [this] { return !has_waiting; });
+    } else if(has_waiting) {
+        ++statistics.dropped;
+    }
+
+    // Copying reuses the staging image's buffer when it is large enough.
+    waiting = image;
+    waiting_path = path;
+    has_waiting = true;
+    ++statistics.submitted;
+    lock.unlock();
+
+    condition.notify_all();
+}
+
+void AsyncImageWriter::flush() {
+    std::unique_lock lock(mutex);
+    condition.wait(lock, [this] { return !has_waiting && !is_encoding; });
+    rethrow_error();
+}
+
+AsyncImageWriter::Statistics AsyncImageWriter::get_statistics() const {
+    std::lock_guard lock(mutex);
+    Statistics result = statistics;
+    result.queue_depth = static_cast<std::size_t>(has_waiting) + static_cast<std::size_t>(is_encoding);
+
+    return result;
+}
+
+void AsyncImageWriter::work() {
+    std::unique_lock lock(mutex);
+
+    while(true) {
+        condition.wait(lock, [this] { return has_waiting || is_stopping; });
+        if(!has_waiting) { return; }
+
+        // Swapping the staging images hands the snapshot over without copying it, and recycles the
+        // buffer of the previous one for the next submission.
+        std::swap(waiting, encoding);
+        std::filesystem::path path = std::move(waiting_path);
+        has_waiting = false;
+        is_encoding = true;
+        lock.unlock();
+        condition.notify_all();
+
+        std::exception_ptr failure;
+        auto start = std::chrono::steady_clock::now();
+        try {
+            encoding.write(path, options);
+        } catch(...) {
+            failure = std::current_exception();
+        }
+        std::chrono::duration<double> duration = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        is_encoding = false;
+        if(failure) {
+            error = failure;
+            ++statistics.failed;
+        } else {
+            ++statistics.written;
+            total_encode_time += duration.count();
+            statistics.last_encode_time = duration.count();
+            statistics.average_encode_time = total_encode_time / static_cast<double>(statistics.written);
+            statistics.max_encode_time = std::max(statistics.max_encode_time, duration.count());
+        }
+        condition.notify_all();
+    }
+}
+
+void AsyncImageWriter::rethrow_error() {
+    if(error) { std::rethrow_exception(std::exchange(error, nullptr)); }
+}
@@ -0,0 +1,258 @@
+/***************************************************************************************************
+ * @file  FFTPlan.cpp
+ * @brief Implementation of the FFTPlan class
+ **************************************************************************************************/
+
+#include "FFTPlan.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <stdexcept>
+
+namespace {
+    typedef std::complex<float> Complex;
+
+    /**
+     * @param a A complex number.
+     * @param b A complex number.
+     * @return The product of the numbers, without the recovery of infinities from NaN results of
+     * std::complex's operator*, which would keep the passes from being vectorized.
+     */
+    inline Complex multiply(Complex a, Complex b) {
+        return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+    }
+
+    /**
+     * @param value A complex number.
+     * @return The number times -i for forward transforms, times i for inverse ones.
+     */
+    template <bool inverse>
+    inline Complex rotate(Complex value) {
+        return inverse ? Complex(-value.imag(), value.real()) : Complex(value.imag(), -value.real());
+    }
+
+    /**
+     * @param value A twiddle factor of forward transforms.
+     * @return The twiddle factor for the direction of the transform.
+     */
+    template <bool inverse>
+    inline Complex directed(Complex value) {
+        return inverse ? std::conj(value) : value;
+    }
+
+    /**
+     * @brief Runs a pass of the transform: the 'radix' transforms of 'length' elements of each of
+     * the 'count' interleaved groups of the input are combined into transforms of 'radix * length'
+     * elements. Element j of transform q of group e is input[(j * radix + q) * count + e], and
+     * element j + length * t of the combined transform of group e is output[(j + length * t) * count + e].
+     * @param input The input of the pass.
+     * @param output The output of the pass.
+     * @param length The number of elements of the input transforms.
+     * @param count The number of interleaved groups, i.e. the number of transforms of the pass times
+     * the batch.
+     * @param twiddles The 'length * (radix - 1)' twiddle factors of the pass.
+     */
+    template <std::size_t radix, bool inverse>
+    void run_pass(const Complex* input, Complex* output, std::size_t length, std::size_t count, const Complex* twiddles) {
+        for(std::size_t j = 0 ; j < length ; ++j) {
+            Complex w[radix];
+            w[0] = Complex(1.0f, 0.0f);
+            for(std::size_t q = 1 ; q < radix ; ++q) { w[q] = directed<inverse>(twiddles[j * (radix - 1) + q - 1]); }
+
+            const Complex* in = input + j * radix * count;
+            Complex* out = output + j * count;
+            std::size_t step = length * count;
+
+            for(std::size_t e = 0 ; e < count ; ++e) {
+                Complex a[radix];
+                a[0] = in[e];
+                for(std::size_t q = 1 ; q < radix ; ++q) { a[q] = multiply(in[q * count + e], w[q]); }
+
+                if constexpr(radix == 2) {
+                    out[e] = a[0] + a[1];
+                    out[step + e] = a[0] - a[1];
+                } else if constexpr(radix == 3) {
+                    constexpr float half_sqrt3 = 0.86602540378443864676f;
+                    Complex sum = a[1] + a[2];
+                    Complex middle = a[0] - 0.5f * sum;
+                    Complex difference = rotate<inverse>(half_sqrt3 * (a[1] - a[2]));
+                    out[e] = a[0] + sum;
+                    out[step + e] = middle + difference;
+                    out[2 * step + e] = middle - difference;
+                } else if constexpr(radix == 4) {
+                    Complex t0 = a[0] + a[2];
+                    Complex t1 = a[0] - a[2];
+                    Complex t2 = a[1] + a[3];
+                    Complex t3 = rotate<inverse>(a[1] - a[3]);
+                    out[e] = t0 + t2;
+                    out[step + e] = t1 + t3;
+                    out[2 * step + e] = t0 - t2;
+                    out[3 * step + e] = t1 - t3;
+                } else if constexpr(radix == 5) {
+                    constexpr float cos1 = 0.30901699437494742410f;  // cos(2 pi / 5)
+                    constexpr float cos2 = -0.80901699437494742410f; // cos(4 pi / 5)
+                    constexpr float sin1 = 0.95105651629515357212f;  // sin(2 pi / 5)
+                    constexpr float sin2 = 0.58778525229247312917f;  // sin(4 pi / 5)
+                    Complex t1 = a[1] + a[4];
+                    Complex t2 = a[2] + a[3];
+                    Complex t3 = a[1] - a[4];
+                    Complex t4 = a[2] - a[3];
+                    Complex m1 = a[0] + cos1 * t1 + cos2 * t2;
+                    Complex m2 = a[0] + cos2 * t1 + cos1 * t2;
+                    Complex n1 = rotate<inverse>(sin1 * t3 + sin2 * t4);
+                    Complex n2 = rotate<inverse>(sin2 * t3 - sin1 * t4);
+                    out[e] = a[0] + t1 + t2;
+                    out[step + e] = m1 + n1;
+                    out[2 * step + e] = m2 + n2;
+                    out[3 * step + e] = m2 - n2;
+                    out[4 * step + e] = m1 - n1;
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Runs a pass of the transform for a radix other than 2, 3, 4 and 5, as a direct DFT of
+     * each group of 'radix' elements. See run_pass.
+     * @param radix The radix of the pass.
+     */
+    template <bool inverse>
+    void run_generic_pass(const Complex* input, Complex* output, std::size_t radix, std::size_t length,
+                          std::size_t count, const Complex* twiddles) {
+        const Complex* roots = twiddles + length * (radix - 1);
+        std::vector<Complex> a(radix);
+
+        for(std::size_t j = 0 ; j < length ; ++j) {
+            const Complex* in = input + j * radix * count;
+            Complex* out = output + j * count;
+            std::size_t step = length * count;
+
+            for(std::size_t e = 0 ; e < count ; ++e) {
+                a[0] = in[e];
+                for(std::size_t q = 1 ; q < radix ; ++q) {
+                    a[q] = multiply(in[q * count + e], directed<inverse>(twiddles[j * (radix - 1) + q - 1]));
+                }
+
+                for(std::size_t t = 0 ; t < radix ; ++t) {
+                    Complex sum = a[0];
+                    for(std::size_t q = 1 ; q < radix ; ++q) {
+                        sum += multiply(a[q], directed<inverse>(roots[q * t % radix]));
+                    }
+                    out[t * step + e] = sum;
+                }
+            }
+        }
+    }
+}
+
+FFTPlan::FFTPlan(std::size_t size) : size(size) {
+    if(size == 0) { throw std::invalid_argument("Couldn't plan an FFT of size 0"); }
+
+    // Radix 4 first, then 2 and the odd primes in increasing order.
+    std::vector<std::size_t> factors;
+    std::size_t remaining = size;
+    for(; remaining % 4 == 0 ; remaining /= 4) { factors.push_back(4); }
+    for(; remaining % 2 == 0 ; remaining /= 2) { factors.push_back(2); }
+    for(std::size_t p = 3 ; remaining > 1 ; p += 2) {
+        if(p * p > remaining) { p = remaining; }
+        for(; remaining % p == 0 ; remaining /= p) { factors.push_back(p); }
+    }
+
+    std::size_t twiddle_count = 0;
+    std::size_t length = 1;
+    for(std::size_t radix : factors) {
+        passes.push_back(Pass { radix, length, twiddle_count });
+        twiddle_count += length * (radix - 1) + (radix > 5 ? radix : 0);
+        length *= radix;
+    }
+
+    // The twiddle factor of element q of transform j is e^(-2 pi i q j / (radix * length)).
+    twiddles = Array<Complex>(twiddle_count, uninitialized);
+    auto root = [](std::size_t numerator, std::size_t denominator) {
+        double angle = -2.0 * std::numbers::pi * static_cast<double>(numerator) / static_cast<double>(denominator);
+        return Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    };
+    for(const Pass& pass : passes) {
+        Complex* pass_twiddles = twiddles.get_data() + pass.offset;
+        for(std::size_t j = 0 ; j < pass.length ; ++j) {
+            for(std::size_t q = 1 ; q < pass.radix ; ++q) {
+                pass_twiddles[j * (pass.radix - 1) + q - 1] = root(q * j, pass.radix * pass.length);
+            }
+        }
+        if(pass.radix > 5) {
+            Complex* roots = pass_twiddles + pass.length * (pass.radix - 1);
+            for(std::size_t m = 0 ; m < pass.radix ; ++m) { roots[m] = root(m, pass.radix); }
+        }
+    }
+}
+
+std::shared_ptr<const FFTPlan> FFTPlan::get(std::size_t size) {
+    static std::mutex mutex;
+    static std::map<std::size_t, std::shared_ptr<const FFTPlan>> plans;
+
+    std::lock_guard lock(mutex);
+    std::shared_ptr<const FFTPlan>& plan = plans[size];
+    if(!plan) { plan = std::make_shared<const FFTPlan>(size); }
+    return plan;
+}
+
+void FFTPlan::transform(Complex* data, Complex* scratch, FFTDirection direction, std::size_t batch) const {
+    Complex* input = data;
+    Complex* output = scratch;
+
+    for(const Pass& pass : passes) {
+        // The pass combines size / (radix * length) transforms per sequence.
+        std::size_t count = size / (pass.radix * pass.length) * batch;
+        const Complex* factors = twiddles.get_data() + pass.offset;
+        bool inverse = direction == FFTDirection::Inverse;
+
+        switch(pass.radix) {
+            case 2:
+                if(inverse) { run_pass<2, true>(input, output, pass.length, count, factors); }
+                else { run_pass<2, false>(input, output, pass.length, count, factors); }
+                break;
+            case 3:
+                if(inverse) { run_pass<3, true>(input, output, pass.length, count, factors); }
+                else { run_pass<3, false>(input, output, pass.length, count, factors); }
+                break;
+            case 4:
+                if(inverse) { run_pass<4, true>(input, output, pass.length, count, factors); }
+                else { run_pass<4, false>(input, output, pass.length, count, factors); }
+                break;
+            case 5:
+                if(inverse) { run_pass<5, true>(input, output, pass.length, count, factors); }
+                else { run_pass<5, false>(input, output, pass.length, count, factors); }
+                break;
+            default:
+                if(inverse) { run_generic_pass<true>(input, output, pass.radix, pass.length, count, factors); }
+                else { run_generic_pass<false>(input, output, pass.radix, pass.length, count, factors); }
+                break;
+        }
+
+        std::swap(input, output);
+    }
+
+    if(input != data) { std::copy_n(input, size * batch, data); }
+}
+
+void FFTPlan::transform(Array<Complex>& data, FFTDirection direction) const {
+    Array<Complex> scratch(size, uninitialized);
+    transform(data.get_data(), scratch.get_data(), direction);
+}
+
+std::size_t FFTPlan::get_size() const { return size; }
+
+std::size_t FFTPlan::get_fast_size(std::size_t size) {
+    std::size_t best = std::max<std::size_t>(size, 1);
+    while(true) {
+        std::size_t remaining = best;
+        for(std::size_t p : { 2, 3, 5 }) {
+            while(remaining % p == 0) { remaining /= p; }
+        }
+        if(remaining == 1) { return best; }
+        ++best;
+    }
+}
@@ -5,50 +5,116 @@
 
 #include "Image.hpp"
 
-#include <vector>
-#include "stb_image.h"
-#include "stb_image_write.h"
+#include <algorithm>
+#include <optional>
+#include <stdexcept>
+#include "parallel.hpp"
 
-Image::Image(const std::filesystem::path& path, bool flip_vertically) {
-    read(path, flip_vertically);
+Image::Image(const std::filesystem::path& path, bool flip_vertically, ColorSpace color_space,
+             std::pmr::memory_resource* resource)
+    : Array2D(resource) {
+    read(path, flip_vertically, color_space);
 }
 
-void Image::read(const std::filesystem::path& path, bool flip_vertically) {
+void Image::read(const std::filesystem::path& path, bool flip_vertically, ColorSpace color_space) {
     is_flipped = flip_vertically;
-    stbi_set_flip_vertically_on_load(flip_vertically);
 
-    int w, h, c;
-    const unsigned char* image_data = stbi_load(path.string().c_str(), &w, &h, &c, 3);
-    if(image_data == nullptr) { throw std::runtime_error("Couldn't load image '" + path.string() + '\''); }
+    // Float formats are read as they are, 8-bit ones are converted according to the color space.
+    std::optional<ImageFormat> format = image_format_from_extension(path);
+    bool floats = format.has_value() && stores_floats(*format);
+    assign_decoded(read_image_file(path, 3, floats ? sizeof(float) : 1, flip_vertically), color_space);
+}
 
-    resize(h, w);
-    for(std::size_t i = 0 ; i < height ; ++i) {
-        for(std::size_t j = 0 ; j < width ; ++j) {
-            std::size_t index = (i * width + j) * 3;
-
-            data[i][j] = vec3(
-                image_data[index] / 255.0f,
-                image_data[index + 1] / 255.0f,
-                image_data[index + 2] / 255.0f
-            );
+void Image::decode(std::span<const std::byte> data, bool flip_vertically, ColorSpace color_space) {
+    is_flipped = flip_vertically;
+
+    std::optional<ImageFormat> format = image_format_from_data(data);
+    bool floats = format.has_value() && stores_floats(*format);
+    assign_decoded(decode_image(data, 3, floats ? sizeof(float) : 1, flip_vertically), color_space);
+}
+
+std::vector<std::byte> Image::encode(ImageFormat format, const ImageWriteOptions& options) const {
+    return encode_image(format, reinterpret_cast<const float*>(get_data()), width, height, 3,
+                        stride * sizeof(vec3), is_flipped, options);
+}
+
+void Image::encode_to(std::ostream& output, ImageFormat format, const ImageWriteOptions& options) const {
+    encode_image(output, format, reinterpret_cast<const float*>(get_data()), width, height, 3,
+                 stride * sizeof(vec3), is_flipped, options);
+}
+
+ImagePyramid Image::build_pyramid(std::size_t levels, PyramidFilter filter) const {
+    return ImagePyramid(*this, levels, filter);
+}
+
+Image Image::resampled(std::size_t new_height, std::size_t new_width, ResampleFilter filter) const {
+    Image image(new_height, new_width, uninitialized, get_resource());
+    image.is_flipped = is_flipped;
+    resample(*this, image, filter);
+
+    return image;
+}
+
+ImageInfo Image::probe(const std::filesystem::path& path) {
+    return probe_image_file(path);
+}
+
+std::vector<std::pair<std::filesystem::path, ImageInfo>>
+Image::probe_directory(const std::filesystem::path& directory, bool recursive) {
+    std::vector<std::filesystem::path> paths;
+    auto collect = [&](auto&& iterator) {
+        for(const std::filesystem::directory_entry& entry : iterator) {
+            if(entry.is_regular_file()) { paths.push_back(entry.path()); }
         }
+    };
+    if(recursive) { collect(std::filesystem::recursive_directory_iterator(directory)); }
+    else { collect(std::filesystem::directory_iterator(directory)); }
+    std::sort(paths.begin(), paths.end());
+
+    // Probing is dominated by the latency of opening files, which overlaps well across threads.
+    std::vector<std::optional<ImageInfo>> infos(paths.size());
+    parallel_for(0, paths.size(), 16, [&](std::size_t begin, std::size_t end) {
+        for(std::size_t i = begin ; i < end ; ++i) {
+            try {
+                infos[i] = probe_image_file(paths[i]);
+            } catch(const std::runtime_error&) {
+                // Not an image.
+            }
+        }
+    });
+
+    std::vector<std::pair<std::filesystem::path, ImageInfo>> images;
+    for(std::size_t i = 0 ; i < paths.size() ; ++i) {
+        if(infos[i]) { images.emplace_back(std::move(paths[i]), *infos[i]); }
     }
+
+    return images;
 }
 
-void Image::write(const std::filesystem::path& path) {
-    std::vector<uint8_t> normalized_data;
-    normalized_data.reserve(height * width * 3);
+void Image::assign_decoded(const DecodedImage& image, ColorSpace color_space) {
+    bool floats = image.bytes_per_channel == sizeof(float);
 
+    // Every pixel is overwritten below, so there is no point in initializing them first.
+    Array2D::operator =(Array2D(image.height, image.width, uninitialized, get_resource()));
+    auto convert = color_space == ColorSpace::SRGB ? srgb8_to_linear_n : unorm8_to_float_n;
     for(std::size_t i = 0 ; i < height ; ++i) {
-        for(std::size_t j = 0 ; j < width ; ++j) {
-            const auto& [r, g, b] = data[i][j];
-
-            normalized_data.push_back(std::clamp(255.0f * r, 0.0f, 255.0f));
-            normalized_data.push_back(std::clamp(255.0f * g, 0.0f, 255.0f));
-            normalized_data.push_back(std::clamp(255.0f * b, 0.0f, 255.0f));
+        if(floats) {
+            const float* row = reinterpret_cast<const float*>(image.pixels.get()) + i * width * 3;
+            std::copy_n(row, width * 3, &data[i * stride].x);
+        } else {
+            convert(image.pixels.get() + i * width * 3, &data[i * stride].x, width * 3);
         }
     }
+}
+
+void Image::write(const std::filesystem::path& path, ColorSpace color_space) {
+    write(path, ImageWriteOptions { color_space });
+}
+
+void Image::write(const std::filesystem::path& path, const ImageWriteOptions& options) {
+    std::optional<ImageFormat> format = image_format_from_extension(path);
+    if(!format) { throw std::runtime_error("Couldn't write image '" + path.string() + "': unknown extension"); }
 
-    stbi_flip_vertically_on_write(is_flipped);
-    stbi_write_png(path.string().c_str(), width, height, 3, normalized_data.data(), width * 3);
+    write_image_file(path, *format, reinterpret_cast<const float*>(get_data()), width, height, 3,
+                     stride * sizeof(vec3), is_flipped, options);
 }
@@ -0,0 +1,253 @@
+/***************************************************************************************************
+ * @file  ImagePyramid.cpp
+ * @brief Implementation of the ImagePyramid class
+ **************************************************************************************************/
+
+#include "ImagePyramid.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <limits>
+#include <numbers>
+#include <numeric>
+#include "array_math.hpp"
+#include "parallel.hpp"
+
+namespace {
+    /// Radius of the Kaiser and Lanczos filters, in pixels of the level being built.
+    constexpr double windowed_radius = 3.0;
+
+    /// Levels with fewer pixels than this are built by a single thread, along with the following ones.
+    constexpr std::size_t parallel_pixels = 64 * 1024;
+
+    /**
+     * @struct AxisWeights
+     * @brief The taps halving one axis of a level: every pixel of the new level is the weighted sum
+     * of 'taps' pixels of the previous one.
+     */
+    struct AxisWeights {
+        std::size_t taps = 0;             ///< Number of taps per pixel.
+        std::vector<std::size_t> indices; ///< The index of every tap of every pixel, clamped to the axis.
+        std::vector<float> weights;       ///< The weight of every tap of every pixel.
+        bool is_uniform = false;          ///< Whether the taps of pixel j are those of pixel 0 shifted by 2j.
+        std::ptrdiff_t first_tap = 0;     ///< The unclamped index of the first tap of pixel 0, if uniform.
+    };
+
+    /**
+     * @param x A value.
+     * @return The normalized sinc of the value.
+     */
+    double sinc(double x) {
+        if(std::abs(x) < 1e-8) { return 1.0; }
+        x *= std::numbers::pi;
+        return std::sin(x) / x;
+    }
+
+    /**
+     * @param x A value.
+     * @return The zeroth order modified Bessel function of the first kind, from its power series.
+     */
+    double bessel_i0(double x) {
+        double sum = 1.0;
+        double term = 1.0;
+        for(int k = 1 ; term > sum * 1e-12 ; ++k) {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+        }
+        return sum;
+    }
+
+    /**
+     * @param filter A windowed filter.
+     * @param x The distance to the center of the filter, in pixels of the level being built.
+     * @return The unnormalized weight of the filter at that distance.
+     */
+    double windowed_weight(PyramidFilter filter, double x) {
+        if(std::abs(x) >= windowed_radius) { return 0.0; }
+
+        if(filter == PyramidFilter::Lanczos) { return sinc(x) * sinc(x / windowed_radius); }
+
+        constexpr double alpha = 4.0;
+        double ratio = x / windowed_radius;
+        return sinc(x) * bessel_i0(alpha * std::sqrt(1.0 - ratio * ratio)) / bessel_i0(alpha);
+    }
+
+    /**
+     * @brief Computes the taps halving an axis.
+     * @param size The number of pixels of the axis in the previous level.
+     * @param filter The filter halving the level.
+     * @return The taps of every pixel of the axis in the new level.
+     */
+    AxisWeights compute_axis_weights(std::size_t size, PyramidFilter filter) {
+        std::size_t new_size = std::max<std::size_t>(size / 2, 1);
+        double scale = static_cast<double>(size) / static_cast<double>(new_size);
+
+        // The range of pixels of the previous level each pixel of the new one covers or sees.
+        double radius = filter == PyramidFilter::Box ? 0.5 * scale : windowed_radius * scale;
+        auto first_of = [&](std::size_t j) {
+            return static_cast<std::ptrdiff_t>(std::floor((j + 0.5) * scale - radius + 1e-9));
+        };
+        auto end_of = [&](std::size_t j) {
+            return static_cast<std::ptrdiff_t>(std::ceil((j + 0.5) * scale + radius - 1e-9));
+        };
+
+        AxisWeights axis;
+        for(std::size_t j = 0 ; j < new_size ; ++j) {
+            axis.taps = std::max(axis.taps, static_cast<std::size_t>(end_of(j) - first_of(j)));
+        }
+        axis.indices.resize(new_size * axis.taps);
+        axis.weights.resize(new_size * axis.taps);
+        axis.is_uniform = scale == 2.0;
+        axis.first_tap = first_of(0);
+
+        std::vector<double> weights(axis.taps);
+        for(std::size_t j = 0 ; j < new_size ; ++j) {
+            double center = (j + 0.5) * scale;
+            std::ptrdiff_t first = first_of(j);
+
+            for(std::size_t t = 0 ; t < axis.taps ; ++t) {
+                double pixel = static_cast<double>(first + static_cast<std::ptrdiff_t>(t));
+                if(filter == PyramidFilter::Box) {
+                    // The part of the pixel covered by the new one, which gives 1/2, 1/2 for even sizes.
+                    double overlap = std::min(pixel + 1.0, center + radius) - std::max(pixel, center - radius);
+                    weights[t] = std::max(overlap, 0.0);
+                } else {
+                    weights[t] = windowed_weight(filter, (pixel + 0.5 - center) / scale);
+                }
+            }
+
+            double sum = std::accumulate(weights.begin(), weights.end(), 0.0);
+            for(std::size_t t = 0 ; t < axis.taps ; ++t) {
+                std::ptrdiff_t index = std::clamp<std::ptrdiff_t>(first + static_cast<std::ptrdiff_t>(t), 0,
+                                                                  static_cast<std::ptrdiff_t>(size) - 1);
+                axis.indices[j * axis.taps + t] = static_cast<std::size_t>(index);
+                axis.weights[j * axis.taps + t] = static_cast<float>(weights[t] / sum);
+            }
+        }
+
+        return axis;
+    }
+
+    /**
+     * @brief Halves a level.
+     * @param source The previous level.
+     * @param destination The new level.
+     * @param filter The filter halving the level.
+     * @param parallel Whether to filter rows in parallel.
+     */
+    void halve(Array2DView<const vec3> source, Array2DView<vec3> destination, PyramidFilter filter, bool parallel) {
+        AxisWeights rows = compute_axis_weights(source.get_height(), filter);
+        AxisWeights columns = compute_axis_weights(source.get_width(), filter);
+        std::size_t width = source.get_width();
+        std::size_t new_width = destination.get_width();
+
+        // Uniform columns are filtered at every pixel of a row padded with its edge pixels, with a
+        // vectorized correlation, then every other pixel is kept.
+        std::size_t padding = columns.first_tap < 0 ? static_cast<std::size_t>(-columns.first_tap) : 0;
+        std::size_t padded_width = std::max(width, 2 * new_width + columns.taps) + 2 * padding;
+
+        auto filter_rows = [&](std::size_t begin, std::size_t end) {
+            Array<float> row(3 * width, uninitialized);
+            Array<float> padded(columns.is_uniform ? 3 * padded_width : 0, uninitialized);
+            Array<float> filtered(columns.is_uniform ? 3 * 2 * new_width : 0, uninitialized);
+            std::vector<const float*> sources(rows.taps);
+
+            for(std::size_t i = begin ; i < end ; ++i) {
+                for(std::size_t t = 0 ; t < rows.taps ; ++t) {
+                    sources[t] = &source[rows.indices[i * rows.taps + t]][0].x;
+                }
+                weighted_sum_n(sources.data(), &rows.weights[i * rows.taps], rows.taps, row.get_data(), 3 * width);
+                const vec3* pixels = reinterpret_cast<const vec3*>(row.get_data());
+
+                vec3* output = &destination[i][0];
+                if(columns.is_uniform) {
+                    vec3* padded_pixels = reinterpret_cast<vec3*>(padded.get_data());
+                    std::fill_n(padded_pixels, padding, pixels[0]);
+                    std::copy_n(pixels, width, padded_pixels + padding);
+                    std::fill(padded_pixels + padding + width, padded_pixels + padded_width, pixels[width - 1]);
+
+                    // Pixel j of the new row starts its taps at pixel 2j + first_tap of the row.
+                    std::ptrdiff_t offset = columns.first_tap + static_cast<std::ptrdiff_t>(padding);
+                    correlate_n(padded.get_data() + 3 * offset, 3, columns.weights.data(), columns.taps,
+                                filtered.get_data(), 3 * (2 * new_width - 1));
+                    const vec3* filtered_pixels = reinterpret_cast<const vec3*>(filtered.get_data());
+                    for(std::size_t j = 0 ; j < new_width ; ++j) { output[j] = filtered_pixels[2 * j]; }
+                } else {
+                    for(std::size_t j = 0 ; j < new_width ; ++j) {
+                        vec3 sum(0.0f);
+                        for(std::size_t t = 0 ; t < columns.taps ; ++t) {
+                            sum += columns.weights[j * columns.taps + t] * pixels[columns.indices[j * columns.taps + t]];
+                        }
+                        output[j] = sum;
+                    }
+                }
+
+                if(filter != PyramidFilter::Box) {
+                    clamp_n(&output->x, 3 * new_width, 0.0f, std::numeric_limits<float>::infinity());
+                }
+            }
+        };
+
+        if(parallel) {
+            std::size_t grain = std::max<std::size_t>(default_tile_bytes / (sizeof(vec3) * width), 1);
+            parallel_for(0, destination.get_height(), grain, filter_rows);
+        } else {
+            filter_rows(0, destination.get_height());
+        }
+    }
+}
+
+ImagePyramid::ImagePyramid() { }
+
+ImagePyramid::ImagePyramid(Array2DView<const vec3> image, std::size_t levels, PyramidFilter filter) {
+    if(image.empty()) { return; }
+
+    std::size_t full_count = get_full_level_count(image.get_width(), image.get_height());
+    std::size_t count = levels == 0 ? full_count : std::min(levels, full_count);
+
+    // Levels start on aligned boundaries, so that their rows can be loaded with aligned instructions.
+    constexpr std::size_t step = std::lcm(sizeof(vec3), Array<vec3>::alignment) / sizeof(vec3);
+    std::size_t offset = 0;
+    std::size_t height = image.get_height();
+    std::size_t width = image.get_width();
+    for(std::size_t l = 0 ; l < count ; ++l) {
+        this->levels.push_back(Level { offset, height, width });
+        offset += (height * width + step - 1) / step * step;
+        height = std::max<std::size_t>(height / 2, 1);
+        width = std::max<std::size_t>(width / 2, 1);
+    }
+    storage = Array<vec3>(offset, uninitialized);
+
+    Array2DView<vec3> first = (*this)[0];
+    for(std::size_t i = 0 ; i < image.get_height() ; ++i) { std::ranges::copy(image[i], first[i].begin()); }
+
+    for(std::size_t l = 1 ; l < count ; ++l) {
+        if(this->levels[l].height * this->levels[l].width >= parallel_pixels) {
+            halve((*this)[l - 1], (*this)[l], filter, true);
+        } else {
+            // The remaining levels are too small for their rows to be worth distributing.
+            for(; l < count ; ++l) { halve((*this)[l - 1], (*this)[l], filter, false); }
+        }
+    }
+}
+
+Array2DView<vec3> ImagePyramid::operator[](std::size_t level) {
+    const Level& place = levels[level];
+    return Array2DView<vec3>(storage.get_data() + place.offset, place.height, place.width);
+}
+
+Array2DView<const vec3> ImagePyramid::operator[](std::size_t level) const {
+    const Level& place = levels[level];
+    return Array2DView<const vec3>(storage.get_data() + place.offset, place.height, place.width);
+}
+
+std::size_t ImagePyramid::get_level_count() const { return levels.size(); }
+
+const Array<vec3>& ImagePyramid::get_storage() const { return storage; }
+
+std::size_t ImagePyramid::get_offset(std::size_t level) const { return levels[level].offset; }
+
+std::size_t ImagePyramid::get_full_level_count(std::size_t width, std::size_t height) {
+    return std::bit_width(std::max(width, height));
+}
@@ -0,0 +1,157 @@
+/***************************************************************************************************
+ * @file  MappedFile.cpp
+ * @brief Implementation of the MappedFile class
+ **************************************************************************************************/
+
+#include "MappedFile.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Throws a runtime_error describing a system error.
+ * @param message What couldn't be done.
+ * @param path The path of the file concerned.
+ * @param error The error number, the last one by default. Must be saved before any other system call
+ * that could overwrite errno, e.g. closing the file.
+ */
+[[noreturn]] static void throw_system_error(const std::string& message, const std::filesystem::path& path,
+                                            int error = errno) {
+    throw std::runtime_error(message + " '" + path.string() + "': " + std::strerror(error));
+}
+
+/**
+ * @brief Maps 'size' bytes of an open file and closes it.
+ * @param descriptor The file descriptor.
+ * @param size The number of bytes to map.
+ * @param mode The access rights of the mapping.
+ * @param path The path of the file, for error messages.
+ * @return A pointer to the mapping, or nullptr if 'size' is 0.
+ */
+static std::byte* map_and_close(int descriptor, std::size_t size, MapMode mode,
+                                const std::filesystem::path& path) {
+    void* mapping = nullptr;
+    int error = 0;
+
+    if(size > 0) {
+        int protection = mode == MapMode::ReadWrite ? PROT_READ | PROT_WRITE : PROT_READ;
+        mapping = mmap(nullptr, size, protection, MAP_SHARED, descriptor, 0);
+        error = errno;
+    }
+
+    // The mapping keeps its own reference to the file.
+    close(descriptor);
+
+    if(mapping == MAP_FAILED) { throw_system_error("Couldn't map file", path, error); }
+    return static_cast<std::byte*>(mapping);
+}
+
+MappedFile::MappedFile() : data(nullptr), size(0), mode(MapMode::ReadOnly) { }
+
+MappedFile::MappedFile(const std::filesystem::path& path, MapMode mode)
+    : data(nullptr), size(0), mode(mode) {
+    int descriptor = open(path.c_str(), mode == MapMode::ReadWrite ? O_RDWR : O_RDONLY);
+    if(descriptor == -1) { throw_system_error("Couldn't open file", path); }
+
+    struct stat status;
+    if(fstat(descriptor, &status) == -1) {
+        int error = errno;
+        close(descriptor);
+        throw_system_error("Couldn't get the size of file", path, error);
+    }
+
+    size = status.st_size;
+    data = map_and_close(descriptor, size, mode, path);
+}
+
+MappedFile::MappedFile(const std::filesystem::path& path, std::size_t size)
+    : data(nullptr), size(size), mode(MapMode::ReadWrite) {
+    int descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(descriptor == -1) { throw_system_error("Couldn't create file", path); }
+
+    if(ftruncate(descriptor, size) == -1) {
+        int error = errno;
+        close(descriptor);
+        throw_system_error("Couldn't resize file", path, error);
+    }
+
+    data = map_and_close(descriptor, size, mode, path);
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data(std::exchange(other.data, nullptr)), size(std::exchange(other.size, 0)), mode(other.mode) { }
+
+MappedFile::~MappedFile() {
+    unmap();
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    if(this == &other) { return *this; }
+
+    unmap();
+    data = std::exchange(other.data, nullptr);
+    size = std::exchange(other.size, 0);
+    mode = other.mode;
+
+    return *this;
+}
+
+std::byte* MappedFile::get_data() const { return data; }
+
+std::size_t MappedFile::get_size() const { return size; }
+
+MapMode MappedFile::get_mode() const { return mode; }
+
+void MappedFile::advise(MapAdvice advice) const {
+    advise(advice, 0, size);
+}
+
+void MappedFile::advise(MapAdvice advice, std::size_t offset, std::size_t size) const {
+    if(data == nullptr) { return; }
+
+    std::size_t page_size = get_page_size();
+    std::size_t begin = (offset + page_size - 1) / page_size * page_size;
+    std::size_t end = std::min(offset + size, this->size);
+    end = end == this->size ? end : end / page_size * page_size;
+    if(begin >= end) { return; }
+
+    int flag = MADV_NORMAL;
+    switch(advice) {
+        case MapAdvice::Normal: flag = MADV_NORMAL; break;
+        case MapAdvice::Sequential: flag = MADV_SEQUENTIAL; break;
+        case MapAdvice::Random: flag = MADV_RANDOM; break;
+        case MapAdvice::WillNeed: flag = MADV_WILLNEED; break;
+        case MapAdvice::DontNeed: flag = MADV_DONTNEED; break;
+    }
+
+    if(madvise(data + begin, end - begin, flag) == -1) {
+        throw std::runtime_error(std::string("Couldn't advise mapping: ") + std::strerror(errno));
+    }
+}
+
+std::size_t MappedFile::get_page_size() {
+    static const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    return page_size;
+}
+
+void MappedFile::flush() const {
+    if(data == nullptr || mode == MapMode::ReadOnly) { return; }
+
+    if(msync(data, size, MS_SYNC) == -1) {
+        throw std::runtime_error(std::string("Couldn't flush mapping: ") + std::strerror(errno));
+    }
+}
+
+void MappedFile::unmap() {
+    if(data != nullptr) { munmap(data, size); }
+    data = nullptr;
+    size = 0;
+}
@@ -0,0 +1,68 @@
+/***************************************************************************************************
+ * @file  PixelImage.cpp
+ * @brief Implementation of the PixelImage class
+ **************************************************************************************************/
+
+#include "PixelImage.hpp"
+
+#include <optional>
+#include <stdexcept>
+
+template <PixelFormat Pixel>
+void PixelImage<Pixel>::read(const std::filesystem::path& path, bool flip_vertically) {
+    constexpr std::size_t channels = PixelTraits<Pixel>::channels;
+    using Channel = PixelTraits<Pixel>::Channel;
+
+    // 8-bit formats are loaded as they are, 16-bit formats from 16 bits, and float formats from float
+    // files as they are and from 16 bits otherwise, to keep the precision of 16-bit files.
+    std::size_t bytes_per_channel = sizeof(Channel) == 1 ? 1 : 2;
+    if constexpr(std::is_floating_point_v<Channel>) {
+        std::optional<ImageFormat> format = image_format_from_extension(path);
+        if(format.has_value() && stores_floats(*format)) { bytes_per_channel = sizeof(float); }
+    }
+
+    is_flipped = flip_vertically;
+    DecodedImage image = read_image_file(path, channels, bytes_per_channel, flip_vertically);
+
+    // Every pixel is overwritten below, so there is no point in initializing them first.
+    Array2D<Pixel>::operator =(Array2D<Pixel>(image.height, image.width, uninitialized, this->get_resource()));
+
+    auto convert_from = [&]<typename Source>() {
+        convert_pixels(Array2DView<const Source>(reinterpret_cast<const Source*>(image.pixels.get()), image.height, image.width),
+                       Array2DView<Pixel>(*this));
+    };
+    if(image.bytes_per_channel == 1) { convert_from.template operator()<Pixel>(); }
+    else if(image.bytes_per_channel == 2) { convert_from.template operator()<RGB16>(); }
+    else { convert_from.template operator()<RGB32F>(); }
+}
+
+template <PixelFormat Pixel>
+void PixelImage<Pixel>::write(const std::filesystem::path& path, const ImageWriteOptions& options) const {
+    constexpr std::size_t channels = PixelTraits<Pixel>::channels;
+    using Channel = PixelTraits<Pixel>::Channel;
+
+    std::optional<ImageFormat> format = image_format_from_extension(path);
+    if(!format) { throw std::runtime_error("Couldn't write image '" + path.string() + "': unknown extension"); }
+
+    // 8-bit and float rows are written straight from the pixel buffer, 16-bit ones are converted.
+    if constexpr(std::is_same_v<Channel, uint8_t>) {
+        write_image_file(path, *format, reinterpret_cast<const uint8_t*>(this->get_data()), this->width, this->height,
+                         channels, this->stride * sizeof(Pixel), is_flipped, options);
+    } else if constexpr(std::is_same_v<Channel, float>) {
+        write_image_file(path, *format, reinterpret_cast<const float*>(this->get_data()), this->width, this->height,
+                         channels, this->stride * sizeof(Pixel), is_flipped, options);
+    } else if(stores_floats(*format)) {
+        PixelImage<RGB32F> converted(*this);
+        write_image_file(path, *format, reinterpret_cast<const float*>(converted.get_data()), this->width,
+                         this->height, channels, converted.get_stride() * sizeof(RGB32F), is_flipped, options);
+    } else {
+        PixelImage<RGB8> converted(*this);
+        write_image_file(path, *format, reinterpret_cast<const uint8_t*>(converted.get_data()), this->width,
+                         this->height, channels, converted.get_stride() * sizeof(RGB8), is_flipped, options);
+    }
+}
+
+template class PixelImage<RGB8>;
+template class PixelImage<RGBA8>;
+template class PixelImage<RGB16>;
+template class PixelImage<RGB32F>;
@@ -0,0 +1,112 @@
+/***************************************************************************************************
+ * @file  RealFFTPlan.cpp
+ * @brief Implementation of the RealFFTPlan class
+ **************************************************************************************************/
+
+#include "RealFFTPlan.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <numbers>
+#include <stdexcept>
+
+namespace {
+    typedef std::complex<float> Complex;
+
+    /**
+     * @param a A complex number.
+     * @param b A complex number.
+     * @return The product of the numbers, without the recovery of infinities from NaN results of
+     * std::complex's operator*.
+     */
+    inline Complex multiply(Complex a, Complex b) {
+        return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+    }
+}
+
+RealFFTPlan::RealFFTPlan(std::size_t size) : size(size) {
+    if(size == 0) { throw std::invalid_argument("Couldn't plan an FFT of size 0"); }
+
+    if(size % 2 != 0) {
+        plan = FFTPlan::get(size);
+        return;
+    }
+
+    std::size_t half = size / 2;
+    plan = FFTPlan::get(half);
+    twiddles = Array<Complex>(half, uninitialized);
+    for(std::size_t k = 0 ; k < half ; ++k) {
+        double angle = -2.0 * std::numbers::pi * static_cast<double>(k) / static_cast<double>(size);
+        twiddles[k] = Complex(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+}
+
+std::shared_ptr<const RealFFTPlan> RealFFTPlan::get(std::size_t size) {
+    static std::mutex mutex;
+    static std::map<std::size_t, std::shared_ptr<const RealFFTPlan>> plans;
+
+    std::lock_guard lock(mutex);
+    std::shared_ptr<const RealFFTPlan>& plan = plans[size];
+    if(!plan) { plan = std::make_shared<const RealFFTPlan>(size); }
+    return plan;
+}
+
+void RealFFTPlan::forward(const float* input, Complex* output, Complex* scratch) const {
+    if(size % 2 != 0) {
+        for(std::size_t j = 0 ; j < size ; ++j) { scratch[j] = Complex(input[j], 0.0f); }
+        plan->transform(scratch, scratch + size, FFTDirection::Forward);
+        std::copy_n(scratch, size / 2 + 1, output);
+        return;
+    }
+
+    // z[j] = x[2j] + i x[2j + 1] is transformed, then split into the spectra of the even and odd
+    // elements, E[k] = (Z[k] + conj(Z[half - k])) / 2 and O[k] = (Z[k] - conj(Z[half - k])) / 2i,
+    // which give X[k] = E[k] + e^(-2 pi i k / size) O[k] and X[half - k] = conj(E[k] - e^(...) O[k]).
+    std::size_t half = size / 2;
+    std::copy_n(input, size, reinterpret_cast<float*>(output));
+    plan->transform(output, scratch, FFTDirection::Forward);
+
+    Complex first = output[0];
+    output[0] = Complex(first.real() + first.imag(), 0.0f);
+    output[half] = Complex(first.real() - first.imag(), 0.0f);
+
+    for(std::size_t k = 1 ; k <= half / 2 ; ++k) {
+        Complex z = output[k];
+        Complex mirrored = std::conj(output[half - k]);
+        Complex even = 0.5f * (z + mirrored);
+        Complex difference = 0.5f * (z - mirrored);
+        Complex odd = multiply(Complex(difference.imag(), -difference.real()), twiddles[k]);
+
+        output[k] = even + odd;
+        output[half - k] = std::conj(even - odd);
+    }
+}
+
+void RealFFTPlan::inverse(const Complex* input, float* output, Complex* scratch) const {
+    if(size % 2 != 0) {
+        std::copy_n(input, size / 2 + 1, scratch);
+        for(std::size_t k = size / 2 + 1 ; k < size ; ++k) { scratch[k] = std::conj(input[size - k]); }
+        plan->transform(scratch, scratch + size, FFTDirection::Inverse);
+        for(std::size_t j = 0 ; j < size ; ++j) { output[j] = scratch[j].real(); }
+        return;
+    }
+
+    // The spectra of the even and odd elements, recombined into the spectrum of z, twice since the
+    // half-size inverse transform multiplies by half the size.
+    std::size_t half = size / 2;
+    for(std::size_t k = 0 ; k < half ; ++k) {
+        Complex x = input[k];
+        Complex mirrored = std::conj(input[half - k]);
+        Complex odd = multiply(x - mirrored, std::conj(twiddles[k]));
+        scratch[k] = x + mirrored + Complex(-odd.imag(), odd.real());
+    }
+
+    plan->transform(scratch, scratch + half, FFTDirection::Inverse);
+    std::copy_n(reinterpret_cast<const float*>(scratch), size, output);
+}
+
+std::size_t RealFFTPlan::get_size() const { return size; }
+
+std::size_t RealFFTPlan::get_scratch_size() const { return size % 2 == 0 ? size : 2 * size; }
@@ -0,0 +1,155 @@
+/***************************************************************************************************
+ * @file  ThreadPool.cpp
+ * @brief Implementation of the ThreadPool class
+ **************************************************************************************************/
+
+#include "ThreadPool.hpp"
+
+#include <algorithm>
+#include <exception>
+
+/// The pool the calling thread works for, if any.
+static thread_local const ThreadPool* current_pool = nullptr;
+
+/// The index of the calling thread's deque in 'current_pool'.
+static thread_local std::size_t current_worker = 0;
+
+struct ThreadPool::Loop {
+    ChunkFunction function;             ///< The function to call on each chunk.
+    void* context;                      ///< The context of the function.
+    std::size_t grain;                  ///< The maximum length of a chunk.
+    std::atomic<std::size_t> remaining; ///< Number of ranges not processed yet.
+    std::mutex error_mutex;             ///< Protects 'error'.
+    std::exception_ptr error;           ///< The first exception thrown by the function.
+};
+
+ThreadPool::ThreadPool(std::size_t thread_count)
+    : pending(0), stopping(false) {
+    thread_count = std::max<std::size_t>(thread_count, 1);
+
+    for(std::size_t i = 0 ; i < thread_count ; ++i) { workers.push_back(std::make_unique<Worker>()); }
+    for(std::size_t i = 1 ; i < thread_count ; ++i) { threads.emplace_back(&ThreadPool::work, this, i); }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(sleep_mutex);
+        stopping = true;
+    }
+    wake_up.notify_all();
+
+    for(std::thread& thread : threads) { thread.join(); }
+}
+
+std::size_t ThreadPool::get_thread_count() const {
+    return workers.size();
+}
+
+ThreadPool& ThreadPool::get_global() {
+    static ThreadPool pool;
+    return pool;
+}
+
+std::size_t ThreadPool::default_thread_count() {
+    return std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+void ThreadPool::run_loop(std::size_t begin, std::size_t end, std::size_t grain, ChunkFunction function,
+                          void* context) {
+    if(begin >= end) { return; }
+
+    Loop loop { function, context, std::max<std::size_t>(grain, 1), 1, {}, nullptr };
+    split(loop, begin, end);
+
+    // Once there is nothing left to help with, the last chunks run on other threads: the caller
+    // sleeps until the last one wakes it up.
+    while(true) {
+        std::size_t remaining = loop.remaining.load(std::memory_order_acquire);
+        if(remaining == 0) { break; }
+        if(!try_run_one()) { loop.remaining.wait(remaining, std::memory_order_acquire); }
+    }
+
+    if(loop.error) { std::rethrow_exception(loop.error); }
+}
+
+void ThreadPool::split(Loop& loop, std::size_t begin, std::size_t end) {
+    while(end - begin > loop.grain) {
+        std::size_t middle = begin + (end - begin) / 2;
+        loop.remaining.fetch_add(1, std::memory_order_relaxed);
+        push([this, &loop, middle, end] { split(loop, middle, end); });
+        end = middle;
+    }
+
+    try {
+        loop.function(loop.context, begin, end);
+    } catch(...) {
+        std::lock_guard lock(loop.error_mutex);
+        if(!loop.error) { loop.error = std::current_exception(); }
+    }
+
+    if(loop.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) { loop.remaining.notify_all(); }
+}
+
+void ThreadPool::push(std::function<void()> task) {
+    Worker& worker = *workers[current_index()];
+    {
+        std::lock_guard lock(worker.mutex);
+        worker.tasks.push_back(std::move(task));
+    }
+
+    pending.fetch_add(1, std::memory_order_release);
+
+    // Taking the lock makes sure a worker checking 'pending' before sleeping can't miss the wake up.
+    { std::lock_guard lock(sleep_mutex); }
+    wake_up.notify_one();
+}
+
+bool ThreadPool::try_run_one() {
+    if(pending.load(std::memory_order_acquire) == 0) { return false; }
+
+    std::size_t index = current_index();
+    std::function<void()> task;
+
+    // Own tasks are taken from the back, they are the newest and smallest, and likely in cache.
+    {
+        Worker& worker = *workers[index];
+        std::lock_guard lock(worker.mutex);
+        if(!worker.tasks.empty()) {
+            task = std::move(worker.tasks.back());
+            worker.tasks.pop_back();
+        }
+    }
+
+    // Stolen tasks are taken from the front, they are the oldest and largest.
+    for(std::size_t offset = 1 ; !task && offset < workers.size() ; ++offset) {
+        Worker& victim = *workers[(index + offset) % workers.size()];
+        std::lock_guard lock(victim.mutex);
+        if(!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+        }
+    }
+
+    if(!task) { return false; }
+
+    pending.fetch_sub(1, std::memory_order_relaxed);
+    task();
+    return true;
+}
+
+std::size_t ThreadPool::current_index() const {
+    return current_pool == this ? current_worker : 0;
+}
+
+void ThreadPool::work(std::size_t index) {
+    current_pool = this;
+    current_worker = index;
+
+    while(true) {
+        if(try_run_one()) { continue; }
+
+        std::unique_lock lock(sleep_mutex);
+        wake_up.wait(lock, [this] { return stopping || pending.load(std::memory_order_acquire) > 0; });
+        if(stopping) { return; }
+    }
+}
@@ -0,0 +1,217 @@
+/***************************************************************************************************
+ * @file  TiledImage.cpp
+ * @brief Implementation of the TiledImage class
+ **************************************************************************************************/
+
+#include "TiledImage.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unistd.h>
+#include "Image.hpp"
+
+namespace {
+    /**
+     * @brief Creates a scratch file, maps it and deletes it, so that it only lives as long as the
+     * mapping.
+     * @param directory The directory to create the file in, the temporary directory if empty.
+     * @param size The size of the file in bytes.
+     * @return The mapping of the file.
+     */
+    MappedFile create_scratch_file(const std::filesystem::path& directory, std::size_t size) {
+        static std::atomic<std::size_t> counter = 0;
+
+        std::filesystem::path path = directory.empty() ? std::filesystem::temp_directory_path() : directory;
+        path /= "tiled-image-" + std::to_string(getpid()) + '-' + std::to_string(counter++) + ".scratch";
+
+        // The file is zero-filled without being written, so its blocks are only allocated on spills.
+        MappedFile file(path, size);
+        std::filesystem::remove(path);
+
+        return file;
+    }
+}
+
+TiledImage::TiledImage(std::size_t height, std::size_t width, const TiledImageOptions& options)
+    : height(height), width(width), tile_size(std::max<std::size_t>(options.tile_size, 1)),
+      tile_rows((height + tile_size - 1) / tile_size), tile_columns((width + tile_size - 1) / tile_size),
+      max_resident(std::max<std::size_t>(options.max_resident_tiles, 1)),
+      tiles(tile_rows * tile_columns) {
+    std::size_t page_size = MappedFile::get_page_size();
+    tile_bytes = (tile_size * tile_size * sizeof(vec3) + page_size - 1) / page_size * page_size;
+
+    scratch = create_scratch_file(options.scratch_directory, tiles.size() * tile_bytes);
+}
+
+TiledImage::TiledImage(const std::filesystem::path& path, ColorSpace color_space, const TiledImageOptions& options)
+    : TiledImage(probe_image_file(path), options) {
+    std::optional<ImageFormat> format = image_format_from_extension(path);
+    if(format && supports_bands(*format)) {
+        // Bands of a tile's height fill a row of tiles at a time.
+        read_image_bands(path, tile_size, color_space, [&](std::size_t row, std::size_t rows, const float* pixels) {
+            write_region(row, 0, Array2DView<const vec3>(reinterpret_cast<const vec3*>(pixels), rows, width));
+        });
+    } else {
+        Image image(path, false, color_space);
+        write_region(0, 0, image);
+    }
+}
+
+TiledImage::TiledImage(const ImageInfo& info, const TiledImageOptions& options)
+    : TiledImage(info.height, info.width, options) { }
+
+void TiledImage::read_region(std::ptrdiff_t row, std::ptrdiff_t column, Array2DView<vec3> destination) const {
+    if(destination.empty()) { return; }
+    if(height == 0 || width == 0) { throw std::out_of_range("Couldn't read region of an empty tiled image"); }
+
+    // The part of the image closest to the region, which is copied, then its edges replicated.
+    auto clamp_range = [](std::ptrdiff_t first, std::size_t count, std::size_t size) {
+        auto clamp = [&](std::ptrdiff_t index) {
+            return static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(index, 0, static_cast<std::ptrdiff_t>(size) - 1));
+        };
+        std::size_t begin = clamp(first);
+        std::size_t end = clamp(first + static_cast<std::ptrdiff_t>(count) - 1) + 1;
+        std::size_t offset = first < 0 ? std::min(static_cast<std::size_t>(-first), count - 1) : 0;
+        return std::tuple(begin, end - begin, offset);
+    };
+    auto [source_row, rows, row_offset] = clamp_range(row, destination.get_height(), height);
+    auto [source_column, columns, column_offset] = clamp_range(column, destination.get_width(), width);
+
+    copy_from_tiles(source_row, source_column, destination.region(row_offset, column_offset, rows, columns));
+
+    for(std::size_t i = row_offset ; i < row_offset + rows ; ++i) {
+        ArrayView<vec3> line = destination[i];
+        std::fill_n(line.begin(), column_offset, line[column_offset]);
+        std::fill(line.begin() + column_offset + columns, line.end(), line[column_offset + columns - 1]);
+    }
+    for(std::size_t i = 0 ; i < destination.get_height() ; ++i) {
+        if(i < row_offset) {
+            std::ranges::copy(destination[row_offset], destination[i].begin());
+        } else if(i >= row_offset + rows) {
+            std::ranges::copy(destination[row_offset + rows - 1], destination[i].begin());
+        }
+    }
+}
+
+void TiledImage::write_region(std::size_t row, std::size_t column, Array2DView<const vec3> source) {
+    if(row > height || source.get_height() > height - row || column > width || source.get_width() > width - column) {
+        throw std::out_of_range("Couldn't write region outside of tiled image");
+    }
+    if(source.empty()) { return; }
+
+    visit_region(row, column, source.get_height(), source.get_width(),
+                 [&](Array2DView<vec3> part, std::size_t part_row, std::size_t part_column) {
+        for(std::size_t i = 0 ; i < part.get_height() ; ++i) {
+            std::ranges::copy(source[part_row + i].subview(part_column, part.get_width()), part[i].begin());
+        }
+    });
+}
+
+void TiledImage::write(const std::filesystem::path& path, const ImageWriteOptions& options) const {
+    std::optional<ImageFormat> format = image_format_from_extension(path);
+    if(!format) { throw std::runtime_error("Couldn't write image '" + path.string() + "': unknown extension"); }
+
+    if(supports_bands(*format)) {
+        write_image_bands(path, *format, width, height, tile_size, options.color_space,
+                          [&](std::size_t row, std::size_t rows, float* pixels) {
+            read_region(static_cast<std::ptrdiff_t>(row), 0, Array2DView<vec3>(reinterpret_cast<vec3*>(pixels), rows, width));
+        });
+    } else {
+        Image image(height, width, uninitialized);
+        read_region(0, 0, image);
+        image.write(path, options);
+    }
+}
+
+std::size_t TiledImage::get_height() const { return height; }
+
+std::size_t TiledImage::get_width() const { return width; }
+
+std::size_t TiledImage::get_tile_size() const { return tile_size; }
+
+std::size_t TiledImage::get_tile_rows() const { return tile_rows; }
+
+std::size_t TiledImage::get_tile_columns() const { return tile_columns; }
+
+std::size_t TiledImage::get_resident_tile_count() const {
+    std::lock_guard lock(mutex);
+    return resident_count;
+}
+
+void TiledImage::pin(std::size_t index) const {
+    std::lock_guard lock(mutex);
+    TileState& tile = tiles[index];
+
+    if(tile.is_resident) {
+        if(tile.pins == 0) { evictable.erase(tile.entry); }
+        ++tile.pins;
+        return;
+    }
+
+    // Pinned tiles are never dropped, so the working set can only shrink back to its bound if some
+    // tiles are unpinned.
+    while(resident_count >= max_resident && !evictable.empty()) {
+        std::size_t victim = evictable.front();
+        evictable.pop_front();
+        tiles[victim].is_resident = false;
+        --resident_count;
+
+        // Modified pages of a shared mapping are kept by the kernel until written back to the file.
+        scratch.advise(MapAdvice::DontNeed, victim * tile_bytes, tile_bytes);
+    }
+
+    tile.is_resident = true;
+    tile.pins = 1;
+    ++resident_count;
+    scratch.advise(MapAdvice::WillNeed, index * tile_bytes, tile_bytes);
+}
+
+void TiledImage::unpin(std::size_t index) const {
+    std::lock_guard lock(mutex);
+    TileState& tile = tiles[index];
+
+    if(--tile.pins == 0) { tile.entry = evictable.insert(evictable.end(), index); }
+}
+
+Array2DView<vec3> TiledImage::get_tile(std::size_t index) const {
+    std::size_t row = index / tile_columns * tile_size;
+    std::size_t column = index % tile_columns * tile_size;
+
+    return Array2DView<vec3>(reinterpret_cast<vec3*>(scratch.get_data() + index * tile_bytes),
+                             std::min(tile_size, height - row), std::min(tile_size, width - column), tile_size);
+}
+
+void TiledImage::copy_from_tiles(std::size_t row, std::size_t column, Array2DView<vec3> destination) const {
+    visit_region(row, column, destination.get_height(), destination.get_width(),
+                 [&](Array2DView<vec3> part, std::size_t part_row, std::size_t part_column) {
+        for(std::size_t i = 0 ; i < part.get_height() ; ++i) {
+            std::ranges::copy(part[i], destination[part_row + i].begin() + part_column);
+        }
+    });
+}
+
+template <typename Function>
+void TiledImage::visit_region(std::size_t row, std::size_t column, std::size_t region_height,
+                              std::size_t region_width, Function&& function) const {
+    for(std::size_t tile_row = row / tile_size ; tile_row * tile_size < row + region_height ; ++tile_row) {
+        for(std::size_t tile_column = column / tile_size ; tile_column * tile_size < column + region_width ; ++tile_column) {
+            std::size_t index = tile_row * tile_columns + tile_column;
+            TilePin pin(*this, index);
+            Array2DView<vec3> tile = get_tile(index);
+
+            // The intersection of the region and the tile.
+            std::size_t first_row = std::max(row, tile_row * tile_size);
+            std::size_t last_row = std::min(row + region_height, tile_row * tile_size + tile.get_height());
+            std::size_t first_column = std::max(column, tile_column * tile_size);
+            std::size_t last_column = std::min(column + region_width, tile_column * tile_size + tile.get_width());
+
+            function(tile.region(first_row - tile_row * tile_size, first_column - tile_column * tile_size,
+                                 last_row - first_row, last_column - first_column),
+                     first_row - row, first_column - column);
+        }
+    }
+}
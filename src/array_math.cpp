@@ -0,0 +1,367 @@
+/***************************************************************************************************
+ * @file  array_math.cpp
+ * @brief Implementation of the vectorized array math functions
+ **************************************************************************************************/
+
+#include "array_math.hpp"
+
+#include <cstddef>
+#include <limits>
+#include <type_traits>
+#include "simd.hpp"
+
+/*
+ * Floating-point contraction would let the compiler fuse multiplications and additions into FMA
+ * instructions on AVX-512 only, so that the deterministic reductions would differ between paths.
+ */
+#pragma GCC optimize("fp-contract=off")
+
+namespace {
+    /// Number of accumulators of the deterministic reductions, identical for every instruction set.
+    constexpr std::size_t deterministic_lanes = 48;
+
+    /**
+     * @enum Operation
+     * @brief The operations the reduce kernels can compute.
+     */
+    enum class Operation { Add, Min, Max };
+
+    /**
+     * @brief Applies a reduction operation, on vectors and scalars alike.
+     * @param left The accumulated value.
+     * @param right The new value.
+     * @return The combination of both values.
+     */
+    template <Operation operation, typename Value>
+    [[gnu::always_inline]] inline Value apply(Value left, Value right) {
+        if constexpr(operation == Operation::Add) { return left + right; }
+        else if constexpr(operation == Operation::Min) { return right < left ? right : left; }
+        else { return right > left ? right : left; }
+    }
+
+    namespace scalar {
+        /**
+         * @brief Scalar version of the vectorized reduce kernel, performing the exact same operations
+         * in the same order.
+         */
+        template <Operation operation, std::size_t Lanes, typename Type, typename Accumulator>
+        void reduce(const Type* data, std::size_t count, std::size_t components, Accumulator identity,
+                    Accumulator* result) {
+            Accumulator accumulators[Lanes];
+            for(Accumulator& accumulator : accumulators) { accumulator = identity; }
+
+            std::size_t i = 0;
+            for(; i + Lanes <= count ; i += Lanes) {
+                for(std::size_t k = 0 ; k < Lanes ; ++k) {
+                    accumulators[k] = apply<operation>(accumulators[k], static_cast<Accumulator>(data[i + k]));
+                }
+            }
+
+            for(std::size_t c = 0 ; c < components ; ++c) { result[c] = identity; }
+            for(std::size_t k = 0 ; k < Lanes ; ++k) {
+                result[k % components] = apply<operation>(result[k % components], accumulators[k]);
+            }
+            for(; i < count ; ++i) {
+                result[i % components] = apply<operation>(result[i % components], static_cast<Accumulator>(data[i]));
+            }
+        }
+
+        /**
+         * @brief Scalar version of the vectorized dot kernel, performing the exact same operations in
+         * the same order.
+         */
+        template <std::size_t Lanes, typename Type, typename Accumulator>
+        Accumulator dot(const Type* x, const Type* y, std::size_t count) {
+            Accumulator accumulators[Lanes] {};
+
+            std::size_t i = 0;
+            for(; i + Lanes <= count ; i += Lanes) {
+                for(std::size_t k = 0 ; k < Lanes ; ++k) {
+                    accumulators[k] += static_cast<Accumulator>(x[i + k]) * static_cast<Accumulator>(y[i + k]);
+                }
+            }
+
+            Accumulator result = 0;
+            for(std::size_t k = 0 ; k < Lanes ; ++k) { result += accumulators[k]; }
+            for(; i < count ; ++i) { result += static_cast<Accumulator>(x[i]) * static_cast<Accumulator>(y[i]); }
+
+            return result;
+        }
+
+        /**
+         * @brief Scalar version of the vectorized axpy kernel.
+         */
+        template <typename Type>
+        void axpy(Type a, const Type* x, Type* y, std::size_t count) {
+            for(std::size_t i = 0 ; i < count ; ++i) { y[i] = a * x[i] + y[i]; }
+        }
+
+        /**
+         * @brief Scalar version of the vectorized weighted_sum kernel.
+         */
+        template <typename Type>
+        void weighted_sum(const Type* const* sources, const Type* weights, std::size_t source_count,
+                          Type* destination, std::size_t count) {
+            for(std::size_t i = 0 ; i < count ; ++i) {
+                Type sum = 0;
+                for(std::size_t s = 0 ; s < source_count ; ++s) { sum += weights[s] * sources[s][i]; }
+                destination[i] = sum;
+            }
+        }
+
+        /**
+         * @brief Scalar version of the vectorized correlate kernel.
+         */
+        template <typename Type>
+        void correlate(const Type* source, std::size_t step, const Type* weights, std::size_t taps,
+                       Type* destination, std::size_t count) {
+            for(std::size_t i = 0 ; i < count ; ++i) {
+                Type sum = 0;
+                for(std::size_t t = 0 ; t < taps ; ++t) { sum += weights[t] * source[t * step + i]; }
+                destination[i] = sum;
+            }
+        }
+
+        /**
+         * @brief Scalar version of the vectorized scale kernel.
+         */
+        template <typename Type>
+        void scale(Type* data, std::size_t count, Type factor) {
+            for(std::size_t i = 0 ; i < count ; ++i) { data[i] *= factor; }
+        }
+
+        /**
+         * @brief Scalar version of the vectorized clamp kernel.
+         */
+        template <typename Type>
+        void clamp(Type* data, std::size_t count, Type min, Type max) {
+            for(std::size_t i = 0 ; i < count ; ++i) { data[i] = data[i] < min ? min : data[i] > max ? max : data[i]; }
+        }
+    }
+
+#if defined(__x86_64__)
+    namespace sse2 {
+#define VECTOR_BYTES 16
+#include "array_math_kernels.inl"
+#undef VECTOR_BYTES
+    }
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+    namespace avx2 {
+#define VECTOR_BYTES 32
+#include "array_math_kernels.inl"
+#undef VECTOR_BYTES
+    }
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+    namespace avx512 {
+#define VECTOR_BYTES 64
+#include "array_math_kernels.inl"
+#undef VECTOR_BYTES
+    }
+#pragma GCC pop_options
+#endif
+
+    /**
+     * @brief Runs the reduce kernel of the current instruction set, with the number of accumulators
+     * matching the reduction mode.
+     */
+    template <Operation operation, typename Type, typename Accumulator>
+    void dispatch_reduce(const Type* data, std::size_t count, std::size_t components, Accumulator identity,
+                         Accumulator* result, Reduction mode) {
+        constexpr std::size_t lanes = deterministic_lanes;
+        bool fast = mode == Reduction::Fast;
+
+        switch(get_simd_level()) {
+#if defined(__x86_64__)
+            case SimdLevel::AVX512:
+                if(fast) { avx512::reduce<operation, 12 * avx512::lanes<Accumulator>>(data, count, components, identity, result); }
+                else { avx512::reduce<operation, lanes>(data, count, components, identity, result); }
+                return;
+            case SimdLevel::AVX2:
+                if(fast) { avx2::reduce<operation, 12 * avx2::lanes<Accumulator>>(data, count, components, identity, result); }
+                else { avx2::reduce<operation, lanes>(data, count, components, identity, result); }
+                return;
+            case SimdLevel::SSE2:
+                if(fast) { sse2::reduce<operation, 12 * sse2::lanes<Accumulator>>(data, count, components, identity, result); }
+                else { sse2::reduce<operation, lanes>(data, count, components, identity, result); }
+                return;
+#endif
+            default:
+                scalar::reduce<operation, lanes>(data, count, components, identity, result);
+                return;
+        }
+    }
+
+    /**
+     * @brief Runs the dot kernel of the current instruction set, with the number of accumulators
+     * matching the reduction mode.
+     */
+    template <typename Type, typename Accumulator>
+    Accumulator dispatch_dot(const Type* x, const Type* y, std::size_t count, Reduction mode) {
+        constexpr std::size_t lanes = deterministic_lanes;
+        bool fast = mode == Reduction::Fast;
+
+        switch(get_simd_level()) {
+#if defined(__x86_64__)
+            case SimdLevel::AVX512:
+                return fast ? avx512::dot<12 * avx512::lanes<Accumulator>, Type, Accumulator>(x, y, count)
+                            : avx512::dot<lanes, Type, Accumulator>(x, y, count);
+            case SimdLevel::AVX2:
+                return fast ? avx2::dot<12 * avx2::lanes<Accumulator>, Type, Accumulator>(x, y, count)
+                            : avx2::dot<lanes, Type, Accumulator>(x, y, count);
+            case SimdLevel::SSE2:
+                return fast ? sse2::dot<12 * sse2::lanes<Accumulator>, Type, Accumulator>(x, y, count)
+                            : sse2::dot<lanes, Type, Accumulator>(x, y, count);
+#endif
+            default:
+                return scalar::dot<lanes, Type, Accumulator>(x, y, count);
+        }
+    }
+
+/// Expands to a switch calling the elementwise kernel 'name' of the current instruction set.
+#if defined(__x86_64__)
+#define DISPATCH_ELEMENTWISE(name, ...)                                                             \
+    switch(get_simd_level()) {                                                                      \
+        case SimdLevel::AVX512: avx512::name(__VA_ARGS__); return;                                  \
+        case SimdLevel::AVX2: avx2::name(__VA_ARGS__); return;                                      \
+        case SimdLevel::SSE2: sse2::name(__VA_ARGS__); return;                                      \
+        default: scalar::name(__VA_ARGS__); return;                                                 \
+    }
+#else
+#define DISPATCH_ELEMENTWISE(name, ...) scalar::name(__VA_ARGS__);
+#endif
+
+    /**
+     * @brief Runs the axpy kernel of the current instruction set.
+     */
+    template <typename Type>
+    void dispatch_axpy(Type a, const Type* x, Type* y, std::size_t count) {
+        DISPATCH_ELEMENTWISE(axpy, a, x, y, count)
+    }
+
+    /**
+     * @brief Runs the weighted_sum kernel of the current instruction set.
+     */
+    template <typename Type>
+    void dispatch_weighted_sum(const Type* const* sources, const Type* weights, std::size_t source_count,
+                               Type* destination, std::size_t count) {
+        DISPATCH_ELEMENTWISE(weighted_sum, sources, weights, source_count, destination, count)
+    }
+
+    /**
+     * @brief Runs the correlate kernel of the current instruction set.
+     */
+    template <typename Type>
+    void dispatch_correlate(const Type* source, std::size_t step, const Type* weights, std::size_t taps,
+                            Type* destination, std::size_t count) {
+        DISPATCH_ELEMENTWISE(correlate, source, step, weights, taps, destination, count)
+    }
+
+    /**
+     * @brief Runs the scale kernel of the current instruction set.
+     */
+    template <typename Type>
+    void dispatch_scale(Type* data, std::size_t count, Type factor) {
+        DISPATCH_ELEMENTWISE(scale, data, count, factor)
+    }
+
+    /**
+     * @brief Runs the clamp kernel of the current instruction set.
+     */
+    template <typename Type>
+    void dispatch_clamp(Type* data, std::size_t count, Type min, Type max) {
+        DISPATCH_ELEMENTWISE(clamp, data, count, min, max)
+    }
+
+#undef DISPATCH_ELEMENTWISE
+}
+
+void sum_n(const float* data, std::size_t count, std::size_t components, float* result, Reduction mode) {
+    dispatch_reduce<Operation::Add>(data, count, components, 0.0f, result, mode);
+}
+
+void sum_n(const double* data, std::size_t count, std::size_t components, double* result, Reduction mode) {
+    dispatch_reduce<Operation::Add>(data, count, components, 0.0, result, mode);
+}
+
+void sum_n(const int* data, std::size_t count, std::size_t components, long long* result, Reduction mode) {
+    dispatch_reduce<Operation::Add>(data, count, components, 0LL, result, mode);
+}
+
+void min_n(const float* data, std::size_t count, std::size_t components, float* result) {
+    dispatch_reduce<Operation::Min>(data, count, components, std::numeric_limits<float>::infinity(), result, Reduction::Fast);
+}
+
+void min_n(const double* data, std::size_t count, std::size_t components, double* result) {
+    dispatch_reduce<Operation::Min>(data, count, components, std::numeric_limits<double>::infinity(), result, Reduction::Fast);
+}
+
+void min_n(const int* data, std::size_t count, std::size_t components, int* result) {
+    dispatch_reduce<Operation::Min>(data, count, components, std::numeric_limits<int>::max(), result, Reduction::Fast);
+}
+
+void max_n(const float* data, std::size_t count, std::size_t components, float* result) {
+    dispatch_reduce<Operation::Max>(data, count, components, -std::numeric_limits<float>::infinity(), result, Reduction::Fast);
+}
+
+void max_n(const double* data, std::size_t count, std::size_t components, double* result) {
+    dispatch_reduce<Operation::Max>(data, count, components, -std::numeric_limits<double>::infinity(), result, Reduction::Fast);
+}
+
+void max_n(const int* data, std::size_t count, std::size_t components, int* result) {
+    dispatch_reduce<Operation::Max>(data, count, components, std::numeric_limits<int>::lowest(), result, Reduction::Fast);
+}
+
+float dot_n(const float* x, const float* y, std::size_t count, Reduction mode) {
+    return dispatch_dot<float, float>(x, y, count, mode);
+}
+
+double dot_n(const double* x, const double* y, std::size_t count, Reduction mode) {
+    return dispatch_dot<double, double>(x, y, count, mode);
+}
+
+long long dot_n(const int* x, const int* y, std::size_t count, Reduction mode) {
+    return dispatch_dot<int, long long>(x, y, count, mode);
+}
+
+void axpy_n(float a, const float* x, float* y, std::size_t count) { dispatch_axpy(a, x, y, count); }
+
+void axpy_n(double a, const double* x, double* y, std::size_t count) { dispatch_axpy(a, x, y, count); }
+
+void axpy_n(int a, const int* x, int* y, std::size_t count) { dispatch_axpy(a, x, y, count); }
+
+void weighted_sum_n(const float* const* sources, const float* weights, std::size_t source_count,
+                    float* destination, std::size_t count) {
+    dispatch_weighted_sum(sources, weights, source_count, destination, count);
+}
+
+void weighted_sum_n(const double* const* sources, const double* weights, std::size_t source_count,
+                    double* destination, std::size_t count) {
+    dispatch_weighted_sum(sources, weights, source_count, destination, count);
+}
+
+void correlate_n(const float* source, std::size_t step, const float* weights, std::size_t taps,
+                 float* destination, std::size_t count) {
+    dispatch_correlate(source, step, weights, taps, destination, count);
+}
+
+void correlate_n(const double* source, std::size_t step, const double* weights, std::size_t taps,
+                 double* destination, std::size_t count) {
+    dispatch_correlate(source, step, weights, taps, destination, count);
+}
+
+void scale_n(float* data, std::size_t count, float factor) { dispatch_scale(data, count, factor); }
+
+void scale_n(double* data, std::size_t count, double factor) { dispatch_scale(data, count, factor); }
+
+void scale_n(int* data, std::size_t count, int factor) { dispatch_scale(data, count, factor); }
+
+void clamp_n(float* data, std::size_t count, float min, float max) { dispatch_clamp(data, count, min, max); }
+
+void clamp_n(double* data, std::size_t count, double min, double max) { dispatch_clamp(data, count, min, max); }
+
+void clamp_n(int* data, std::size_t count, int min, int max) { dispatch_clamp(data, count, min, max); }
@@ -0,0 +1,282 @@
+/***************************************************************************************************
+ * @file  array_math_kernels.inl
+ * @brief Vectorized kernels of the array math functions, written once for every vector width
+ *
+ * This file is included several times by array_math.cpp, each time inside its own namespace and
+ * with VECTOR_BYTES set to the width of the target instruction set's registers. The kernels use
+ * GCC vector extensions, which compile to the instruction set enabled around the inclusion.
+ **************************************************************************************************/
+
+/**
+ * @struct Vec
+ * @brief Maps an element type to the vector type holding VECTOR_BYTES bytes of it.
+ * @tparam Type The type of the vector's lanes.
+ */
+template <typename Type> struct Vec;
+
+template <> struct Vec<float> { typedef float type __attribute__((vector_size(VECTOR_BYTES))); };
+template <> struct Vec<double> { typedef double type __attribute__((vector_size(VECTOR_BYTES))); };
+template <> struct Vec<int> { typedef int type __attribute__((vector_size(VECTOR_BYTES))); };
+template <> struct Vec<long long> { typedef long long type __attribute__((vector_size(VECTOR_BYTES))); };
+
+/// Vector of ints with as many lanes as a vector of long long, used for widening loads.
+typedef int HalfIntVec __attribute__((vector_size(VECTOR_BYTES / 2)));
+
+/// Number of lanes of a vector of 'Type'.
+template <typename Type>
+constexpr std::size_t lanes = VECTOR_BYTES / sizeof(Type);
+
+/**
+ * @brief Applies a reduction operation to vectors. Redefined for every vector width so that it is
+ * compiled with the right instruction set.
+ * @param left The accumulated values.
+ * @param right The new values.
+ * @return The lane-wise combination of both vectors.
+ */
+template <Operation operation, typename Vector>
+[[gnu::always_inline]] inline Vector apply(Vector left, Vector right) {
+    if constexpr(operation == Operation::Add) { return left + right; }
+    else if constexpr(operation == Operation::Min) { return right < left ? right : left; }
+    else { return right > left ? right : left; }
+}
+
+/**
+ * @brief Loads a vector of 'Accumulator' from unaligned elements, widening them if needed.
+ * @param data A pointer to the first element to load.
+ * @return The loaded vector.
+ */
+template <typename Type, typename Accumulator>
+[[gnu::always_inline]] inline typename Vec<Accumulator>::type load(const Type* data) {
+    if constexpr(std::is_same_v<Type, Accumulator>) {
+        typename Vec<Accumulator>::type vector;
+        __builtin_memcpy(&vector, data, sizeof(vector));
+        return vector;
+    } else {
+        HalfIntVec vector;
+        __builtin_memcpy(&vector, data, sizeof(vector));
+        return __builtin_convertvector(vector, typename Vec<Accumulator>::type);
+    }
+}
+
+/**
+ * @brief Reduces interleaved components with 'Lanes' independent accumulators, so that the order of
+ * the operations only depends on 'Lanes' and not on the vector width.
+ * @tparam Lanes The number of accumulators, a multiple of 12 and of the vector width.
+ * @param data A pointer to the first element.
+ * @param count The number of elements, a multiple of 'components'.
+ * @param components The number of interleaved components: 1, 2, 3 or 4.
+ * @param identity The identity of the operation.
+ * @param result Receives the reduction of each component.
+ * @tparam operation The reduction operation.
+ */
+template <Operation operation, std::size_t Lanes, typename Type, typename Accumulator>
+void reduce(const Type* data, std::size_t count, std::size_t components, Accumulator identity,
+            Accumulator* result) {
+    using Vector = typename Vec<Accumulator>::type;
+    constexpr std::size_t width = lanes<Accumulator>;
+    constexpr std::size_t registers = Lanes / width;
+    static_assert(Lanes % width == 0 && Lanes % 12 == 0);
+
+    Vector accumulators[registers];
+    for(Vector& accumulator : accumulators) { accumulator = Vector {} + identity; }
+
+    std::size_t i = 0;
+    for(; i + Lanes <= count ; i += Lanes) {
+        for(std::size_t r = 0 ; r < registers ; ++r) {
+            accumulators[r] = apply<operation>(accumulators[r], load<Type, Accumulator>(data + i + r * width));
+        }
+    }
+
+    // Lane k always accumulates component k % components, since Lanes is a multiple of 1, 2, 3 and 4.
+    Accumulator lane_values[Lanes];
+    __builtin_memcpy(lane_values, accumulators, sizeof(lane_values));
+
+    for(std::size_t c = 0 ; c < components ; ++c) { result[c] = identity; }
+    for(std::size_t k = 0 ; k < Lanes ; ++k) {
+        result[k % components] = apply<operation>(result[k % components], lane_values[k]);
+    }
+    for(; i < count ; ++i) {
+        result[i % components] = apply<operation>(result[i % components], static_cast<Accumulator>(data[i]));
+    }
+}
+
+/**
+ * @brief Computes the sum of the products of two sequences with 'Lanes' independent accumulators.
+ * @tparam Lanes The number of accumulators, a multiple of the vector width.
+ * @param x A pointer to the first element of the first sequence.
+ * @param y A pointer to the first element of the second sequence.
+ * @param count The number of elements.
+ * @return The dot product.
+ */
+template <std::size_t Lanes, typename Type, typename Accumulator>
+Accumulator dot(const Type* x, const Type* y, std::size_t count) {
+    using Vector = typename Vec<Accumulator>::type;
+    constexpr std::size_t width = lanes<Accumulator>;
+    constexpr std::size_t registers = Lanes / width;
+
+    Vector accumulators[registers] {};
+
+    std::size_t i = 0;
+    for(; i + Lanes <= count ; i += Lanes) {
+        for(std::size_t r = 0 ; r < registers ; ++r) {
+            std::size_t offset = i + r * width;
+            accumulators[r] += load<Type, Accumulator>(x + offset) * load<Type, Accumulator>(y + offset);
+        }
+    }
+
+    Accumulator lane_values[Lanes];
+    __builtin_memcpy(lane_values, accumulators, sizeof(lane_values));
+
+    Accumulator result = 0;
+    for(std::size_t k = 0 ; k < Lanes ; ++k) { result += lane_values[k]; }
+    for(; i < count ; ++i) { result += static_cast<Accumulator>(x[i]) * static_cast<Accumulator>(y[i]); }
+
+    return result;
+}
+
+/**
+ * @brief Computes y = a * x + y.
+ * @param a The factor.
+ * @param x A pointer to the first element of x.
+ * @param y A pointer to the first element of y.
+ * @param count The number of elements.
+ */
+template <typename Type>
+void axpy(Type a, const Type* x, Type* y, std::size_t count) {
+    using Vector = typename Vec<Type>::type;
+    constexpr std::size_t width = lanes<Type>;
+
+    std::size_t i = 0;
+    for(; i + width <= count ; i += width) {
+        Vector vx, vy;
+        __builtin_memcpy(&vx, x + i, sizeof(vx));
+        __builtin_memcpy(&vy, y + i, sizeof(vy));
+        vy = a * vx + vy;
+        __builtin_memcpy(y + i, &vy, sizeof(vy));
+    }
+    for(; i < count ; ++i) { y[i] = a * x[i] + y[i]; }
+}
+
+/**
+ * @brief Computes the weighted sum of several sequences. The sums of 'blocked' consecutive vectors are
+ * kept in registers while all sequences are accumulated, so that the destination is written once.
+ * @param sources Pointers to the first element of each sequence.
+ * @param weights The weight of each sequence.
+ * @param source_count The number of sequences.
+ * @param destination A pointer to the first element of the result.
+ * @param count The number of elements of each sequence.
+ */
+template <typename Type>
+void weighted_sum(const Type* const* sources, const Type* weights, std::size_t source_count, Type* destination,
+                  std::size_t count) {
+    using Vector = typename Vec<Type>::type;
+    constexpr std::size_t width = lanes<Type>;
+    constexpr std::size_t blocked = 4;
+
+    std::size_t i = 0;
+    for(; i + blocked * width <= count ; i += blocked * width) {
+        Vector accumulators[blocked] {};
+        for(std::size_t s = 0 ; s < source_count ; ++s) {
+            for(std::size_t r = 0 ; r < blocked ; ++r) {
+                accumulators[r] += weights[s] * load<Type, Type>(sources[s] + i + r * width);
+            }
+        }
+        __builtin_memcpy(destination + i, accumulators, sizeof(accumulators));
+    }
+    for(; i + width <= count ; i += width) {
+        Vector accumulator {};
+        for(std::size_t s = 0 ; s < source_count ; ++s) { accumulator += weights[s] * load<Type, Type>(sources[s] + i); }
+        __builtin_memcpy(destination + i, &accumulator, sizeof(accumulator));
+    }
+    for(; i < count ; ++i) {
+        Type sum = 0;
+        for(std::size_t s = 0 ; s < source_count ; ++s) { sum += weights[s] * sources[s][i]; }
+        destination[i] = sum;
+    }
+}
+
+/**
+ * @brief Correlates a sequence with weights whose taps are 'step' elements apart, e.g. 3 to filter
+ * the rows of interleaved RGB pixels. Blocked like weighted_sum.
+ * @param source A pointer to the first element of the sequence.
+ * @param step The distance in elements between two taps.
+ * @param weights The weight of each tap.
+ * @param taps The number of taps.
+ * @param destination A pointer to the first element of the result.
+ * @param count The number of elements of the result. The source must hold count + (taps - 1) * step.
+ */
+template <typename Type>
+void correlate(const Type* source, std::size_t step, const Type* weights, std::size_t taps, Type* destination,
+               std::size_t count) {
+    using Vector = typename Vec<Type>::type;
+    constexpr std::size_t width = lanes<Type>;
+    constexpr std::size_t blocked = 4;
+
+    std::size_t i = 0;
+    for(; i + blocked * width <= count ; i += blocked * width) {
+        Vector accumulators[blocked] {};
+        for(std::size_t t = 0 ; t < taps ; ++t) {
+            for(std::size_t r = 0 ; r < blocked ; ++r) {
+                accumulators[r] += weights[t] * load<Type, Type>(source + t * step + i + r * width);
+            }
+        }
+        __builtin_memcpy(destination + i, accumulators, sizeof(accumulators));
+    }
+    for(; i + width <= count ; i += width) {
+        Vector accumulator {};
+        for(std::size_t t = 0 ; t < taps ; ++t) { accumulator += weights[t] * load<Type, Type>(source + t * step + i); }
+        __builtin_memcpy(destination + i, &accumulator, sizeof(accumulator));
+    }
+    for(; i < count ; ++i) {
+        Type sum = 0;
+        for(std::size_t t = 0 ; t < taps ; ++t) { sum += weights[t] * source[t * step + i]; }
+        destination[i] = sum;
+    }
+}
+
+/**
+ * @brief Multiplies elements by a factor.
+ * @param data A pointer to the first element.
+ * @param count The number of elements.
+ * @param factor The factor.
+ */
+template <typename Type>
+void scale(Type* data, std::size_t count, Type factor) {
+    using Vector = typename Vec<Type>::type;
+    constexpr std::size_t width = lanes<Type>;
+
+    std::size_t i = 0;
+    for(; i + width <= count ; i += width) {
+        Vector vector;
+        __builtin_memcpy(&vector, data + i, sizeof(vector));
+        vector *= factor;
+        __builtin_memcpy(data + i, &vector, sizeof(vector));
+    }
+    for(; i < count ; ++i) { data[i] *= factor; }
+}
+
+/**
+ * @brief Clamps elements to a range.
+ * @param data A pointer to the first element.
+ * @param count The number of elements.
+ * @param min The lower bound.
+ * @param max The upper bound.
+ */
+template <typename Type>
+void clamp(Type* data, std::size_t count, Type min, Type max) {
+    using Vector = typename Vec<Type>::type;
+    constexpr std::size_t width = lanes<Type>;
+
+    Vector vmin = Vector {} + min;
+    Vector vmax = Vector {} + max;
+
+    std::size_t i = 0;
+    for(; i + width <= count ; i += width) {
+        Vector vector;
+        __builtin_memcpy(&vector, data + i, sizeof(vector));
+        vector = vector < vmin ? vmin : vector;
+        vector = vector > vmax ? vmax : vector;
+        __builtin_memcpy(data + i, &vector, sizeof(vector));
+    }
+    for(; i < count ; ++i) { data[i] = data[i] < min ? min : data[i] > max ? max : data[i]; }
+}
@@ -0,0 +1,685 @@
+/***************************************************************************************************
+ * @file  convolution.cpp
+ * @brief Implementation of the 2D convolutions of Array2D<float> and Image
+ **************************************************************************************************/
+
+#include "convolution.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include "Array.hpp"
+#include "Array2D.hpp"
+#include "FFTPlan.hpp"
+#include "array_math.hpp"
+#include "fft.hpp"
+#include "parallel.hpp"
+
+namespace {
+    /// Kernels taking at least this many taps per pixel, summed over both passes for separable ones,
+    /// are applied through FFTs.
+    constexpr std::size_t fft_taps = 400;
+
+    /// Blurs with a smaller standard deviation use an exact Gaussian kernel, which is then short.
+    constexpr float exact_gaussian_sigma = 4.0f;
+
+    /// Number of floats of the columns the box blurs process at once, so that their buffers stay in the cache.
+    constexpr std::size_t box_columns = 64;
+
+    /// The running sums of the box blurs, for 4 columns at once.
+    typedef float BoxVector __attribute__((vector_size(16)));
+
+    /// Number of BoxVector of the strips of columns whose running sums are kept in registers.
+    constexpr std::size_t strip_vectors = 4;
+
+    /// The running sums of the box blurs are recomputed every this many rows, so that rounding errors
+    /// don't accumulate.
+    constexpr std::size_t restart_rows = 128;
+
+    /**
+     * @brief Maps the index of a pixel, possibly outside of an axis, to the pixel giving its value.
+     * @param index The index of the pixel.
+     * @param size The number of pixels of the axis.
+     * @param border How the pixels outside of the axis are extrapolated.
+     * @return The index of the pixel inside the axis, or -1 if the value is zero.
+     */
+    std::ptrdiff_t map_index(std::ptrdiff_t index, std::ptrdiff_t size, BorderMode border) {
+        if(index >= 0 && index < size) { return index; }
+
+        switch(border) {
+            case BorderMode::Clamp:
+                return std::clamp<std::ptrdiff_t>(index, 0, size - 1);
+            case BorderMode::Wrap:
+                return (index % size + size) % size;
+            case BorderMode::Mirror: {
+                if(size == 1) { return 0; }
+                std::ptrdiff_t period = 2 * (size - 1);
+                index = (index % period + period) % period;
+                return index < size ? index : period - index;
+            }
+            default:
+                return -1;
+        }
+    }
+
+    /**
+     * @brief Fills the padding around a row with the pixels extrapolated from it.
+     * @param padded The padded row, whose pixels from 'left' to 'left + width' are the row's.
+     * @param width The number of pixels of the row.
+     * @param channels The number of floats per pixel.
+     * @param left The number of pixels of padding before the row.
+     * @param right The number of pixels of padding after the row.
+     * @param border How the pixels outside of the row are extrapolated.
+     */
+    void pad_row(float* padded, std::size_t width, std::size_t channels, std::size_t left, std::size_t right,
+                 BorderMode border) {
+        const float* row = padded + left * channels;
+
+        for(std::size_t p = 0 ; p < left + right ; ++p) {
+            // The padding's pixels, from the leftmost one to the rightmost one.
+            std::size_t position = p < left ? p : width + p;
+            std::ptrdiff_t index = static_cast<std::ptrdiff_t>(position) - static_cast<std::ptrdiff_t>(left);
+            std::ptrdiff_t source = map_index(index, static_cast<std::ptrdiff_t>(width), border);
+
+            float* pixel = padded + position * channels;
+            if(source < 0) { std::fill_n(pixel, channels, 0.0f); }
+            else { std::copy_n(row + source * channels, channels, pixel); }
+        }
+    }
+
+    /**
+     * @param source An image.
+     * @return A view over the channels of the image, a row of pixels being a row of floats.
+     */
+    Array2DView<const float> as_floats(Array2DView<const vec3> source) {
+        return Array2DView<const float>(&source.get_data()->x, source.get_height(), 3 * source.get_width(),
+                                        3 * source.get_stride());
+    }
+
+    /// @copydoc as_floats
+    Array2DView<float> as_floats(Array2DView<vec3> source) {
+        return Array2DView<float>(&source.get_data()->x, source.get_height(), 3 * source.get_width(),
+                                  3 * source.get_stride());
+    }
+
+    /**
+     * @brief Checks that a source and a destination have the same dimensions.
+     * @param source The source.
+     * @param destination The destination.
+     */
+    template <typename Type>
+    void check_dimensions(Array2DView<const Type> source, Array2DView<Type> destination) {
+        if(source.get_height() != destination.get_height() || source.get_width() != destination.get_width()) {
+            throw std::invalid_argument("Couldn't convolve images of different dimensions");
+        }
+    }
+
+    /**
+     * @param row_floats The number of floats of a row.
+     * @return The number of rows of the bands processed in parallel.
+     */
+    std::size_t band_rows(std::size_t row_floats) {
+        return std::max<std::size_t>(default_tile_bytes / (sizeof(float) * std::max<std::size_t>(row_floats, 1)), 1);
+    }
+
+    /**
+     * @brief Convolves channels with a separable kernel, a row at a time: the vertical pass is a
+     * weighted sum of source rows into a padded row, which the horizontal pass then correlates.
+     * @param source The source channels, with 'channels' floats per pixel.
+     * @param destination The destination channels.
+     * @param channels The number of floats per pixel.
+     * @param vertical The vertical kernel.
+     * @param horizontal The horizontal kernel.
+     * @param border How the pixels outside of the source are extrapolated.
+     * @param pool The pool to process bands of rows on.
+     */
+    void convolve_separable_channels(Array2DView<const float> source, Array2DView<float> destination,
+                                     std::size_t channels, std::span<const float> vertical,
+                                     std::span<const float> horizontal, BorderMode border, ThreadPool& pool) {
+        if(destination.empty()) { return; }
+        if(vertical.empty() || horizontal.empty()) {
+            destination.fill(0.0f);
+            return;
+        }
+
+        std::ptrdiff_t height = static_cast<std::ptrdiff_t>(source.get_height());
+        std::size_t width = source.get_width() / channels;
+
+        // Correlating with the flipped kernels convolves with the kernels.
+        std::vector<float> vertical_taps(vertical.rbegin(), vertical.rend());
+        std::vector<float> horizontal_taps(horizontal.rbegin(), horizontal.rend());
+        std::ptrdiff_t top = static_cast<std::ptrdiff_t>(vertical.size() - 1 - vertical.size() / 2);
+        std::size_t left = horizontal.size() - 1 - horizontal.size() / 2;
+        std::size_t right = horizontal.size() - 1 - left;
+
+        parallel_for(0, source.get_height(), band_rows(source.get_width()), [&](std::size_t begin, std::size_t end) {
+            Array<float> padded((width + left + right) * channels, uninitialized);
+            std::vector<const float*> sources;
+            std::vector<float> weights;
+
+            for(std::size_t i = begin ; i < end ; ++i) {
+                sources.clear();
+                weights.clear();
+                for(std::size_t a = 0 ; a < vertical_taps.size() ; ++a) {
+                    std::ptrdiff_t row = map_index(static_cast<std::ptrdiff_t>(i) - top + static_cast<std::ptrdiff_t>(a),
+                                                   height, border);
+                    if(row >= 0 && vertical_taps[a] != 0.0f) {
+                        sources.push_back(&source[row][0]);
+                        weights.push_back(vertical_taps[a]);
+                    }
+                }
+
+                float* row = padded.get_data() + left * channels;
+                if(sources.empty()) { std::fill_n(row, width * channels, 0.0f); }
+                else { weighted_sum_n(sources.data(), weights.data(), sources.size(), row, width * channels); }
+                pad_row(padded.get_data(), width, channels, left, right, border);
+
+                correlate_n(padded.get_data(), channels, horizontal_taps.data(), horizontal_taps.size(),
+                            &destination[i][0], width * channels);
+            }
+        }, pool);
+    }
+
+    /**
+     * @brief Convolves channels with a kernel through FFTs. The source is extended by the kernel's
+     * dimensions minus 1 with the border mode, so that the circular convolution of the transforms
+     * never wraps around for the pixels kept.
+     * @param source The source channels, with 'channels' floats per pixel.
+     * @param destination The destination channels.
+     * @param channels The number of floats per pixel.
+     * @param kernel The kernel.
+     * @param border How the pixels outside of the source are extrapolated.
+     * @param pool The pool to process bands of rows and columns on.
+     */
+    void convolve_fft_channels(Array2DView<const float> source, Array2DView<float> destination, std::size_t channels,
+                               Array2DView<const float> kernel, BorderMode border, ThreadPool& pool) {
+        if(destination.empty()) { return; }
+        if(kernel.empty()) {
+            destination.fill(0.0f);
+            return;
+        }
+
+        std::size_t height = source.get_height();
+        std::size_t width = source.get_width() / channels;
+        std::size_t kernel_rows = kernel.get_height();
+        std::size_t kernel_columns = kernel.get_width();
+        std::ptrdiff_t top = static_cast<std::ptrdiff_t>(kernel_rows - 1 - kernel_rows / 2);
+        std::ptrdiff_t left = static_cast<std::ptrdiff_t>(kernel_columns - 1 - kernel_columns / 2);
+
+        // An even width halves the real transforms of the rows.
+        std::size_t fft_height = FFTPlan::get_fast_size(height + kernel_rows - 1);
+        std::size_t fft_width = 2 * FFTPlan::get_fast_size((width + kernel_columns) / 2);
+        std::size_t grain = band_rows(fft_width);
+
+        Array2D<float> padded(fft_height, fft_width, uninitialized);
+        Array2D<std::complex<float>> spectrum(fft_height, fft_width / 2 + 1, uninitialized);
+        Array2D<std::complex<float>> kernel_spectrum(fft_height, fft_width / 2 + 1, uninitialized);
+
+        // The kernel is transformed at the origin, scaled so that the inverse transform is normalized.
+        padded.fill(0.0f);
+        float scale = 1.0f / static_cast<float>(fft_height * fft_width);
+        for(std::size_t a = 0 ; a < kernel_rows ; ++a) {
+            for(std::size_t b = 0 ; b < kernel_columns ; ++b) { padded(a, b) = kernel[a][b] * scale; }
+        }
+        real_fft(padded, kernel_spectrum, pool);
+
+        std::vector<std::ptrdiff_t> columns(fft_width);
+        for(std::size_t x = 0 ; x < fft_width ; ++x) {
+            columns[x] = map_index(static_cast<std::ptrdiff_t>(x) - left, static_cast<std::ptrdiff_t>(width), border);
+        }
+
+        for(std::size_t c = 0 ; c < channels ; ++c) {
+            // Padded pixel (y, x) is source pixel (y - top, x - left), so destination pixel (i, j) is
+            // padded pixel (i + kernel_rows - 1, j + kernel_columns - 1) of the convolution.
+            parallel_for(0, fft_height, grain, [&](std::size_t begin, std::size_t end) {
+                for(std::size_t y = begin ; y < end ; ++y) {
+                    std::ptrdiff_t row = map_index(static_cast<std::ptrdiff_t>(y) - top, static_cast<std::ptrdiff_t>(height),
+                                                   border);
+                    ArrayView<float> output = padded[y];
+                    if(row < 0) {
+                        output.fill(0.0f);
+                        continue;
+                    }
+
+                    const float* input = &source[row][c];
+                    for(std::size_t x = 0 ; x < fft_width ; ++x) {
+                        output[x] = columns[x] < 0 ? 0.0f : input[columns[x] * channels];
+                    }
+                }
+            }, pool);
+
+            real_fft(padded, spectrum, pool);
+            parallel_for(0, fft_height, grain, [&](std::size_t begin, std::size_t end) {
+                for(std::size_t y = begin ; y < end ; ++y) {
+                    for(std::size_t x = 0 ; x < spectrum.get_width() ; ++x) { spectrum(y, x) *= kernel_spectrum(y, x); }
+                }
+            }, pool);
+            inverse_real_fft(spectrum, padded, pool);
+
+            parallel_for(0, height, band_rows(source.get_width()), [&](std::size_t begin, std::size_t end) {
+                for(std::size_t i = begin ; i < end ; ++i) {
+                    const float* input = &padded[i + kernel_rows - 1][kernel_columns - 1];
+                    float* output = &destination[i][c];
+                    for(std::size_t j = 0 ; j < width ; ++j) { output[j * channels] = input[j]; }
+                }
+            }, pool);
+        }
+    }
+
+    /**
+     * @brief Convolves channels with a kernel. Every destination row is a single weighted sum of
+     * the padded source rows shifted by the columns of the non-zero taps, the padded rows being kept
+     * in a ring while the band moves down.
+     * @param source The source channels, with 'channels' floats per pixel.
+     * @param destination The destination channels.
+     * @param channels The number of floats per pixel.
+     * @param kernel The kernel.
+     * @param border How the pixels outside of the source are extrapolated.
+     * @param pool The pool to process bands of rows on.
+     */
+    void convolve_channels(Array2DView<const float> source, Array2DView<float> destination, std::size_t channels,
+                           Array2DView<const float> kernel, BorderMode border, ThreadPool& pool) {
+        if(destination.empty()) { return; }
+
+        std::vector<float> vertical;
+        std::vector<float> horizontal;
+        if(separate_kernel(kernel, vertical, horizontal)) {
+            if(vertical.size() + horizontal.size() >= fft_taps) {
+                convolve_fft_channels(source, destination, channels, kernel, border, pool);
+            } else {
+                convolve_separable_channels(source, destination, channels, vertical, horizontal, border, pool);
+            }
+            return;
+        }
+
+        std::ptrdiff_t height = static_cast<std::ptrdiff_t>(source.get_height());
+        std::size_t width = source.get_width() / channels;
+        std::size_t kernel_rows = kernel.get_height();
+        std::ptrdiff_t top = static_cast<std::ptrdiff_t>(kernel_rows - 1 - kernel_rows / 2);
+        std::size_t left = kernel.get_width() - 1 - kernel.get_width() / 2;
+        std::size_t right = kernel.get_width() - 1 - left;
+        std::size_t padded_floats = (width + left + right) * channels;
+
+        /**
+         * @struct Tap
+         * @brief A non-zero tap of the flipped kernel.
+         */
+        struct Tap {
+            std::size_t row;    ///< The row of the tap.
+            std::size_t column; ///< The column of the tap.
+            float weight;       ///< The weight of the tap.
+        };
+        std::vector<Tap> taps;
+        for(std::size_t a = 0 ; a < kernel_rows ; ++a) {
+            for(std::size_t b = 0 ; b < kernel.get_width() ; ++b) {
+                float weight = kernel[kernel_rows - 1 - a][kernel.get_width() - 1 - b];
+                if(weight != 0.0f) { taps.push_back(Tap { a, b, weight }); }
+            }
+        }
+        if(taps.size() >= fft_taps) {
+            convolve_fft_channels(source, destination, channels, kernel, border, pool);
+            return;
+        }
+
+        parallel_for(0, source.get_height(), band_rows(source.get_width()), [&](std::size_t begin, std::size_t end) {
+            // Slot p % kernel_rows holds the padded source row at position p, relative to the band.
+            Array<float> ring(kernel_rows * padded_floats, uninitialized);
+            std::vector<std::ptrdiff_t> positions(kernel_rows, std::numeric_limits<std::ptrdiff_t>::min());
+            std::vector<bool> is_zero(kernel_rows);
+            std::vector<const float*> sources;
+            std::vector<float> weights;
+
+            for(std::size_t i = begin ; i < end ; ++i) {
+                std::ptrdiff_t first = static_cast<std::ptrdiff_t>(i) - top;
+                auto slot_of = [&](std::size_t a) {
+                    std::ptrdiff_t rows = static_cast<std::ptrdiff_t>(kernel_rows);
+                    return static_cast<std::size_t>(((first + static_cast<std::ptrdiff_t>(a)) % rows + rows) % rows);
+                };
+
+                for(std::size_t a = 0 ; a < kernel_rows ; ++a) {
+                    std::size_t slot = slot_of(a);
+                    std::ptrdiff_t position = first + static_cast<std::ptrdiff_t>(a);
+                    if(positions[slot] == position) { continue; }
+
+                    positions[slot] = position;
+                    std::ptrdiff_t row = map_index(position, height, border);
+                    is_zero[slot] = row < 0;
+                    if(row >= 0) {
+                        float* padded = ring.get_data() + slot * padded_floats;
+                        std::copy_n(&source[row][0], width * channels, padded + left * channels);
+                        pad_row(padded, width, channels, left, right, border);
+                    }
+                }
+
+                sources.clear();
+                weights.clear();
+                for(const Tap& tap : taps) {
+                    std::size_t slot = slot_of(tap.row);
+                    if(is_zero[slot]) { continue; }
+                    sources.push_back(ring.get_data() + slot * padded_floats + tap.column * channels);
+                    weights.push_back(tap.weight);
+                }
+
+                if(sources.empty()) { destination[i].fill(0.0f); }
+                else { weighted_sum_n(sources.data(), weights.data(), sources.size(), &destination[i][0], width * channels); }
+            }
+        }, pool);
+    }
+
+    /**
+     * @param sigma The standard deviation of a Gaussian.
+     * @return The radii of the 3 box blurs approximating the Gaussian, whose variances sum to
+     * sigma^2 as closely as possible with odd widths (see Kovesi, "Fast Almost-Gaussian Filtering").
+     */
+    std::array<std::size_t, 3> box_radii(float sigma) {
+        constexpr int boxes = 3;
+        double variance = static_cast<double>(sigma) * sigma;
+
+        int lower = static_cast<int>(std::floor(std::sqrt(12.0 * variance / boxes + 1.0)));
+        if(lower % 2 == 0) { --lower; }
+        int upper = lower + 2;
+        int lower_count = static_cast<int>(std::round((12.0 * variance - boxes * lower * lower - 4.0 * boxes * lower - 3.0 * boxes)
+                                                      / (-4.0 * lower - 4.0)));
+
+        std::array<std::size_t, 3> radii;
+        for(int k = 0 ; k < boxes ; ++k) { radii[k] = static_cast<std::size_t>(((k < lower_count ? lower : upper) - 1) / 2); }
+        return radii;
+    }
+
+    /**
+     * @brief Copies the pixels of a row to a column.
+     * @param row The row.
+     * @param width The number of pixels of the row.
+     * @param column The first pixel of the column.
+     * @param stride The number of floats between consecutive pixels of the column.
+     */
+    template <std::size_t channels>
+    void transpose_row(const float* row, std::size_t width, float* column, std::size_t stride) {
+        for(std::size_t j = 0 ; j < width ; ++j) {
+            for(std::size_t c = 0 ; c < channels ; ++c) { column[j * stride + c] = row[j * channels + c]; }
+        }
+    }
+
+    /**
+     * @brief Copies the pixels of a column to a row.
+     * @param column The first pixel of the column.
+     * @param stride The number of floats between consecutive pixels of the column.
+     * @param height The number of pixels of the column.
+     * @param row The row.
+     */
+    template <std::size_t channels>
+    void transpose_column(const float* column, std::size_t stride, std::size_t height, float* row) {
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            for(std::size_t c = 0 ; c < channels ; ++c) { row[i * channels + c] = column[i * stride + c]; }
+        }
+    }
+
+    /**
+     * @brief Box-blurs a strip of columns with running sums, 'count' vectors of columns wide.
+     * @param inputs The 'height + 2 * radius' input rows.
+     * @param outputs The 'height' blurred rows.
+     * @param column The first column of the strip.
+     * @param height The number of blurred rows.
+     * @param radius The radius of the box.
+     */
+    template <typename Vector, std::size_t count>
+    void box_blur_strip(const float* const* inputs, float* const* outputs, std::size_t column, std::size_t height,
+                        std::size_t radius) {
+        constexpr std::size_t lanes = sizeof(Vector) / sizeof(float);
+        float scale = 1.0f / static_cast<float>(2 * radius + 1);
+
+        auto load = [&](std::size_t row, std::size_t v) {
+            Vector value;
+            __builtin_memcpy(&value, inputs[row] + column + v * lanes, sizeof(value));
+            return value;
+        };
+
+        Vector sums[count] {};
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            if(i % restart_rows == 0) {
+                for(std::size_t v = 0 ; v < count ; ++v) { sums[v] = Vector {}; }
+                for(std::size_t t = 0 ; t <= 2 * radius ; ++t) {
+                    for(std::size_t v = 0 ; v < count ; ++v) { sums[v] += load(i + t, v); }
+                }
+            } else {
+                for(std::size_t v = 0 ; v < count ; ++v) { sums[v] += load(i + 2 * radius, v) - load(i - 1, v); }
+            }
+
+            for(std::size_t v = 0 ; v < count ; ++v) {
+                Vector value = sums[v] * scale;
+                __builtin_memcpy(outputs[i] + column + v * lanes, &value, sizeof(value));
+            }
+        }
+    }
+
+    /**
+     * @brief Box-blurs columns with running sums, the blurred columns being shorter by the box's
+     * width minus 1 rows. Strips of columns are processed one after the other, so that their
+     * running sums stay in registers.
+     * @param inputs The 'height + 2 * radius' input rows.
+     * @param outputs The 'height' blurred rows.
+     * @param height The number of blurred rows.
+     * @param count The number of floats of the rows.
+     * @param radius The radius of the box.
+     */
+    void box_blur_columns(const float* const* inputs, float* const* outputs, std::size_t height, std::size_t count,
+                          std::size_t radius) {
+        constexpr std::size_t lanes = sizeof(BoxVector) / sizeof(float);
+
+        std::size_t column = 0;
+        for(; column + strip_vectors * lanes <= count ; column += strip_vectors * lanes) {
+            box_blur_strip<BoxVector, strip_vectors>(inputs, outputs, column, height, radius);
+        }
+        for(; column + lanes <= count ; column += lanes) { box_blur_strip<BoxVector, 1>(inputs, outputs, column, height, radius); }
+        for(; column < count ; ++column) { box_blur_strip<float, 1>(inputs, outputs, column, height, radius); }
+    }
+
+    /**
+     * @brief Blurs channels with a Gaussian. See gaussian_blur.
+     * @param source The source channels, with 'channels' floats per pixel.
+     * @param destination The destination channels.
+     * @param channels The number of floats per pixel.
+     * @param sigma The standard deviation, in pixels.
+     * @param border How the pixels outside of the source are extrapolated.
+     * @param pool The pool to process bands of rows and columns on.
+     */
+    void gaussian_blur_channels(Array2DView<const float> source, Array2DView<float> destination, std::size_t channels,
+                                float sigma, BorderMode border, ThreadPool& pool) {
+        if(destination.empty()) { return; }
+
+        if(sigma < exact_gaussian_sigma) {
+            std::vector<float> kernel = gaussian_kernel(sigma);
+            convolve_separable_channels(source, destination, channels, kernel, kernel, border, pool);
+            return;
+        }
+
+        /*
+         * Every axis is extended once by the radii of all the boxes, each box then blurring only the
+         * pixels the following ones need. Extending it before every box instead would extrapolate
+         * already blurred pixels, which differs from the Gaussian near the edges.
+         */
+        std::array<std::size_t, 3> radii = box_radii(sigma);
+        std::size_t extension = radii[0] + radii[1] + radii[2];
+        std::size_t height = source.get_height();
+        std::size_t width = source.get_width() / channels;
+        std::size_t row_floats = source.get_width();
+
+        // Horizontal boxes, by bands of rows transposed to buffers, where they are blurred as columns.
+        std::size_t band_height = box_columns / channels;
+        std::size_t extended_width = width + 2 * extension;
+        parallel_for(0, (height + band_height - 1) / band_height, 1, [&](std::size_t begin, std::size_t end) {
+            Array<float> padded(extended_width * channels, uninitialized);
+            Array<float> buffers[2] { Array<float>(extended_width * box_columns, uninitialized),
+                                      Array<float>(extended_width * box_columns, uninitialized) };
+            std::vector<const float*> inputs(extended_width);
+            std::vector<float*> outputs(extended_width);
+
+            for(std::size_t band = begin ; band < end ; ++band) {
+                std::size_t first = band * band_height;
+                std::size_t rows = std::min(band_height, height - first);
+
+                for(std::size_t r = 0 ; r < rows ; ++r) {
+                    std::copy_n(&source[first + r][0], row_floats, padded.get_data() + extension * channels);
+                    pad_row(padded.get_data(), width, channels, extension, extension, border);
+                    if(channels == 3) { transpose_row<3>(padded.get_data(), extended_width, &buffers[0][r * channels], box_columns); }
+                    else { transpose_row<1>(padded.get_data(), extended_width, &buffers[0][r], box_columns); }
+                }
+
+                std::size_t remaining = extension;
+                for(std::size_t k = 0 ; k < radii.size() ; ++k) {
+                    remaining -= radii[k];
+                    for(std::size_t t = 0 ; t < width + 2 * (remaining + radii[k]) ; ++t) {
+                        inputs[t] = buffers[k % 2].get_data() + t * box_columns;
+                        outputs[t] = buffers[(k + 1) % 2].get_data() + t * box_columns;
+                    }
+                    box_blur_columns(inputs.data(), outputs.data(), width + 2 * remaining, rows * channels, radii[k]);
+                }
+
+                const float* blurred = buffers[radii.size() % 2].get_data();
+                for(std::size_t r = 0 ; r < rows ; ++r) {
+                    if(channels == 3) { transpose_column<3>(blurred + r * channels, box_columns, width, &destination[first + r][0]); }
+                    else { transpose_column<1>(blurred + r, box_columns, width, &destination[first + r][0]); }
+                }
+            }
+        }, pool);
+
+        // Vertical boxes, by bands of columns, the first box reading the rows and the last one writing them.
+        std::size_t extended_height = height + 2 * extension;
+        parallel_for(0, (row_floats + box_columns - 1) / box_columns, 1, [&](std::size_t begin, std::size_t end) {
+            Array<float> zeros(box_columns);
+            Array<float> buffers[2] { Array<float>(extended_height * box_columns, uninitialized),
+                                      Array<float>(extended_height * box_columns, uninitialized) };
+            std::vector<const float*> inputs(extended_height);
+            std::vector<float*> outputs(extended_height);
+
+            for(std::size_t band = begin ; band < end ; ++band) {
+                std::size_t first = band * box_columns;
+                std::size_t count = std::min(box_columns, row_floats - first);
+
+                std::size_t remaining = extension;
+                for(std::size_t k = 0 ; k < radii.size() ; ++k) {
+                    remaining -= radii[k];
+                    std::size_t blurred_height = height + 2 * remaining;
+
+                    for(std::size_t t = 0 ; t < blurred_height + 2 * radii[k] ; ++t) {
+                        if(k == 0) {
+                            std::ptrdiff_t row = map_index(static_cast<std::ptrdiff_t>(t) - static_cast<std::ptrdiff_t>(extension),
+                                                           static_cast<std::ptrdiff_t>(height), border);
+                            inputs[t] = row < 0 ? zeros.get_data() : &destination[row][first];
+                        } else {
+                            inputs[t] = buffers[(k - 1) % 2].get_data() + t * box_columns;
+                        }
+                    }
+                    for(std::size_t i = 0 ; i < blurred_height ; ++i) {
+                        outputs[i] = k + 1 < radii.size() ? buffers[k % 2].get_data() + i * box_columns : &destination[i][first];
+                    }
+
+                    box_blur_columns(inputs.data(), outputs.data(), blurred_height, count, radii[k]);
+                }
+            }
+        }, pool);
+    }
+}
+
+bool separate_kernel(Array2DView<const float> kernel, std::vector<float>& vertical, std::vector<float>& horizontal,
+                     float tolerance) {
+    std::size_t rows = kernel.get_height();
+    std::size_t columns = kernel.get_width();
+    vertical.assign(rows, 0.0f);
+    horizontal.assign(columns, 0.0f);
+    if(kernel.empty()) { return true; }
+
+    // A separable kernel is the product of its largest element's column and row.
+    std::size_t pivot_row = 0;
+    std::size_t pivot_column = 0;
+    for(std::size_t a = 0 ; a < rows ; ++a) {
+        for(std::size_t b = 0 ; b < columns ; ++b) {
+            if(std::abs(kernel[a][b]) > std::abs(kernel[pivot_row][pivot_column])) {
+                pivot_row = a;
+                pivot_column = b;
+            }
+        }
+    }
+
+    float pivot = kernel[pivot_row][pivot_column];
+    if(pivot == 0.0f) { return true; }
+
+    for(std::size_t a = 0 ; a < rows ; ++a) { vertical[a] = kernel[a][pivot_column]; }
+    for(std::size_t b = 0 ; b < columns ; ++b) { horizontal[b] = kernel[pivot_row][b] / pivot; }
+
+    for(std::size_t a = 0 ; a < rows ; ++a) {
+        for(std::size_t b = 0 ; b < columns ; ++b) {
+            if(std::abs(kernel[a][b] - vertical[a] * horizontal[b]) > tolerance * std::abs(pivot)) { return false; }
+        }
+    }
+
+    return true;
+}
+
+std::vector<float> gaussian_kernel(float sigma) {
+    if(sigma <= 0.0f) { return { 1.0f }; }
+
+    std::size_t radius = static_cast<std::size_t>(std::ceil(3.0f * sigma));
+    std::vector<float> kernel(2 * radius + 1);
+    double sum = 0.0;
+    for(std::size_t k = 0 ; k < kernel.size() ; ++k) {
+        double x = static_cast<double>(k) - static_cast<double>(radius);
+        kernel[k] = static_cast<float>(std::exp(-x * x / (2.0 * sigma * sigma)));
+        sum += kernel[k];
+    }
+    for(float& weight : kernel) { weight = static_cast<float>(weight / sum); }
+
+    return kernel;
+}
+
+void convolve(Array2DView<const float> source, Array2DView<float> destination, Array2DView<const float> kernel,
+              BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    convolve_channels(source, destination, 1, kernel, border, pool);
+}
+
+void convolve(Array2DView<const vec3> source, Array2DView<vec3> destination, Array2DView<const float> kernel,
+              BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    convolve_channels(as_floats(source), as_floats(destination), 3, kernel, border, pool);
+}
+
+void convolve_fft(Array2DView<const float> source, Array2DView<float> destination, Array2DView<const float> kernel,
+                  BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    convolve_fft_channels(source, destination, 1, kernel, border, pool);
+}
+
+void convolve_fft(Array2DView<const vec3> source, Array2DView<vec3> destination, Array2DView<const float> kernel,
+                  BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    convolve_fft_channels(as_floats(source), as_floats(destination), 3, kernel, border, pool);
+}
+
+void convolve_separable(Array2DView<const float> source, Array2DView<float> destination,
+                        std::span<const float> vertical, std::span<const float> horizontal,
+                        BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    convolve_separable_channels(source, destination, 1, vertical, horizontal, border, pool);
+}
+
+void convolve_separable(Array2DView<const vec3> source, Array2DView<vec3> destination,
+                        std::span<const float> vertical, std::span<const float> horizontal,
+                        BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    convolve_separable_channels(as_floats(source), as_floats(destination), 3, vertical, horizontal, border, pool);
+}
+
+void gaussian_blur(Array2DView<const float> source, Array2DView<float> destination, float sigma,
+                   BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    gaussian_blur_channels(source, destination, 1, sigma, border, pool);
+}
+
+void gaussian_blur(Array2DView<const vec3> source, Array2DView<vec3> destination, float sigma,
+                   BorderMode border, ThreadPool& pool) {
+    check_dimensions(source, destination);
+    gaussian_blur_channels(as_floats(source), as_floats(destination), 3, sigma, border, pool);
+}
@@ -0,0 +1,684 @@
+/***************************************************************************************************
+ * @file  deflate.cpp
+ * @brief Implementation of the deflate compressor and of the zlib and PNG checksums
+ **************************************************************************************************/
+
+#include "deflate.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstring>
+#include <queue>
+#include <utility>
+
+namespace {
+    /// The maximum distance of a match.
+    constexpr std::size_t window_size = 32768;
+
+    /// The shortest and longest matches.
+    constexpr std::size_t min_match = 3;
+    constexpr std::size_t max_match = 258;
+
+    /// The number of bits of the hashes of the 3-byte sequences starting matches.
+    constexpr unsigned int hash_bits = 15;
+
+    /// The maximum number of literals and matches of a block.
+    constexpr std::size_t max_block_symbols = 1 << 14;
+
+    /// The maximum size of a stored block.
+    constexpr std::size_t max_stored_size = 65535;
+
+    /// The number of literal/length codes, and of distance codes.
+    constexpr std::size_t literal_codes = 286;
+    constexpr std::size_t distance_codes = 30;
+
+    /// The code ending blocks.
+    constexpr uint16_t end_of_block = 256;
+
+    /// The smallest length of each length code, and its number of extra bits.
+    constexpr uint16_t length_base[29] = {
+        3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258
+    };
+    constexpr uint8_t length_extra[29] = {
+        0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0
+    };
+
+    /// The smallest distance of each distance code, and its number of extra bits.
+    constexpr uint16_t distance_base[30] = {
+        1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097,
+        6145, 8193, 12289, 16385, 24577
+    };
+    constexpr uint8_t distance_extra[30] = {
+        0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13
+    };
+
+    /// The order in which the lengths of the code length codes are stored.
+    constexpr uint8_t code_length_order[19] = { 16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15 };
+
+    /**
+     * @struct LevelParameters
+     * @brief How hard a compression level searches for matches.
+     */
+    struct LevelParameters {
+        std::size_t good_length; ///< The length of a previous match above which the search is shortened.
+        std::size_t lazy_length; ///< The length of a match above which it is taken without trying the next
+                                 ///< byte, or, without lazy matching, above which its bytes aren't hashed.
+        std::size_t nice_length; ///< The length above which a match is taken without looking further.
+        unsigned int max_chain;  ///< The maximum number of candidates tried per position.
+        bool lazy;               ///< Whether a match can be deferred for a longer one at the next byte.
+    };
+
+    /// The parameters of every compression level, the ones of zlib.
+    constexpr LevelParameters level_parameters[max_compression_level + 1] = {
+        { 0, 0, 0, 0, false },
+        { 4, 4, 8, 4, false }, { 4, 5, 16, 8, false }, { 4, 6, 32, 32, false },
+        { 4, 4, 16, 16, true }, { 8, 16, 32, 32, true }, { 8, 16, 128, 128, true },
+        { 8, 32, 128, 256, true }, { 32, 128, 258, 1024, true }, { 32, 258, 258, 4096, true }
+    };
+
+    /**
+     * @struct CodeTables
+     * @brief Lookup tables mapping lengths and distances to their codes.
+     */
+    struct CodeTables {
+        uint8_t length_code[max_match + 1]; ///< The code of each match length.
+        uint8_t distance_code[512];          ///< The code of distance - 1 if below 256, else at 256 + (distance - 1) / 128.
+
+        /**
+         * @brief Computes the tables.
+         */
+        constexpr CodeTables() : length_code(), distance_code() {
+            for(uint8_t code = 0 ; code < 29 ; ++code) {
+                for(std::size_t length = length_base[code] ; length < length_base[code] + (1u << length_extra[code]) && length <= max_match ; ++length) {
+                    length_code[length] = code;
+                }
+            }
+            length_code[max_match] = 28;
+
+            for(uint8_t code = 0 ; code < 30 ; ++code) {
+                for(std::size_t distance = distance_base[code] ; distance < distance_base[code] + (1u << distance_extra[code]) ; ++distance) {
+                    std::size_t index = distance - 1;
+                    distance_code[index < 256 ? index : 256 + (index >> 7)] = code;
+                }
+            }
+        }
+
+        /**
+         * @param distance A match distance, from 1 to 32768.
+         * @return Its distance code.
+         */
+        constexpr uint8_t get_distance_code(std::size_t distance) const {
+            std::size_t index = distance - 1;
+            return distance_code[index < 256 ? index : 256 + (index >> 7)];
+        }
+    };
+
+    /// The lookup tables of the codes.
+    constexpr CodeTables code_tables;
+
+    /**
+     * @struct Symbol
+     * @brief A literal byte or a match, as found by the match finder.
+     */
+    struct Symbol {
+        uint16_t value;    ///< The literal byte, or the length of the match.
+        uint16_t distance; ///< The distance of the match, 0 for a literal.
+    };
+
+    /**
+     * @class BitWriter
+     * @brief Appends bits to a byte buffer, least significant bit first, as deflate stores them.
+     */
+    class BitWriter {
+    public:
+        /**
+         * @brief Constructs a writer appending to a buffer.
+         * @param output The buffer.
+         */
+        explicit BitWriter(std::vector<std::byte>& output) : output(output), bits(0), count(0) { }
+
+        /**
+         * @brief Appends bits.
+         * @param value The bits, in the lowest bits of the value.
+         * @param length The number of bits, at most 32.
+         */
+        void write(uint32_t value, unsigned int length) {
+            bits |= static_cast<uint64_t>(value) << count;
+            count += length;
+            if(count >= 32) {
+                for(int i = 0 ; i < 4 ; ++i) { output.push_back(static_cast<std::byte>(bits >> (8 * i))); }
+                bits >>= 32;
+                count -= 32;
+            }
+        }
+
+        /**
+         * @brief Pads the written bits with zeros up to the next byte boundary.
+         */
+        void align() {
+            for(; count > 0 ; count = count > 8 ? count - 8 : 0) {
+                output.push_back(static_cast<std::byte>(bits));
+                bits >>= 8;
+            }
+            bits = 0;
+        }
+
+        /**
+         * @brief Appends bytes, after aligning.
+         * @param data A pointer to the bytes.
+         * @param size The number of bytes.
+         */
+        void write_bytes(const uint8_t* data, std::size_t size) {
+            align();
+            const std::byte* bytes = reinterpret_cast<const std::byte*>(data);
+            output.insert(output.end(), bytes, bytes + size);
+        }
+
+    private:
+        std::vector<std::byte>& output; ///< The buffer.
+        uint64_t bits;                  ///< The bits not appended yet.
+        unsigned int count;             ///< The number of bits not appended yet.
+    };
+
+    /**
+     * @brief Computes the lengths of a Huffman code, with no code longer than a limit. Unused
+     * symbols get a length of 0. At least 2 symbols get a code, so that the code is complete.
+     * @param frequencies The frequency of each symbol.
+     * @param count The number of symbols.
+     * @param limit The maximum length of a code.
+     * @param lengths Receives the length of the code of each symbol.
+     */
+    void build_lengths(const uint32_t* frequencies, std::size_t count, unsigned int limit, uint8_t* lengths) {
+        std::vector<uint32_t> weights(frequencies, frequencies + count);
+        if(std::count_if(weights.begin(), weights.end(), [](uint32_t weight) { return weight > 0; }) < 2) {
+            weights[0] = std::max(weights[0], 1u);
+            weights[1] = std::max(weights[1], 1u);
+        }
+
+        std::vector<uint64_t> node_weights;
+        std::vector<int> parents;
+        std::vector<std::size_t> leaves;
+
+        while(true) {
+            node_weights.clear();
+            parents.clear();
+            leaves.clear();
+
+            using Node = std::pair<uint64_t, int>;
+            std::priority_queue<Node, std::vector<Node>, std::greater<Node>> queue;
+            for(std::size_t i = 0 ; i < count ; ++i) {
+                if(weights[i] == 0) { continue; }
+                queue.emplace(weights[i], static_cast<int>(node_weights.size()));
+                node_weights.push_back(weights[i]);
+                parents.push_back(-1);
+                leaves.push_back(i);
+            }
+
+            while(queue.size() > 1) {
+                auto [first_weight, first] = queue.top();
+                queue.pop();
+                auto [second_weight, second] = queue.top();
+                queue.pop();
+
+                int node = static_cast<int>(node_weights.size());
+                node_weights.push_back(first_weight + second_weight);
+                parents.push_back(-1);
+                parents[first] = node;
+                parents[second] = node;
+                queue.emplace(first_weight + second_weight, node);
+            }
+
+            std::fill_n(lengths, count, 0);
+            unsigned int max_length = 0;
+            for(std::size_t leaf = 0 ; leaf < leaves.size() ; ++leaf) {
+                unsigned int length = 0;
+                for(int node = parents[leaf] ; node != -1 ; node = parents[node]) { ++length; }
+                lengths[leaves[leaf]] = static_cast<uint8_t>(length);
+                max_length = std::max(max_length, length);
+            }
+
+            if(max_length <= limit) { return; }
+
+            // Flattening the frequencies shortens the longest codes, until they fit.
+            for(uint32_t& weight : weights) {
+                if(weight > 0) { weight = (weight >> 1) | 1; }
+            }
+        }
+    }
+
+    /**
+     * @brief Computes the canonical Huffman codes of given lengths, bit-reversed to be written least
+     * significant bit first.
+     * @param lengths The length of the code of each symbol.
+     * @param count The number of symbols.
+     * @param codes Receives the code of each symbol.
+     */
+    void build_codes(const uint8_t* lengths, std::size_t count, uint16_t* codes) {
+        uint16_t length_counts[16] {};
+        for(std::size_t i = 0 ; i < count ; ++i) { ++length_counts[lengths[i]]; }
+        length_counts[0] = 0;
+
+        uint16_t next_code[16] {};
+        uint16_t code = 0;
+        for(std::size_t length = 1 ; length < 16 ; ++length) {
+            code = (code + length_counts[length - 1]) << 1;
+            next_code[length] = code;
+        }
+
+        for(std::size_t i = 0 ; i < count ; ++i) {
+            if(lengths[i] == 0) { codes[i] = 0; continue; }
+
+            uint16_t value = next_code[lengths[i]]++;
+            uint16_t reversed = 0;
+            for(unsigned int bit = 0 ; bit < lengths[i] ; ++bit) { reversed |= ((value >> bit) & 1) << (lengths[i] - 1 - bit); }
+            codes[i] = reversed;
+        }
+    }
+
+    /**
+     * @struct HuffmanCode
+     * @brief The codes of the literal/length and distance alphabets of a block.
+     */
+    struct HuffmanCode {
+        uint8_t literal_lengths[288];  ///< The length of the code of each literal/length symbol.
+        uint16_t literal_codes[288];   ///< The bit-reversed code of each literal/length symbol.
+        uint8_t distance_lengths[32];  ///< The length of the code of each distance symbol.
+        uint16_t distance_codes[32];   ///< The bit-reversed code of each distance symbol.
+    };
+
+    /**
+     * @return The fixed codes of deflate.
+     */
+    HuffmanCode make_fixed_code() {
+        HuffmanCode code {};
+        for(std::size_t i = 0 ; i < 288 ; ++i) { code.literal_lengths[i] = i < 144 ? 8 : i < 256 ? 9 : i < 280 ? 7 : 8; }
+        std::fill_n(code.distance_lengths, 32, 5);
+        build_codes(code.literal_lengths, 288, code.literal_codes);
+        build_codes(code.distance_lengths, 32, code.distance_codes);
+
+        return code;
+    }
+
+    /// The fixed codes of deflate.
+    const HuffmanCode fixed_code = make_fixed_code();
+
+    /**
+     * @param symbols The symbols of a block.
+     * @param code The codes to write them with.
+     * @return The number of bits taken by the symbols and the end of the block.
+     */
+    std::size_t symbols_cost(const std::vector<Symbol>& symbols, const HuffmanCode& code) {
+        std::size_t cost = code.literal_lengths[end_of_block];
+        for(const Symbol& symbol : symbols) {
+            if(symbol.distance == 0) {
+                cost += code.literal_lengths[symbol.value];
+            } else {
+                uint8_t length_code = code_tables.length_code[symbol.value];
+                uint8_t distance_code = code_tables.get_distance_code(symbol.distance);
+                cost += code.literal_lengths[257 + length_code] + length_extra[length_code];
+                cost += code.distance_lengths[distance_code] + distance_extra[distance_code];
+            }
+        }
+
+        return cost;
+    }
+
+    /**
+     * @brief Writes the symbols of a block and its end.
+     * @param writer The writer.
+     * @param symbols The symbols.
+     * @param code The codes to write them with.
+     */
+    void write_symbols(BitWriter& writer, const std::vector<Symbol>& symbols, const HuffmanCode& code) {
+        for(const Symbol& symbol : symbols) {
+            if(symbol.distance == 0) {
+                writer.write(code.literal_codes[symbol.value], code.literal_lengths[symbol.value]);
+            } else {
+                uint8_t length_code = code_tables.length_code[symbol.value];
+                writer.write(code.literal_codes[257 + length_code], code.literal_lengths[257 + length_code]);
+                writer.write(symbol.value - length_base[length_code], length_extra[length_code]);
+
+                uint8_t distance_code = code_tables.get_distance_code(symbol.distance);
+                writer.write(code.distance_codes[distance_code], code.distance_lengths[distance_code]);
+                writer.write(symbol.distance - distance_base[distance_code], distance_extra[distance_code]);
+            }
+        }
+
+        writer.write(code.literal_codes[end_of_block], code.literal_lengths[end_of_block]);
+    }
+
+    /**
+     * @brief Writes data as stored blocks.
+     * @param writer The writer.
+     * @param data A pointer to the data.
+     * @param size The number of bytes, possibly 0.
+     * @param final Whether the last block ends the stream.
+     */
+    void write_stored(BitWriter& writer, const uint8_t* data, std::size_t size, bool final) {
+        do {
+            std::size_t length = std::min(size, max_stored_size);
+            size -= length;
+
+            writer.write(final && size == 0, 1);
+            writer.write(0, 2);
+            writer.align();
+            writer.write(static_cast<uint32_t>(length), 16);
+            writer.write(static_cast<uint32_t>(~length & 0xFFFF), 16);
+            writer.write_bytes(data, length);
+            data += length;
+        } while(size > 0);
+    }
+
+    /**
+     * @brief Writes a block with the cheapest of dynamic codes, fixed codes and no compression.
+     * @param writer The writer.
+     * @param symbols The symbols of the block.
+     * @param data A pointer to the bytes the symbols encode.
+     * @param size The number of bytes the symbols encode.
+     * @param final Whether the block ends the stream.
+     */
+    void write_block(BitWriter& writer, const std::vector<Symbol>& symbols, const uint8_t* data, std::size_t size,
+                     bool final) {
+        uint32_t literal_frequencies[literal_codes] {};
+        uint32_t distance_frequencies[distance_codes] {};
+        literal_frequencies[end_of_block] = 1;
+        for(const Symbol& symbol : symbols) {
+            if(symbol.distance == 0) {
+                ++literal_frequencies[symbol.value];
+            } else {
+                ++literal_frequencies[257 + code_tables.length_code[symbol.value]];
+                ++distance_frequencies[code_tables.get_distance_code(symbol.distance)];
+            }
+        }
+
+        HuffmanCode code {};
+        build_lengths(literal_frequencies, literal_codes, 15, code.literal_lengths);
+        build_lengths(distance_frequencies, distance_codes, 15, code.distance_lengths);
+        build_codes(code.literal_lengths, literal_codes, code.literal_codes);
+        build_codes(code.distance_lengths, distance_codes, code.distance_codes);
+
+        std::size_t literal_count = literal_codes;
+        while(literal_count > 257 && code.literal_lengths[literal_count - 1] == 0) { --literal_count; }
+        std::size_t distance_count = distance_codes;
+        while(distance_count > 1 && code.distance_lengths[distance_count - 1] == 0) { --distance_count; }
+
+        // The code lengths of both alphabets are run-length encoded with the symbols 16 (repeat the
+        // previous length), 17 and 18 (repeat zeros), then Huffman coded themselves.
+        uint8_t all_lengths[literal_codes + distance_codes];
+        std::copy_n(code.literal_lengths, literal_count, all_lengths);
+        std::copy_n(code.distance_lengths, distance_count, all_lengths + literal_count);
+        std::size_t total = literal_count + distance_count;
+
+        std::vector<std::pair<uint8_t, uint8_t>> runs; // The symbol and its extra bits.
+        for(std::size_t i = 0 ; i < total ;) {
+            uint8_t length = all_lengths[i];
+            std::size_t run = 1;
+            while(i + run < total && all_lengths[i + run] == length) { ++run; }
+
+            if(length == 0 && run >= 3) {
+                run = std::min<std::size_t>(run, 138);
+                if(run >= 11) { runs.emplace_back(18, run - 11); }
+                else { runs.emplace_back(17, run - 3); }
+            } else if(length != 0 && run >= 4) {
+                run = std::min<std::size_t>(run, 7);
+                runs.emplace_back(length, 0);
+                runs.emplace_back(16, run - 4);
+            } else {
+                run = 1;
+                runs.emplace_back(length, 0);
+            }
+            i += run;
+        }
+
+        uint32_t length_frequencies[19] {};
+        for(auto [symbol, extra] : runs) { ++length_frequencies[symbol]; }
+        uint8_t length_lengths[19];
+        uint16_t length_codes[19];
+        build_lengths(length_frequencies, 19, 7, length_lengths);
+        build_codes(length_lengths, 19, length_codes);
+
+        std::size_t length_count = 19;
+        while(length_count > 4 && length_lengths[code_length_order[length_count - 1]] == 0) { --length_count; }
+
+        std::size_t dynamic_cost = 3 + 5 + 5 + 4 + 3 * length_count + symbols_cost(symbols, code);
+        for(auto [symbol, extra] : runs) {
+            dynamic_cost += length_lengths[symbol] + (symbol == 16 ? 2 : symbol == 17 ? 3 : symbol == 18 ? 7 : 0);
+        }
+        std::size_t fixed_cost = 3 + symbols_cost(symbols, fixed_code);
+        std::size_t stored_cost = (size + 5 * (size / max_stored_size + 1)) * 8;
+
+        if(stored_cost <= dynamic_cost && stored_cost <= fixed_cost) {
+            write_stored(writer, data, size, final);
+        } else if(fixed_cost <= dynamic_cost) {
+            writer.write(final, 1);
+            writer.write(1, 2);
+            write_symbols(writer, symbols, fixed_code);
+        } else {
+            writer.write(final, 1);
+            writer.write(2, 2);
+            writer.write(static_cast<uint32_t>(literal_count - 257), 5);
+            writer.write(static_cast<uint32_t>(distance_count - 1), 5);
+            writer.write(static_cast<uint32_t>(length_count - 4), 4);
+            for(std::size_t i = 0 ; i < length_count ; ++i) { writer.write(length_lengths[code_length_order[i]], 3); }
+            for(auto [symbol, extra] : runs) {
+                writer.write(length_codes[symbol], length_lengths[symbol]);
+                if(symbol == 16) { writer.write(extra, 2); }
+                else if(symbol == 17) { writer.write(extra, 3); }
+                else if(symbol == 18) { writer.write(extra, 7); }
+            }
+            write_symbols(writer, symbols, code);
+        }
+    }
+
+    /**
+     * @param first A pointer to the first sequence.
+     * @param second A pointer to the second sequence.
+     * @param limit The maximum number of bytes to compare.
+     * @return The number of leading bytes both sequences have in common.
+     */
+    std::size_t match_length(const uint8_t* first, const uint8_t* second, std::size_t limit) {
+        std::size_t length = 0;
+        for(; length + 8 <= limit ; length += 8) {
+            uint64_t a, b;
+            std::memcpy(&a, first + length, 8);
+            std::memcpy(&b, second + length, 8);
+            if(a != b) {
+                if constexpr(std::endian::native == std::endian::little) { return length + std::countr_zero(a ^ b) / 8; }
+                else { return length + std::countl_zero(a ^ b) / 8; }
+            }
+        }
+        while(length < limit && first[length] == second[length]) { ++length; }
+
+        return length;
+    }
+}
+
+void deflate(const uint8_t* data, std::size_t size, int level, DeflateFlush flush, std::vector<std::byte>& output) {
+    level = std::clamp(level, 0, max_compression_level);
+    bool finish = flush == DeflateFlush::Finish;
+    BitWriter writer(output);
+
+    if(level == 0) {
+        if(size > 0 || finish) { write_stored(writer, data, size, finish); }
+    } else {
+        const LevelParameters& parameters = level_parameters[level];
+        std::vector<int32_t> head(1 << hash_bits, -1);
+        std::vector<int32_t> previous(window_size);
+
+        auto hash = [&](std::size_t position) {
+            uint32_t sequence = data[position] | data[position + 1] << 8 | data[position + 2] << 16;
+            return (sequence * 2654435761u) >> (32 - hash_bits);
+        };
+        auto insert = [&](std::size_t position) {
+            uint32_t key = hash(position);
+            previous[position % window_size] = head[key];
+            head[key] = static_cast<int32_t>(position);
+        };
+
+        // Candidates are visited from the newest, and their distance only grows along the chain.
+        auto find = [&](std::size_t position, unsigned int chain, std::size_t& distance) {
+            std::size_t best = 0;
+            std::size_t limit = std::min(max_match, size - position);
+
+            for(int32_t candidate = head[hash(position)] ;
+                candidate >= 0 && position - candidate <= window_size && chain-- > 0 ;
+                candidate = previous[candidate % window_size]) {
+                if(data[candidate + best] != data[position + best]) { continue; }
+
+                std::size_t length = match_length(data + candidate, data + position, limit);
+                if(length > best) {
+                    best = length;
+                    distance = position - candidate;
+                    if(length >= parameters.nice_length || length == limit) { break; }
+                }
+            }
+
+            return best >= min_match ? best : 0;
+        };
+
+        std::vector<Symbol> symbols;
+        symbols.reserve(max_block_symbols);
+        std::size_t block_start = 0;
+        auto end_block = [&](std::size_t position) {
+            if(symbols.size() >= max_block_symbols) {
+                write_block(writer, symbols, data + block_start, position - block_start, false);
+                symbols.clear();
+                block_start = position;
+            }
+        };
+
+        if(!parameters.lazy) {
+            for(std::size_t position = 0 ; position < size ;) {
+                end_block(position);
+
+                std::size_t distance = 0;
+                std::size_t length = 0;
+                if(position + min_match <= size) {
+                    length = find(position, parameters.max_chain, distance);
+                    insert(position);
+                }
+
+                if(length > 0) {
+                    symbols.push_back({ static_cast<uint16_t>(length), static_cast<uint16_t>(distance) });
+                    if(length <= parameters.lazy_length) {
+                        for(std::size_t k = 1 ; k < length && position + k + min_match <= size ; ++k) { insert(position + k); }
+                    }
+                    position += length;
+                } else {
+                    symbols.push_back({ data[position], 0 });
+                    ++position;
+                }
+            }
+        } else {
+            // The match found at a byte is only emitted once the next byte is known not to start a
+            // longer one, otherwise the byte becomes a literal.
+            std::size_t previous_length = 0;
+            std::size_t previous_distance = 0;
+            bool pending = false;
+
+            for(std::size_t position = 0 ; position < size ;) {
+                // A block must end right after its last symbol, so a full block first flushes the
+                // deferred byte as a literal, giving up the match it may start.
+                if(pending && symbols.size() >= max_block_symbols) {
+                    symbols.push_back({ data[position - 1], 0 });
+                    previous_length = 0;
+                    pending = false;
+                }
+                end_block(position);
+
+                std::size_t distance = 0;
+                std::size_t length = 0;
+                if(position + min_match <= size) {
+                    if(previous_length < parameters.lazy_length) {
+                        unsigned int chain = parameters.max_chain;
+                        if(previous_length >= parameters.good_length) { chain >>= 2; }
+                        length = find(position, chain, distance);
+                    }
+                    insert(position);
+                }
+
+                if(previous_length > 0 && length <= previous_length) {
+                    symbols.push_back({ static_cast<uint16_t>(previous_length), static_cast<uint16_t>(previous_distance) });
+                    std::size_t end = position - 1 + previous_length;
+                    for(std::size_t k = position + 1 ; k < end && k + min_match <= size ; ++k) { insert(k); }
+                    position = end;
+                    previous_length = 0;
+                    pending = false;
+                } else {
+                    if(pending) { symbols.push_back({ data[position - 1], 0 }); }
+                    previous_length = length;
+                    previous_distance = distance;
+                    pending = true;
+                    ++position;
+                }
+            }
+
+            if(pending) { symbols.push_back({ data[size - 1], 0 }); }
+        }
+
+        if(!symbols.empty() || finish) {
+            write_block(writer, symbols, data + block_start, size - block_start, finish);
+        }
+    }
+
+    // A sync flush is an empty stored block, which also aligns the stream.
+    if(!finish) { write_stored(writer, nullptr, 0, false); }
+    writer.align();
+}
+
+uint32_t adler32(const uint8_t* data, std::size_t size, uint32_t adler) {
+    constexpr uint32_t modulo = 65521;
+    constexpr std::size_t max_run = 5552; // The longest run whose sums can't overflow before the modulo.
+
+    uint32_t a = adler & 0xFFFF;
+    uint32_t b = adler >> 16;
+    while(size > 0) {
+        std::size_t run = std::min(size, max_run);
+        size -= run;
+        for(std::size_t i = 0 ; i < run ; ++i) {
+            a += data[i];
+            b += a;
+        }
+        data += run;
+        a %= modulo;
+        b %= modulo;
+    }
+
+    return b << 16 | a;
+}
+
+uint32_t adler32_combine(uint32_t first, uint32_t second, std::size_t second_size) {
+    constexpr uint32_t modulo = 65521;
+
+    uint64_t remainder = second_size % modulo;
+    uint64_t a = (first & 0xFFFF) + (second & 0xFFFF) + modulo - 1;
+    uint64_t b = remainder * (first & 0xFFFF) % modulo + (first >> 16) + (second >> 16) + modulo - remainder;
+
+    return static_cast<uint32_t>(b % modulo) << 16 | static_cast<uint32_t>(a % modulo);
+}
+
+uint32_t crc32(const uint8_t* data, std::size_t size, uint32_t crc) {
+    // Slicing by 4: 4 tables let 4 bytes be processed per step.
+    static const auto tables = [] {
+        std::array<std::array<uint32_t, 256>, 4> tables {};
+        for(uint32_t i = 0 ; i < 256 ; ++i) {
+            uint32_t value = i;
+            for(int bit = 0 ; bit < 8 ; ++bit) { value = value & 1 ? 0xEDB88320u ^ (value >> 1) : value >> 1; }
+            tables[0][i] = value;
+        }
+        for(uint32_t i = 0 ; i < 256 ; ++i) {
+            for(std::size_t t = 1 ; t < 4 ; ++t) { tables[t][i] = tables[0][tables[t - 1][i] & 0xFF] ^ (tables[t - 1][i] >> 8); }
+        }
+        return tables;
+    }();
+
+    crc = ~crc;
+    for(; size >= 4 ; size -= 4, data += 4) {
+        crc ^= uint32_t(data[0]) | uint32_t(data[1]) << 8 | uint32_t(data[2]) << 16 | uint32_t(data[3]) << 24;
+        crc = tables[3][crc & 0xFF] ^ tables[2][(crc >> 8) & 0xFF] ^ tables[1][(crc >> 16) & 0xFF] ^ tables[0][crc >> 24];
+    }
+    for(; size > 0 ; --size, ++data) { crc = tables[0][(crc ^ *data) & 0xFF] ^ (crc >> 8); }
+
+    return ~crc;
+}
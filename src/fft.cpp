@@ -0,0 +1,103 @@
+/***************************************************************************************************
+ * @file  fft.cpp
+ * @brief Implementation of the discrete Fourier transforms of arrays and 2D arrays
+ **************************************************************************************************/
+
+#include "fft.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include "Array.hpp"
+#include "RealFFTPlan.hpp"
+#include "parallel.hpp"
+
+namespace {
+    typedef std::complex<float> Complex;
+
+    /// Number of columns transformed at once, copied to a contiguous buffer where they are interleaved.
+    constexpr std::size_t band_columns = 16;
+
+    /**
+     * @param row_elements The number of elements of a row.
+     * @return The number of rows of the bands transformed in parallel.
+     */
+    std::size_t band_rows(std::size_t row_elements) {
+        return std::max<std::size_t>(default_tile_bytes / (sizeof(Complex) * std::max<std::size_t>(row_elements, 1)), 1);
+    }
+
+    /**
+     * @brief Transforms the columns of a 2D array in place, by bands of columns.
+     * @param data The 2D array.
+     * @param direction The direction of the transform.
+     * @param pool The pool to transform the bands on.
+     */
+    void transform_columns(Array2DView<Complex> data, FFTDirection direction, ThreadPool& pool) {
+        std::size_t height = data.get_height();
+        std::size_t width = data.get_width();
+        std::shared_ptr<const FFTPlan> plan = FFTPlan::get(height);
+
+        parallel_for(0, (width + band_columns - 1) / band_columns, 1, [&](std::size_t begin, std::size_t end) {
+            Array<Complex> band(height * band_columns, uninitialized);
+            Array<Complex> scratch(height * band_columns, uninitialized);
+
+            for(std::size_t b = begin ; b < end ; ++b) {
+                std::size_t first = b * band_columns;
+                std::size_t count = std::min(band_columns, width - first);
+
+                for(std::size_t i = 0 ; i < height ; ++i) { std::copy_n(&data[i][first], count, &band[i * count]); }
+                plan->transform(band.get_data(), scratch.get_data(), direction, count);
+                for(std::size_t i = 0 ; i < height ; ++i) { std::copy_n(&band[i * count], count, &data[i][first]); }
+            }
+        }, pool);
+    }
+}
+
+void fft(ArrayView<Complex> data, FFTDirection direction) {
+    if(data.empty()) { return; }
+
+    Array<Complex> scratch(data.get_size(), uninitialized);
+    FFTPlan::get(data.get_size())->transform(data.get_data(), scratch.get_data(), direction);
+}
+
+void fft(Array2DView<Complex> data, FFTDirection direction, ThreadPool& pool) {
+    if(data.empty()) { return; }
+
+    std::size_t width = data.get_width();
+    std::shared_ptr<const FFTPlan> plan = FFTPlan::get(width);
+    parallel_for(0, data.get_height(), band_rows(width), [&](std::size_t begin, std::size_t end) {
+        Array<Complex> scratch(width, uninitialized);
+        for(std::size_t i = begin ; i < end ; ++i) { plan->transform(&data[i][0], scratch.get_data(), direction); }
+    }, pool);
+
+    transform_columns(data, direction, pool);
+}
+
+void real_fft(Array2DView<const float> input, Array2DView<Complex> spectrum, ThreadPool& pool) {
+    if(spectrum.get_height() != input.get_height() || spectrum.get_width() != input.get_width() / 2 + 1) {
+        throw std::invalid_argument("Couldn't compute a spectrum of the wrong dimensions");
+    }
+    if(input.empty()) { return; }
+
+    std::shared_ptr<const RealFFTPlan> plan = RealFFTPlan::get(input.get_width());
+    parallel_for(0, input.get_height(), band_rows(input.get_width()), [&](std::size_t begin, std::size_t end) {
+        Array<Complex> scratch(plan->get_scratch_size(), uninitialized);
+        for(std::size_t i = begin ; i < end ; ++i) { plan->forward(&input[i][0], &spectrum[i][0], scratch.get_data()); }
+    }, pool);
+
+    transform_columns(spectrum, FFTDirection::Forward, pool);
+}
+
+void inverse_real_fft(Array2DView<Complex> spectrum, Array2DView<float> output, ThreadPool& pool) {
+    if(spectrum.get_height() != output.get_height() || spectrum.get_width() != output.get_width() / 2 + 1) {
+        throw std::invalid_argument("Couldn't invert a spectrum of the wrong dimensions");
+    }
+    if(output.empty()) { return; }
+
+    transform_columns(spectrum, FFTDirection::Inverse, pool);
+
+    std::shared_ptr<const RealFFTPlan> plan = RealFFTPlan::get(output.get_width());
+    parallel_for(0, output.get_height(), band_rows(output.get_width()), [&](std::size_t begin, std::size_t end) {
+        Array<Complex> scratch(plan->get_scratch_size(), uninitialized);
+        for(std::size_t i = begin ; i < end ; ++i) { plan->inverse(&spectrum[i][0], &output[i][0], scratch.get_data()); }
+    }, pool);
+}
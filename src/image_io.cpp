@@ -0,0 +1,803 @@
+/***************************************************************************************************
+ * @file  image_io.cpp
+ * @brief Implementation of the functions reading and writing image files
+ **************************************************************************************************/
+
+#include "image_io.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "Array.hpp"
+#include "MappedFile.hpp"
+#include "pixel.hpp"
+#include "png.hpp"
+#include "qoi.hpp"
+#include "stb_image.h"
+#include "stb_image_write.h"
+#include "ThreadPool.hpp"
+
+namespace {
+    /// Maximum number of pixels of PPM and PFM data, to reject corrupted headers before computing
+    /// sizes that could overflow or allocating.
+    constexpr std::size_t max_pixels = 400'000'000;
+
+    /**
+     * @param width The number of columns given by a header.
+     * @param height The number of rows given by a header.
+     * @return Whether the dimensions are non-zero and the number of pixels is at most max_pixels.
+     */
+    bool valid_dimensions(std::size_t width, std::size_t height) {
+        return width != 0 && height != 0 && width <= max_pixels / height;
+    }
+
+    /**
+     * @struct Rows
+     * @brief The rows of an image in the order they must be encoded, which is reversed when the
+     * image is flipped.
+     * @tparam Channel The type of the channels.
+     */
+    template <typename Channel>
+    struct Rows {
+        /**
+         * @brief Constructs the rows of an image.
+         * @param pixels A pointer to the first pixel of the first row.
+         * @param height The number of rows.
+         * @param stride The distance in bytes between the starts of two consecutive rows.
+         * @param flip_vertically Whether to walk the rows from the last one.
+         */
+        Rows(const Channel* pixels, std::size_t height, std::size_t stride, bool flip_vertically)
+            : first(reinterpret_cast<const std::byte*>(pixels)), step(static_cast<std::ptrdiff_t>(stride)) {
+            if(flip_vertically && height > 0) {
+                first += (height - 1) * stride;
+                step = -step;
+            }
+        }
+
+        /**
+         * @param index The index of a row in encoding order.
+         * @return A pointer to the first channel of the row.
+         */
+        const Channel* operator[](std::size_t index) const {
+            return reinterpret_cast<const Channel*>(first + static_cast<std::ptrdiff_t>(index) * step);
+        }
+
+        const std::byte* first; ///< The first row to encode.
+        std::ptrdiff_t step;    ///< The distance in bytes from a row to the next one to encode.
+    };
+
+    /**
+     * @brief Reverses the order of the rows of tightly packed pixels.
+     * @param pixels A pointer to the first row.
+     * @param height The number of rows.
+     * @param row_size The size in bytes of a row.
+     */
+    void flip_rows(uint8_t* pixels, std::size_t height, std::size_t row_size) {
+        for(std::size_t i = 0 ; i < height / 2 ; ++i) {
+            std::swap_ranges(pixels + i * row_size, pixels + (i + 1) * row_size, pixels + (height - 1 - i) * row_size);
+        }
+    }
+
+    /**
+     * @brief Copies rows into a tightly packed buffer, in encoding order, keeping the first
+     * 'kept_channels' channels of every pixel.
+     * @param rows The rows to copy.
+     * @param width The number of columns.
+     * @param height The number of rows.
+     * @param channels The number of channels of the rows.
+     * @param kept_channels The number of channels to keep.
+     * @return The packed pixels.
+     */
+    template <typename Channel>
+    Array<Channel> pack_rows(const Rows<Channel>& rows, std::size_t width, std::size_t height,
+                             std::size_t channels, std::size_t kept_channels) {
+        Array<Channel> packed(width * height * kept_channels, uninitialized);
+
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            const Channel* source = rows[i];
+            Channel* destination = packed.get_data() + i * width * kept_channels;
+
+            if(kept_channels == channels) {
+                std::copy_n(source, width * channels, destination);
+            } else {
+                for(std::size_t j = 0 ; j < width ; ++j) {
+                    std::copy_n(source + j * channels, kept_channels, destination + j * kept_channels);
+                }
+            }
+        }
+
+        return packed;
+    }
+
+    /**
+     * @class ByteSink
+     * @brief The destination of encoded bytes: a buffer or an output stream.
+     */
+    class ByteSink {
+    public:
+        /**
+         * @brief Constructs a sink appending to a buffer.
+         * @param buffer The buffer.
+         */
+        explicit ByteSink(std::vector<std::byte>& buffer) : buffer(&buffer), stream(nullptr) { }
+
+        /**
+         * @brief Constructs a sink writing to a stream.
+         * @param stream The stream.
+         */
+        explicit ByteSink(std::ostream& stream) : buffer(nullptr), stream(&stream) { }
+
+        /**
+         * @brief Writes bytes.
+         * @param data A pointer to the bytes.
+         * @param size The number of bytes.
+         */
+        void write(const void* data, std::size_t size) {
+            if(buffer != nullptr) {
+                const std::byte* bytes = static_cast<const std::byte*>(data);
+                buffer->insert(buffer->end(), bytes, bytes + size);
+            } else {
+                stream->write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            }
+        }
+
+        /**
+         * @brief Writes a whole encoded image, which is moved instead of copied into an empty buffer.
+         * @param data The bytes.
+         */
+        void write(std::vector<std::byte>&& data) {
+            if(buffer != nullptr && buffer->empty()) { *buffer = std::move(data); }
+            else { write(data.data(), data.size()); }
+        }
+
+        /**
+         * @return Whether every write succeeded so far.
+         */
+        bool good() const {
+            return stream == nullptr || stream->good();
+        }
+
+    private:
+        std::vector<std::byte>* buffer; ///< The buffer, if the sink is one.
+        std::ostream* stream;           ///< The stream, if the sink is one.
+    };
+
+    /**
+     * @brief Callback of the stb_image_write functions, writing the encoded bytes to a sink.
+     * @param context A pointer to the ByteSink to write to.
+     * @param data The encoded bytes.
+     * @param size The number of bytes.
+     */
+    void write_to_sink(void* context, void* data, int size) {
+        static_cast<ByteSink*>(context)->write(data, size);
+    }
+
+    /**
+     * @brief Writes rows of an uncompressed format after a header, dropping the alpha channel. Rows
+     * without alpha are written straight from the pixel buffer.
+     * @param sink The destination of the bytes.
+     * @param header The header of the file.
+     * @param rows The rows, in the order they are stored in the file.
+     * @param width The number of columns.
+     * @param height The number of rows.
+     * @param channels The number of channels of the rows: 3 or 4.
+     */
+    template <typename Channel>
+    void write_uncompressed(ByteSink& sink, std::string_view header, const Rows<Channel>& rows,
+                            std::size_t width, std::size_t height, std::size_t channels) {
+        sink.write(header.data(), header.size());
+
+        std::vector<Channel> row_buffer(channels == 3 ? 0 : width * 3);
+        for(std::size_t i = 0 ; i < height && sink.good() ; ++i) {
+            const Channel* row = rows[i];
+            if(channels != 3) {
+                for(std::size_t j = 0 ; j < width ; ++j) { std::copy_n(row + j * channels, 3, row_buffer.data() + j * 3); }
+                row = row_buffer.data();
+            }
+            sink.write(row, width * 3 * sizeof(Channel));
+        }
+    }
+
+    /**
+     * @brief Skips whitespace and comments, then reads a token of a netpbm-like header.
+     * @param text The header, the token is removed from it.
+     * @return The token.
+     */
+    std::string_view next_token(std::string_view& text) {
+        std::size_t start = 0;
+        while(start < text.size() && (std::isspace(static_cast<unsigned char>(text[start])) || text[start] == '#')) {
+            // Comments run to the end of the line.
+            if(text[start] == '#') { while(start < text.size() && text[start] != '\n') { ++start; } }
+            else { ++start; }
+        }
+        std::size_t end = start;
+        while(end < text.size() && !std::isspace(static_cast<unsigned char>(text[end]))) { ++end; }
+
+        std::string_view token = text.substr(start, end - start);
+        text.remove_prefix(end);
+        return token;
+    }
+
+    /**
+     * @struct PfmHeader
+     * @brief The description of PFM data.
+     */
+    struct PfmHeader {
+        std::size_t width;     ///< The number of columns.
+        std::size_t height;    ///< The number of rows.
+        std::size_t channels;  ///< The number of channels: 3 ('PF') or 1 ('Pf').
+        float scale;           ///< The scale of the values, negative if they are little-endian.
+        const std::byte* rows; ///< The rows, stored from the bottom one.
+    };
+
+    /**
+     * @brief Reads the header of PFM data.
+     * @param data The encoded data.
+     * @return The description of the image.
+     * @note Throws a std::runtime_error if the header is invalid or the data too short.
+     */
+    PfmHeader read_pfm_header(std::span<const std::byte> data) {
+        std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+
+        std::string_view magic = next_token(text);
+        std::string_view width_token = next_token(text);
+        std::string_view height_token = next_token(text);
+        std::string_view scale_token = next_token(text);
+
+        PfmHeader header { 0, 0, magic == "PF" ? 3u : magic == "Pf" ? 1u : 0u, 0.0f, nullptr };
+        std::from_chars(width_token.data(), width_token.data() + width_token.size(), header.width);
+        std::from_chars(height_token.data(), height_token.data() + height_token.size(), header.height);
+        std::from_chars(scale_token.data(), scale_token.data() + scale_token.size(), header.scale);
+
+        // A single whitespace character separates the header from the data.
+        if(header.channels == 0 || !valid_dimensions(header.width, header.height) || header.scale == 0.0f || text.empty()
+           || text.size() - 1 < header.width * header.height * header.channels * sizeof(float)) {
+            throw std::runtime_error("Couldn't decode PFM data: invalid header");
+        }
+        header.rows = reinterpret_cast<const std::byte*>(text.data() + 1);
+
+        return header;
+    }
+
+    /**
+     * @brief Decodes a row of PFM data.
+     * @param header The description of the data.
+     * @param row The index of the row, from the top.
+     * @param destination Receives the width pixels of the row.
+     * @param channels The number of channels to decode to: 3 or 4.
+     */
+    void decode_pfm_row(const PfmHeader& header, std::size_t row, float* destination, std::size_t channels) {
+        const std::byte* source = header.rows + (header.height - 1 - row) * header.width * header.channels * sizeof(float);
+        bool swap = (header.scale < 0.0f) != (std::endian::native == std::endian::little);
+
+        for(std::size_t j = 0 ; j < header.width ; ++j) {
+            float values[3];
+            for(std::size_t c = 0 ; c < header.channels ; ++c) {
+                uint32_t bits;
+                std::memcpy(&bits, source + (j * header.channels + c) * sizeof(float), sizeof(bits));
+                values[c] = std::bit_cast<float>(swap ? std::byteswap(bits) : bits);
+            }
+            if(header.channels == 1) { values[1] = values[2] = values[0]; }
+
+            std::copy_n(values, 3, destination + j * channels);
+            if(channels == 4) { destination[j * channels + 3] = 1.0f; }
+        }
+    }
+
+    /**
+     * @brief Decodes PFM data, whose rows are stored from the bottom one.
+     * @param data The encoded data.
+     * @param channels The number of channels to decode to: 3 or 4.
+     * @return The decoded float pixels.
+     */
+    DecodedImage decode_pfm(std::span<const std::byte> data, std::size_t channels) {
+        PfmHeader header = read_pfm_header(data);
+
+        DecodedImage image { header.width, header.height, channels, sizeof(float), { nullptr, std::free } };
+        image.pixels.reset(static_cast<uint8_t*>(std::malloc(header.width * header.height * channels * sizeof(float))));
+        if(image.pixels == nullptr) { throw std::bad_alloc(); }
+        float* pixels = reinterpret_cast<float*>(image.pixels.get());
+
+        for(std::size_t i = 0 ; i < header.height ; ++i) {
+            decode_pfm_row(header, i, pixels + i * header.width * channels, channels);
+        }
+
+        return image;
+    }
+
+    /**
+     * @struct PpmHeader
+     * @brief The description of binary PPM data with 8-bit values.
+     */
+    struct PpmHeader {
+        std::size_t width;     ///< The number of columns.
+        std::size_t height;    ///< The number of rows.
+        const std::byte* rows; ///< The rows of RGB bytes, from the top one.
+    };
+
+    /**
+     * @brief Reads the header of binary PPM data.
+     * @param data The encoded data.
+     * @return The description of the image.
+     * @note Throws a std::runtime_error if the header is invalid, the values are not 8-bit or the data
+     * too short.
+     */
+    PpmHeader read_ppm_header(std::span<const std::byte> data) {
+        std::string_view text(reinterpret_cast<const char*>(data.data()), data.size());
+
+        std::string_view magic = next_token(text);
+        std::string_view width_token = next_token(text);
+        std::string_view height_token = next_token(text);
+        std::string_view max_token = next_token(text);
+
+        PpmHeader header { 0, 0, nullptr };
+        std::size_t max_value = 0;
+        std::from_chars(width_token.data(), width_token.data() + width_token.size(), header.width);
+        std::from_chars(height_token.data(), height_token.data() + height_token.size(), header.height);
+        std::from_chars(max_token.data(), max_token.data() + max_token.size(), max_value);
+
+        // A single whitespace character separates the header from the data.
+        if(magic != "P6" || !valid_dimensions(header.width, header.height) || max_value != 255 || text.empty()
+           || text.size() - 1 < header.width * header.height * 3) {
+            throw std::runtime_error("Couldn't decode PPM data: invalid or 16-bit header");
+        }
+        header.rows = reinterpret_cast<const std::byte*>(text.data() + 1);
+
+        return header;
+    }
+
+    /**
+     * @brief Converts decoded pixels to another channel type.
+     * @param image The decoded pixels.
+     * @param bytes_per_channel 1 for 8-bit channels, 2 for 16-bit channels, 4 for float channels.
+     */
+    void convert_decoded(DecodedImage& image, std::size_t bytes_per_channel) {
+        if(image.bytes_per_channel == bytes_per_channel) { return; }
+
+        std::size_t count = image.width * image.height * image.channels;
+        std::unique_ptr<uint8_t[], void (*)(void*)> converted(static_cast<uint8_t*>(std::malloc(count * bytes_per_channel)), std::free);
+        if(converted == nullptr) { throw std::bad_alloc(); }
+
+        const uint8_t* source = image.pixels.get();
+        if(image.bytes_per_channel == 1 && bytes_per_channel == 4) {
+            unorm8_to_float_n(source, reinterpret_cast<float*>(converted.get()), count);
+        } else if(image.bytes_per_channel == 4 && bytes_per_channel == 1) {
+            float_to_unorm8_n(reinterpret_cast<const float*>(source), converted.get(), count);
+        } else if(image.bytes_per_channel == 1 && bytes_per_channel == 2) {
+            uint16_t* destination = reinterpret_cast<uint16_t*>(converted.get());
+            for(std::size_t i = 0 ; i < count ; ++i) { destination[i] = convert_channel<uint16_t>(source[i]); }
+        } else if(image.bytes_per_channel == 4 && bytes_per_channel == 2) {
+            const float* floats = reinterpret_cast<const float*>(source);
+            uint16_t* destination = reinterpret_cast<uint16_t*>(converted.get());
+            for(std::size_t i = 0 ; i < count ; ++i) { destination[i] = convert_channel<uint16_t>(floats[i]); }
+        } else {
+            throw std::logic_error("Unsupported channel conversion");
+        }
+
+        image.pixels = std::move(converted);
+        image.bytes_per_channel = bytes_per_channel;
+    }
+
+    /**
+     * @brief Encodes 8-bit pixels. See encode_image.
+     * @param sink The destination of the encoded bytes.
+     */
+    void encode_pixels(ByteSink& sink, ImageFormat format, const uint8_t* pixels, std::size_t width,
+                       std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                       const ImageWriteOptions& options);
+
+    /**
+     * @brief Encodes float pixels. See encode_image.
+     * @param sink The destination of the encoded bytes.
+     */
+    void encode_pixels(ByteSink& sink, ImageFormat format, const float* pixels, std::size_t width,
+                       std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                       const ImageWriteOptions& options);
+
+    void encode_pixels(ByteSink& sink, ImageFormat format, const uint8_t* pixels, std::size_t width,
+                       std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                       const ImageWriteOptions& options) {
+        Rows<uint8_t> rows(pixels, height, stride, flip_vertically);
+
+        if(stores_floats(format)) {
+            auto convert = options.color_space == ColorSpace::SRGB ? srgb8_to_linear_n : unorm8_to_float_n;
+            Array<float> floats(width * height * channels, uninitialized);
+            for(std::size_t i = 0 ; i < height ; ++i) {
+                convert(rows[i], floats.get_data() + i * width * channels, width * channels);
+            }
+
+            encode_pixels(sink, format, floats.get_data(), width, height, channels, width * channels * sizeof(float),
+                          false, options);
+            return;
+        }
+
+        int result = 1;
+        int w = static_cast<int>(width);
+        int h = static_cast<int>(height);
+        int c = static_cast<int>(channels);
+
+        // The stb encoders need tightly packed rows.
+        Array<uint8_t> packed;
+        const uint8_t* packed_pixels = rows.first == reinterpret_cast<const std::byte*>(pixels)
+                                       && stride == width * channels ? pixels : nullptr;
+        auto pack = [&] {
+            if(packed_pixels == nullptr) {
+                packed = pack_rows(rows, width, height, channels, channels);
+                packed_pixels = packed.get_data();
+            }
+            return packed_pixels;
+        };
+
+        switch(format) {
+            case ImageFormat::PNG:
+                sink.write(png_encode(rows[0], rows.step, width, height, channels, options.compression_level,
+                                      options.thread_pool != nullptr ? *options.thread_pool : ThreadPool::get_global()));
+                break;
+            case ImageFormat::QOI: {
+                QoiHeader header {
+                    static_cast<uint32_t>(width), static_cast<uint32_t>(height), static_cast<uint8_t>(channels),
+                    static_cast<uint8_t>(options.color_space == ColorSpace::SRGB ? 0 : 1)
+                };
+                sink.write(qoi_encode(rows[0], rows.step, header));
+                break;
+            }
+            case ImageFormat::BMP:
+                result = stbi_write_bmp_to_func(write_to_sink, &sink, w, h, c, pack());
+                break;
+            case ImageFormat::TGA:
+                result = stbi_write_tga_to_func(write_to_sink, &sink, w, h, c, pack());
+                break;
+            case ImageFormat::JPG:
+                result = stbi_write_jpg_to_func(write_to_sink, &sink, w, h, c, pack(), std::clamp(options.jpg_quality, 1, 100));
+                break;
+            case ImageFormat::PPM: {
+                std::string header = "P6\n" + std::to_string(width) + ' ' + std::to_string(height) + "\n255\n";
+                write_uncompressed(sink, header, rows, width, height, channels);
+                break;
+            }
+            default:
+                throw std::logic_error("Unhandled image format");
+        }
+
+        if(result == 0) { throw std::runtime_error("Couldn't encode image"); }
+    }
+
+    void encode_pixels(ByteSink& sink, ImageFormat format, const float* pixels, std::size_t width,
+                       std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                       const ImageWriteOptions& options) {
+        Rows<float> rows(pixels, height, stride, flip_vertically);
+
+        if(!stores_floats(format)) {
+            auto convert = options.color_space == ColorSpace::SRGB ? linear_to_srgb8_n : float_to_unorm8_n;
+            Array<uint8_t> bytes(width * height * channels, uninitialized);
+            for(std::size_t i = 0 ; i < height ; ++i) {
+                convert(rows[i], bytes.get_data() + i * width * channels, width * channels);
+            }
+
+            encode_pixels(sink, format, bytes.get_data(), width, height, channels, width * channels, false, options);
+            return;
+        }
+
+        if(format == ImageFormat::HDR) {
+            Array<float> packed = pack_rows(rows, width, height, channels, channels);
+            int result = stbi_write_hdr_to_func(write_to_sink, &sink, static_cast<int>(width), static_cast<int>(height),
+                                                static_cast<int>(channels), packed.get_data());
+            if(result == 0) { throw std::runtime_error("Couldn't encode image"); }
+        } else {
+            // PFM rows are stored from the bottom one, and a negative scale means little-endian floats.
+            Rows<float> bottom_up(pixels, height, stride, !flip_vertically);
+            const char* scale = std::endian::native == std::endian::little ? "-1.0" : "1.0";
+            std::string header = "PF\n" + std::to_string(width) + ' ' + std::to_string(height) + '\n' + scale + '\n';
+            write_uncompressed(sink, header, bottom_up, width, height, channels);
+        }
+    }
+}
+
+std::optional<ImageFormat> image_format_from_extension(const std::filesystem::path& path) {
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char character) { return std::tolower(character); });
+
+    if(extension == ".png") { return ImageFormat::PNG; }
+    if(extension == ".qoi") { return ImageFormat::QOI; }
+    if(extension == ".bmp") { return ImageFormat::BMP; }
+    if(extension == ".tga") { return ImageFormat::TGA; }
+    if(extension == ".jpg" || extension == ".jpeg") { return ImageFormat::JPG; }
+    if(extension == ".hdr") { return ImageFormat::HDR; }
+    if(extension == ".ppm") { return ImageFormat::PPM; }
+    if(extension == ".pfm") { return ImageFormat::PFM; }
+
+    return std::nullopt;
+}
+
+bool stores_floats(ImageFormat format) {
+    return format == ImageFormat::HDR || format == ImageFormat::PFM;
+}
+
+std::optional<ImageFormat> image_format_from_data(std::span<const std::byte> data) {
+    auto starts_with = [&](std::string_view prefix) {
+        return data.size() >= prefix.size() && std::memcmp(data.data(), prefix.data(), prefix.size()) == 0;
+    };
+    auto is_space = [&](std::size_t index) {
+        return data.size() > index && std::isspace(static_cast<unsigned char>(data[index]));
+    };
+
+    if(starts_with("\x89PNG\r\n\x1A\n")) { return ImageFormat::PNG; }
+    if(starts_with("qoif")) { return ImageFormat::QOI; }
+    if(starts_with("BM")) { return ImageFormat::BMP; }
+    if(starts_with("\xFF\xD8\xFF")) { return ImageFormat::JPG; }
+    if(starts_with("#?RADIANCE") || starts_with("#?RGBE")) { return ImageFormat::HDR; }
+    if(starts_with("P6") && is_space(2)) { return ImageFormat::PPM; }
+    if((starts_with("PF") || starts_with("Pf")) && is_space(2)) { return ImageFormat::PFM; }
+
+    // TGA files have no signature.
+    return std::nullopt;
+}
+
+ImageInfo probe_image(std::span<const std::byte> data) {
+    ImageInfo info;
+    info.format = image_format_from_data(data);
+
+    if(info.format == ImageFormat::QOI) {
+        QoiHeader header = qoi_read_header(data);
+        info.width = header.width;
+        info.height = header.height;
+        info.channels = header.channels;
+    } else if(info.format == ImageFormat::PFM) {
+        PfmHeader header = read_pfm_header(data);
+        info.width = header.width;
+        info.height = header.height;
+        info.channels = header.channels;
+    } else {
+        if(data.size() > INT_MAX) { throw std::runtime_error("Couldn't probe image: too much data"); }
+
+        int w, h, c;
+        if(stbi_info_from_memory(reinterpret_cast<const stbi_uc*>(data.data()), static_cast<int>(data.size()), &w, &h, &c) == 0) {
+            throw std::runtime_error(std::string("Couldn't probe image: ") + stbi_failure_reason());
+        }
+        info.width = w;
+        info.height = h;
+        info.channels = c;
+    }
+
+    return info;
+}
+
+ImageInfo probe_image_file(const std::filesystem::path& path) {
+    // Mapping the file only reads the pages of the header.
+    MappedFile file(path, MapMode::ReadOnly);
+    ImageInfo info;
+
+    try {
+        info = probe_image(std::span(file.get_data(), file.get_size()));
+    } catch(const std::runtime_error& error) {
+        throw std::runtime_error("Couldn't probe image '" + path.string() + "': " + error.what());
+    }
+
+    if(!info.format && image_format_from_extension(path) == ImageFormat::TGA) { info.format = ImageFormat::TGA; }
+
+    return info;
+}
+
+DecodedImage decode_image(std::span<const std::byte> data, std::size_t channels, std::size_t bytes_per_channel,
+                          bool flip_vertically) {
+    DecodedImage image;
+    std::optional<ImageFormat> format = image_format_from_data(data);
+
+    if(format == ImageFormat::QOI) {
+        QoiHeader header = qoi_read_header(data);
+        image.width = header.width;
+        image.height = header.height;
+        image.channels = channels;
+        image.pixels.reset(static_cast<uint8_t*>(std::malloc(image.width * image.height * channels)));
+        if(image.pixels == nullptr) { throw std::bad_alloc(); }
+        qoi_decode(data, image.pixels.get(), channels);
+    } else if(format == ImageFormat::PFM) {
+        image = decode_pfm(data, channels);
+    } else {
+        if(data.size() > INT_MAX) { throw std::runtime_error("Couldn't decode image: too much data"); }
+
+        int w, h, c;
+        const stbi_uc* bytes = reinterpret_cast<const stbi_uc*>(data.data());
+        int size = static_cast<int>(data.size());
+        int desired = static_cast<int>(channels);
+        void* pixels = bytes_per_channel == 4 ? static_cast<void*>(stbi_loadf_from_memory(bytes, size, &w, &h, &c, desired))
+                     : bytes_per_channel == 2 ? static_cast<void*>(stbi_load_16_from_memory(bytes, size, &w, &h, &c, desired))
+                     : static_cast<void*>(stbi_load_from_memory(bytes, size, &w, &h, &c, desired));
+        if(pixels == nullptr) { throw std::runtime_error(std::string("Couldn't decode image: ") + stbi_failure_reason()); }
+
+        image.width = w;
+        image.height = h;
+        image.channels = channels;
+        image.bytes_per_channel = bytes_per_channel;
+        image.pixels = std::unique_ptr<uint8_t[], void (*)(void*)>(static_cast<uint8_t*>(pixels), stbi_image_free);
+    }
+
+    convert_decoded(image, bytes_per_channel);
+
+    // stb_image's flip setting is global, so rows are flipped here instead to keep threads independent.
+    if(flip_vertically) {
+        flip_rows(image.pixels.get(), image.height, image.width * channels * image.bytes_per_channel);
+    }
+
+    return image;
+}
+
+DecodedImage read_image_file(const std::filesystem::path& path, std::size_t channels,
+                             std::size_t bytes_per_channel, bool flip_vertically) {
+    MappedFile file(path, MapMode::ReadOnly);
+
+    try {
+        return decode_image(std::span(file.get_data(), file.get_size()), channels, bytes_per_channel, flip_vertically);
+    } catch(const std::runtime_error& error) {
+        throw std::runtime_error("Couldn't load image '" + path.string() + "': " + error.what());
+    }
+}
+
+std::vector<std::byte> encode_image(ImageFormat format, const uint8_t* pixels, std::size_t width,
+                                    std::size_t height, std::size_t channels, std::size_t stride,
+                                    bool flip_vertically, const ImageWriteOptions& options) {
+    std::vector<std::byte> encoded;
+    ByteSink sink(encoded);
+    encode_pixels(sink, format, pixels, width, height, channels, stride, flip_vertically, options);
+
+    return encoded;
+}
+
+std::vector<std::byte> encode_image(ImageFormat format, const float* pixels, std::size_t width,
+                                    std::size_t height, std::size_t channels, std::size_t stride,
+                                    bool flip_vertically, const ImageWriteOptions& options) {
+    std::vector<std::byte> encoded;
+    ByteSink sink(encoded);
+    encode_pixels(sink, format, pixels, width, height, channels, stride, flip_vertically, options);
+
+    return encoded;
+}
+
+void encode_image(std::ostream& output, ImageFormat format, const uint8_t* pixels, std::size_t width,
+                  std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                  const ImageWriteOptions& options) {
+    ByteSink sink(output);
+    encode_pixels(sink, format, pixels, width, height, channels, stride, flip_vertically, options);
+    if(!output) { throw std::runtime_error("Couldn't write encoded image to stream"); }
+}
+
+void encode_image(std::ostream& output, ImageFormat format, const float* pixels, std::size_t width,
+                  std::size_t height, std::size_t channels, std::size_t stride, bool flip_vertically,
+                  const ImageWriteOptions& options) {
+    ByteSink sink(output);
+    encode_pixels(sink, format, pixels, width, height, channels, stride, flip_vertically, options);
+    if(!output) { throw std::runtime_error("Couldn't write encoded image to stream"); }
+}
+
+void write_image_file(const std::filesystem::path& path, ImageFormat format, const uint8_t* pixels,
+                      std::size_t width, std::size_t height, std::size_t channels, std::size_t stride,
+                      bool flip_vertically, const ImageWriteOptions& options) {
+    std::ofstream file(path, std::ios::binary);
+    ByteSink sink(file);
+    if(file) { encode_pixels(sink, format, pixels, width, height, channels, stride, flip_vertically, options); }
+    if(!file) { throw std::runtime_error("Couldn't write image '" + path.string() + '\''); }
+}
+
+void write_image_file(const std::filesystem::path& path, ImageFormat format, const float* pixels,
+                      std::size_t width, std::size_t height, std::size_t channels, std::size_t stride,
+                      bool flip_vertically, const ImageWriteOptions& options) {
+    std::ofstream file(path, std::ios::binary);
+    ByteSink sink(file);
+    if(file) { encode_pixels(sink, format, pixels, width, height, channels, stride, flip_vertically, options); }
+    if(!file) { throw std::runtime_error("Couldn't write image '" + path.string() + '\''); }
+}
+
+bool supports_bands(ImageFormat format) {
+    return format == ImageFormat::PPM || format == ImageFormat::PFM;
+}
+
+void read_image_bands(const std::filesystem::path& path, std::size_t band_height, ColorSpace color_space,
+                      const std::function<void(std::size_t, std::size_t, const float*)>& function) {
+    MappedFile file(path, MapMode::ReadOnly);
+    std::span<const std::byte> data(file.get_data(), file.get_size());
+    file.advise(MapAdvice::Sequential);
+    band_height = std::max<std::size_t>(band_height, 1);
+
+    std::optional<ImageFormat> format = image_format_from_data(data);
+    if(format != ImageFormat::PPM && format != ImageFormat::PFM) {
+        throw std::runtime_error("Couldn't read image '" + path.string() + "' by bands: not a PPM or PFM file");
+    }
+
+    try {
+        if(format == ImageFormat::PPM) {
+            PpmHeader header = read_ppm_header(data);
+            std::size_t row_size = header.width * 3;
+            auto convert = color_space == ColorSpace::SRGB ? srgb8_to_linear_n : unorm8_to_float_n;
+            Array<float> band(std::min(band_height, header.height) * row_size, uninitialized);
+
+            for(std::size_t first = 0 ; first < header.height ; first += band_height) {
+                std::size_t rows = std::min(band_height, header.height - first);
+                const std::byte* source = header.rows + first * row_size;
+                convert(reinterpret_cast<const uint8_t*>(source), band.get_data(), rows * row_size);
+                function(first, rows, band.get_data());
+
+                // Dropping the pages that were read keeps the footprint of the mapping to a band.
+                file.advise(MapAdvice::DontNeed, static_cast<std::size_t>(source - data.data()), rows * row_size);
+            }
+        } else {
+            PfmHeader header = read_pfm_header(data);
+            std::size_t row_size = header.width * header.channels * sizeof(float);
+            Array<float> band(std::min(band_height, header.height) * header.width * 3, uninitialized);
+
+            for(std::size_t first = 0 ; first < header.height ; first += band_height) {
+                std::size_t rows = std::min(band_height, header.height - first);
+                for(std::size_t i = 0 ; i < rows ; ++i) {
+                    decode_pfm_row(header, first + i, band.get_data() + i * header.width * 3, 3);
+                }
+                function(first, rows, band.get_data());
+
+                // The rows are stored from the bottom one, so the band's rows end where the last one is.
+                std::size_t offset = (header.height - first - rows) * row_size;
+                file.advise(MapAdvice::DontNeed, static_cast<std::size_t>(header.rows - data.data()) + offset, rows * row_size);
+            }
+        }
+    } catch(const std::runtime_error& error) {
+        throw std::runtime_error("Couldn't read image '" + path.string() + "': " + error.what());
+    }
+}
+
+void write_image_bands(const std::filesystem::path& path, ImageFormat format, std::size_t width, std::size_t height,
+                       std::size_t band_height, ColorSpace color_space,
+                       const std::function<void(std::size_t, std::size_t, float*)>& function) {
+    if(!supports_bands(format)) {
+        throw std::runtime_error("Couldn't write image '" + path.string() + "' by bands: not a PPM or PFM file");
+    }
+    band_height = std::max<std::size_t>(band_height, 1);
+
+    std::string header;
+    std::size_t row_size;
+    if(format == ImageFormat::PPM) {
+        header = "P6\n" + std::to_string(width) + ' ' + std::to_string(height) + "\n255\n";
+        row_size = width * 3;
+    } else {
+        // PFM rows are stored from the bottom one, and a negative scale means little-endian floats.
+        const char* scale = std::endian::native == std::endian::little ? "-1.0" : "1.0";
+        header = "PF\n" + std::to_string(width) + ' ' + std::to_string(height) + '\n' + scale + '\n';
+        row_size = width * 3 * sizeof(float);
+    }
+
+    // The file is mapped rather than streamed, so that PFM bands can be stored bottom-up.
+    MappedFile file(path, header.size() + height * row_size);
+    std::memcpy(file.get_data(), header.data(), header.size());
+    std::byte* rows = file.get_data() + header.size();
+    auto convert = color_space == ColorSpace::SRGB ? linear_to_srgb8_n : float_to_unorm8_n;
+    Array<float> band(std::min(band_height, height) * width * 3, uninitialized);
+
+    for(std::size_t first = 0 ; first < height ; first += band_height) {
+        std::size_t count = std::min(band_height, height - first);
+        function(first, count, band.get_data());
+
+        std::size_t offset;
+        if(format == ImageFormat::PPM) {
+            offset = first * row_size;
+            convert(band.get_data(), reinterpret_cast<uint8_t*>(rows + offset), count * width * 3);
+        } else {
+            offset = (height - first - count) * row_size;
+            for(std::size_t i = 0 ; i < count ; ++i) {
+                std::memcpy(rows + (height - 1 - first - i) * row_size, band.get_data() + i * width * 3, row_size);
+            }
+        }
+
+        // Written pages are left to the kernel to write back, so that the mapping doesn't keep them.
+        file.advise(MapAdvice::DontNeed, header.size() + offset, count * row_size);
+    }
+
+    file.flush();
+}
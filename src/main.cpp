@@ -3,6 +3,7 @@
  * @brief Contains the main program of the project
  **************************************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 #include <unistd.h>
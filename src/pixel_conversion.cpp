@@ -0,0 +1,179 @@
+/***************************************************************************************************
+ * @file  pixel_conversion.cpp
+ * @brief Implementation of the vectorized pixel conversions
+ **************************************************************************************************/
+
+#include "pixel_conversion.hpp"
+
+#include <bit>
+#include <cmath>
+#include "simd.hpp"
+
+/*
+ * Floating-point contraction would let the compiler fuse multiplications and additions into FMA
+ * instructions on some paths only, so that rounding would differ between paths.
+ */
+#pragma GCC optimize("fp-contract=off")
+
+namespace {
+    namespace scalar {
+        /**
+         * @brief Scalar version of the vectorized unorm8_to_float kernel.
+         */
+        void unorm8_to_float(const uint8_t* source, float* destination, std::size_t count) {
+            for(std::size_t i = 0 ; i < count ; ++i) { destination[i] = source[i] * (1.0f / 255.0f); }
+        }
+
+        /**
+         * @brief Scalar version of the vectorized float_to_unorm8 kernel, performing the exact same
+         * operations.
+         */
+        void float_to_unorm8(const float* source, uint8_t* destination, std::size_t count) {
+            for(std::size_t i = 0 ; i < count ; ++i) {
+                float value = source[i] * 255.0f + 0.5f;
+                value = value > 0.0f ? value : 0.0f;
+                value = value < 255.0f ? value : 255.0f;
+                destination[i] = static_cast<uint8_t>(static_cast<int>(value));
+            }
+        }
+    }
+
+#if defined(__x86_64__)
+    namespace sse2 {
+#define VECTOR_BYTES 16
+#include "pixel_conversion_kernels.inl"
+#undef VECTOR_BYTES
+    }
+
+#pragma GCC push_options
+#pragma GCC target("avx2")
+    namespace avx2 {
+#define VECTOR_BYTES 32
+#include "pixel_conversion_kernels.inl"
+#undef VECTOR_BYTES
+    }
+#pragma GCC pop_options
+
+#pragma GCC push_options
+#pragma GCC target("avx512f")
+    namespace avx512 {
+#define VECTOR_BYTES 64
+#include "pixel_conversion_kernels.inl"
+#undef VECTOR_BYTES
+    }
+#pragma GCC pop_options
+#endif
+
+    /// Smallest value encoded by the sRGB table, below it every value encodes to 0.
+    constexpr float srgb_min = 0x1p-13f;
+
+    /// Largest value encoded by the sRGB table, the float just below 1.
+    constexpr float srgb_max = 0x1.fffffep-1f;
+
+    /// Number of linear segments of the sRGB table: 8 per octave between srgb_min and 1.
+    constexpr std::size_t srgb_segments = 13 * 8;
+
+    /**
+     * @brief Decodes a value of the sRGB transfer curve.
+     * @param value A value in [0 ; 1].
+     * @return The linear value.
+     */
+    double srgb_to_linear(double value) {
+        return value <= 0.04045 ? value / 12.92 : std::pow((value + 0.055) / 1.055, 2.4);
+    }
+
+    /**
+     * @brief Encodes a value with the sRGB transfer curve.
+     * @param value A linear value in [0 ; 1].
+     * @return The encoded value.
+     */
+    double linear_to_srgb(double value) {
+        return value <= 0.0031308 ? value * 12.92 : 1.055 * std::pow(value, 1.0 / 2.4) - 0.055;
+    }
+
+    /**
+     * @struct SrgbTables
+     * @brief The lookup tables of the sRGB conversions, computed once.
+     */
+    struct SrgbTables {
+        float decode[256];             ///< The linear value of every 8-bit sRGB value.
+        float bias[srgb_segments];     ///< The encoded value at the start of each segment, plus 0.5.
+        float slope[srgb_segments];    ///< The increase of the encoded value per step of a segment.
+
+        /**
+         * @brief Computes the tables.
+         */
+        SrgbTables() {
+            for(std::size_t i = 0 ; i < 256 ; ++i) { decode[i] = static_cast<float>(srgb_to_linear(i / 255.0)); }
+
+            // A segment spans the floats sharing their exponent and 3 first mantissa bits, and its
+            // 256 steps are the 8 next mantissa bits. Its line is the chord of the curve shifted up
+            // by half the sag at its middle, which halves the worst error of the chord.
+            for(std::size_t i = 0 ; i < srgb_segments ; ++i) {
+                uint32_t first = std::bit_cast<uint32_t>(srgb_min) + (static_cast<uint32_t>(i) << 20);
+                double start = std::bit_cast<float>(first);
+                double end = std::bit_cast<float>(first + (1u << 20));
+
+                double start_value = 255.0 * linear_to_srgb(start);
+                double end_value = 255.0 * linear_to_srgb(end);
+                double step = (end_value - start_value) / 256.0;
+                double sag = 255.0 * linear_to_srgb((start + end) / 2.0) - (start_value + end_value) / 2.0;
+
+                bias[i] = static_cast<float>(start_value + step / 2.0 + sag / 2.0 + 0.5);
+                slope[i] = static_cast<float>(step);
+            }
+        }
+    };
+
+    /**
+     * @return The lookup tables of the sRGB conversions.
+     */
+    const SrgbTables& get_srgb_tables() {
+        static const SrgbTables tables;
+        return tables;
+    }
+
+/// Expands to a switch calling the kernel 'name' of the current instruction set.
+#if defined(__x86_64__)
+#define DISPATCH(name, ...)                                                                         \
+    switch(get_simd_level()) {                                                                      \
+        case SimdLevel::AVX512: avx512::name(__VA_ARGS__); return;                                  \
+        case SimdLevel::AVX2: avx2::name(__VA_ARGS__); return;                                      \
+        case SimdLevel::SSE2: sse2::name(__VA_ARGS__); return;                                      \
+        default: scalar::name(__VA_ARGS__); return;                                                 \
+    }
+#else
+#define DISPATCH(name, ...) scalar::name(__VA_ARGS__);
+#endif
+}
+
+void unorm8_to_float_n(const uint8_t* source, float* destination, std::size_t count) {
+    DISPATCH(unorm8_to_float, source, destination, count)
+}
+
+void float_to_unorm8_n(const float* source, uint8_t* destination, std::size_t count) {
+    DISPATCH(float_to_unorm8, source, destination, count)
+}
+
+#undef DISPATCH
+
+void srgb8_to_linear_n(const uint8_t* source, float* destination, std::size_t count) {
+    const float* table = get_srgb_tables().decode;
+    for(std::size_t i = 0 ; i < count ; ++i) { destination[i] = table[source[i]]; }
+}
+
+void linear_to_srgb8_n(const float* source, uint8_t* destination, std::size_t count) {
+    const SrgbTables& tables = get_srgb_tables();
+    constexpr uint32_t min_bits = std::bit_cast<uint32_t>(srgb_min);
+
+    for(std::size_t i = 0 ; i < count ; ++i) {
+        float value = source[i] > srgb_min ? source[i] : srgb_min; // NaNs fail the comparison.
+        value = value < srgb_max ? value : srgb_max;
+
+        uint32_t bits = std::bit_cast<uint32_t>(value);
+        uint32_t segment = (bits - min_bits) >> 20;
+        uint32_t step = (bits >> 12) & 0xFF;
+
+        destination[i] = static_cast<uint8_t>(tables.bias[segment] + tables.slope[segment] * static_cast<float>(step));
+    }
+}
@@ -0,0 +1,64 @@
+/***************************************************************************************************
+ * @file  pixel_conversion_kernels.inl
+ * @brief Vectorized kernels of the pixel conversions, written once for every vector width
+ *
+ * This file is included several times by pixel_conversion.cpp, each time inside its own namespace
+ * and with VECTOR_BYTES set to the width of the target instruction set's registers.
+ **************************************************************************************************/
+
+typedef float FloatVec __attribute__((vector_size(VECTOR_BYTES)));
+typedef int IntVec __attribute__((vector_size(VECTOR_BYTES)));
+
+/// Vector of bytes with as many lanes as a vector of floats.
+typedef uint8_t ByteVec __attribute__((vector_size(VECTOR_BYTES / 4)));
+
+/// Number of lanes of a vector of floats.
+constexpr std::size_t lanes = VECTOR_BYTES / sizeof(float);
+
+/// Number of vectors converted per iteration, to hide the latency of the conversions.
+constexpr std::size_t unroll = 4;
+
+/**
+ * @brief Vectorized unorm8_to_float_n.
+ */
+void unorm8_to_float(const uint8_t* source, float* destination, std::size_t count) {
+    const FloatVec scale = FloatVec {} + 1.0f / 255.0f;
+
+    std::size_t i = 0;
+    for(; i + unroll * lanes <= count ; i += unroll * lanes) {
+        for(std::size_t k = 0 ; k < unroll ; ++k) {
+            ByteVec bytes;
+            __builtin_memcpy(&bytes, source + i + k * lanes, sizeof(bytes));
+            FloatVec values = __builtin_convertvector(bytes, FloatVec) * scale;
+            __builtin_memcpy(destination + i + k * lanes, &values, sizeof(values));
+        }
+    }
+
+    scalar::unorm8_to_float(source + i, destination + i, count - i);
+}
+
+/**
+ * @brief Vectorized float_to_unorm8_n.
+ */
+void float_to_unorm8(const float* source, uint8_t* destination, std::size_t count) {
+    const FloatVec scale = FloatVec {} + 255.0f;
+    const FloatVec half = FloatVec {} + 0.5f;
+    const FloatVec zero = FloatVec {};
+
+    std::size_t i = 0;
+    for(; i + unroll * lanes <= count ; i += unroll * lanes) {
+        for(std::size_t k = 0 ; k < unroll ; ++k) {
+            FloatVec values;
+            __builtin_memcpy(&values, source + i + k * lanes, sizeof(values));
+
+            values = values * scale + half;
+            values = values > zero ? values : zero; // NaNs fail the comparison and give 0.
+            values = values < scale ? values : scale;
+
+            ByteVec bytes = __builtin_convertvector(__builtin_convertvector(values, IntVec), ByteVec);
+            __builtin_memcpy(destination + i + k * lanes, &bytes, sizeof(bytes));
+        }
+    }
+
+    scalar::float_to_unorm8(source + i, destination + i, count - i);
+}
@@ -0,0 +1,199 @@
+/***************************************************************************************************
+ * @file  png.cpp
+ * @brief Implementation of the multithreaded PNG encoder
+ **************************************************************************************************/
+
+#include "png.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+#include "deflate.hpp"
+#include "ThreadPool.hpp"
+
+namespace {
+    /// The first 8 bytes of every PNG file.
+    constexpr uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+    /// The number of filtered bytes compressed by a task. Each band restarts the search for matches,
+    /// so bands must be much larger than the 32KiB window to keep the loss of compression small.
+    constexpr std::size_t band_bytes = 256 * 1024;
+
+    /// The PNG color types of 1 to 4 channels.
+    constexpr uint8_t color_types[5] = { 0, 0, 4, 2, 6 };
+
+    /**
+     * @brief Appends a 32-bit big-endian integer to a buffer.
+     * @param output The buffer.
+     * @param value The integer.
+     */
+    void append_u32(std::vector<std::byte>& output, uint32_t value) {
+        for(int shift = 24 ; shift >= 0 ; shift -= 8) { output.push_back(static_cast<std::byte>(value >> shift)); }
+    }
+
+    /**
+     * @brief Appends a chunk to a buffer.
+     * @param output The buffer.
+     * @param type The 4 characters of the type of the chunk.
+     * @param data The data of the chunk.
+     */
+    void append_chunk(std::vector<std::byte>& output, const char* type, const std::vector<std::byte>& data) {
+        const uint8_t* type_bytes = reinterpret_cast<const uint8_t*>(type);
+        uint32_t crc = crc32(type_bytes, 4);
+        crc = crc32(reinterpret_cast<const uint8_t*>(data.data()), data.size(), crc);
+
+        append_u32(output, static_cast<uint32_t>(data.size()));
+        for(int i = 0 ; i < 4 ; ++i) { output.push_back(static_cast<std::byte>(type_bytes[i])); }
+        output.insert(output.end(), data.begin(), data.end());
+        append_u32(output, crc);
+    }
+
+    /**
+     * @param a The byte to the left.
+     * @param b The byte above.
+     * @param c The byte above to the left.
+     * @return The one of the 3 bytes closest to a + b - c.
+     */
+    uint8_t paeth(uint8_t a, uint8_t b, uint8_t c) {
+        int p = a + b - c;
+        int pa = std::abs(p - a);
+        int pb = std::abs(p - b);
+        int pc = std::abs(p - c);
+
+        return pa <= pb && pa <= pc ? a : pb <= pc ? b : c;
+    }
+
+    /**
+     * @brief Filters a row with one of the 5 PNG filters.
+     * @param type The filter: 0 (none), 1 (sub), 2 (up), 3 (average) or 4 (Paeth).
+     * @param row The row.
+     * @param above The row above, all zeros for the first row.
+     * @param size The number of bytes of a row.
+     * @param bpp The number of bytes of a pixel.
+     * @param output Receives the filtered row.
+     */
+    void filter_row(int type, const uint8_t* row, const uint8_t* above, std::size_t size, std::size_t bpp,
+                    uint8_t* output) {
+        for(std::size_t i = 0 ; i < size ; ++i) {
+            uint8_t a = i >= bpp ? row[i - bpp] : 0;
+            uint8_t b = above[i];
+            uint8_t c = i >= bpp ? above[i - bpp] : 0;
+
+            switch(type) {
+                case 0: output[i] = row[i]; break;
+                case 1: output[i] = row[i] - a; break;
+                case 2: output[i] = row[i] - b; break;
+                case 3: output[i] = row[i] - static_cast<uint8_t>((a + b) / 2); break;
+                default: output[i] = row[i] - paeth(a, b, c); break;
+            }
+        }
+    }
+
+    /**
+     * @param row A filtered row.
+     * @param size The number of bytes of the row.
+     * @return The sum of the absolute values of the bytes as signed values, the usual estimate of
+     * how well a filtered row compresses.
+     */
+    std::size_t filter_cost(const uint8_t* row, std::size_t size) {
+        std::size_t cost = 0;
+        for(std::size_t i = 0 ; i < size ; ++i) { cost += std::abs(static_cast<int8_t>(row[i])); }
+
+        return cost;
+    }
+}
+
+std::vector<std::byte> png_encode(const uint8_t* pixels, std::ptrdiff_t stride, std::size_t width,
+                                  std::size_t height, std::size_t channels, int level, ThreadPool& pool) {
+    if(width == 0 || height == 0 || width > 0x7FFFFFFF || height > 0x7FFFFFFF) {
+        throw std::runtime_error("Couldn't encode PNG data: invalid dimensions");
+    }
+    if(channels < 1 || channels > 4) { throw std::runtime_error("Couldn't encode PNG data: unsupported channel count"); }
+
+    level = std::clamp(level, 0, max_compression_level);
+    std::size_t row_size = width * channels;
+    std::size_t band_height = std::max<std::size_t>(1, band_bytes / (row_size + 1));
+    std::size_t band_count = (height + band_height - 1) / band_height;
+
+    struct Band {
+        std::vector<std::byte> compressed;
+        uint32_t adler;
+        std::size_t size;
+    };
+    std::vector<Band> bands(band_count);
+
+    pool.parallel_for(0, band_count, 1, [&](std::size_t begin, std::size_t end) {
+        std::vector<uint8_t> filtered;
+        std::vector<uint8_t> candidate(row_size);
+        std::vector<uint8_t> zeros(row_size, 0);
+
+        for(std::size_t band = begin ; band < end ; ++band) {
+            std::size_t first_row = band * band_height;
+            std::size_t last_row = std::min(height, first_row + band_height);
+            filtered.resize((last_row - first_row) * (row_size + 1));
+
+            uint8_t* output = filtered.data();
+            for(std::size_t i = first_row ; i < last_row ; ++i) {
+                const uint8_t* row = pixels + static_cast<std::ptrdiff_t>(i) * stride;
+                const uint8_t* above = i > 0 ? row - stride : zeros.data();
+
+                int best_type = 0;
+                if(level == 0) {
+                    filter_row(0, row, above, row_size, channels, output + 1);
+                } else {
+                    std::size_t best_cost = SIZE_MAX;
+                    for(int type = 0 ; type < 5 ; ++type) {
+                        filter_row(type, row, above, row_size, channels, candidate.data());
+                        std::size_t cost = filter_cost(candidate.data(), row_size);
+                        if(cost < best_cost) {
+                            best_cost = cost;
+                            best_type = type;
+                            std::copy(candidate.begin(), candidate.end(), output + 1);
+                        }
+                    }
+                }
+                output[0] = static_cast<uint8_t>(best_type);
+                output += row_size + 1;
+            }
+
+            Band& result = bands[band];
+            if(band == 0) {
+                // The zlib header: deflate with a 32KiB window, and a hint of the compression level.
+                uint8_t flags = level < 2 ? 0x01 : level < 6 ? 0x5E : level == 6 ? 0x9C : 0xDA;
+                result.compressed = { std::byte { 0x78 }, static_cast<std::byte>(flags) };
+            }
+            deflate(filtered.data(), filtered.size(), level,
+                    band + 1 == band_count ? DeflateFlush::Finish : DeflateFlush::Sync, result.compressed);
+            result.adler = adler32(filtered.data(), filtered.size());
+            result.size = filtered.size();
+        }
+    });
+
+    std::size_t total = sizeof(signature) + 25 + 16 + 12;
+    for(const Band& band : bands) { total += band.compressed.size() + 12; }
+
+    std::vector<std::byte> encoded;
+    encoded.reserve(total);
+    for(uint8_t byte : signature) { encoded.push_back(static_cast<std::byte>(byte)); }
+
+    std::vector<std::byte> header;
+    append_u32(header, static_cast<uint32_t>(width));
+    append_u32(header, static_cast<uint32_t>(height));
+    for(uint8_t byte : { uint8_t(8), color_types[channels], uint8_t(0), uint8_t(0), uint8_t(0) }) {
+        header.push_back(static_cast<std::byte>(byte));
+    }
+    append_chunk(encoded, "IHDR", header);
+
+    uint32_t adler = 1;
+    for(const Band& band : bands) {
+        append_chunk(encoded, "IDAT", band.compressed);
+        adler = adler32_combine(adler, band.adler, band.size);
+    }
+
+    std::vector<std::byte> checksum;
+    append_u32(checksum, adler);
+    append_chunk(encoded, "IDAT", checksum);
+    append_chunk(encoded, "IEND", {});
+
+    return encoded;
+}
@@ -0,0 +1,251 @@
+/***************************************************************************************************
+ * @file  qoi.cpp
+ * @brief Implementation of the encoder and decoder of the QOI image format
+ **************************************************************************************************/
+
+#include "qoi.hpp"
+
+#include <bit>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    /// The first 4 bytes of every QOI file.
+    constexpr uint8_t magic[4] = { 'q', 'o', 'i', 'f' };
+
+    /// The size in bytes of the header.
+    constexpr std::size_t header_size = 14;
+
+    /// The 8 bytes ending every QOI stream.
+    constexpr uint8_t end_marker[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+
+    /// Maximum number of pixels of an image, to reject corrupted headers before allocating.
+    constexpr uint64_t max_pixels = 400'000'000;
+
+    /// The 8-bit tags of the chunks.
+    constexpr uint8_t op_rgb = 0xFE;
+    constexpr uint8_t op_rgba = 0xFF;
+
+    /// The 2-bit tags of the chunks, in the 2 high bits.
+    constexpr uint8_t op_index = 0x00;
+    constexpr uint8_t op_diff = 0x40;
+    constexpr uint8_t op_luma = 0x80;
+    constexpr uint8_t op_run = 0xC0;
+    constexpr uint8_t op_mask = 0xC0;
+
+    /**
+     * @struct Pixel
+     * @brief An RGBA pixel as the codec sees it.
+     */
+    struct Pixel {
+        uint8_t r; ///< The red channel.
+        uint8_t g; ///< The green channel.
+        uint8_t b; ///< The blue channel.
+        uint8_t a; ///< The alpha channel.
+
+        /**
+         * @param other The pixel to compare with.
+         * @return Whether both pixels are equal.
+         */
+        bool operator ==(const Pixel& other) const {
+            return std::bit_cast<uint32_t>(*this) == std::bit_cast<uint32_t>(other);
+        }
+    };
+
+    /**
+     * @param pixel A pixel.
+     * @return The position of the pixel in the table of recently seen pixels.
+     */
+    uint8_t hash(const Pixel& pixel) {
+        return (pixel.r * 3 + pixel.g * 5 + pixel.b * 7 + pixel.a * 11) % 64;
+    }
+
+    /**
+     * @brief Writes a 32-bit big-endian integer.
+     * @param output Where to write the integer.
+     * @param value The integer.
+     */
+    void write_u32(uint8_t* output, uint32_t value) {
+        output[0] = value >> 24;
+        output[1] = value >> 16;
+        output[2] = value >> 8;
+        output[3] = value;
+    }
+
+    /**
+     * @brief Reads a 32-bit big-endian integer.
+     * @param input Where to read the integer.
+     * @return The integer.
+     */
+    uint32_t read_u32(const uint8_t* input) {
+        return uint32_t(input[0]) << 24 | uint32_t(input[1]) << 16 | uint32_t(input[2]) << 8 | input[3];
+    }
+}
+
+std::vector<std::byte> qoi_encode(const uint8_t* pixels, std::ptrdiff_t stride, const QoiHeader& header) {
+    if(header.channels != 3 && header.channels != 4) {
+        throw std::runtime_error("Couldn't encode QOI data: unsupported channel count");
+    }
+
+    // Every pixel takes at most one tag byte and its channels, which bounds the size of the output.
+    std::size_t channels = header.channels;
+    std::size_t max_size = header_size + std::size_t(header.width) * header.height * (channels + 1) + sizeof(end_marker);
+    std::vector<std::byte> encoded(max_size);
+    uint8_t* output = reinterpret_cast<uint8_t*>(encoded.data());
+
+    std::memcpy(output, magic, sizeof(magic));
+    write_u32(output + 4, header.width);
+    write_u32(output + 8, header.height);
+    output[12] = header.channels;
+    output[13] = header.colorspace;
+    output += header_size;
+
+    Pixel index[64] {};
+    Pixel previous { 0, 0, 0, 255 };
+    Pixel pixel = previous;
+    unsigned int run = 0;
+
+    for(uint32_t i = 0 ; i < header.height ; ++i) {
+        const uint8_t* row = pixels + static_cast<std::ptrdiff_t>(i) * stride;
+
+        for(uint32_t j = 0 ; j < header.width ; ++j) {
+            const uint8_t* source = row + j * channels;
+            pixel.r = source[0];
+            pixel.g = source[1];
+            pixel.b = source[2];
+            if(channels == 4) { pixel.a = source[3]; }
+
+            if(pixel == previous) {
+                if(++run == 62) {
+                    *output++ = op_run | (run - 1);
+                    run = 0;
+                }
+                continue;
+            }
+
+            if(run > 0) {
+                *output++ = op_run | (run - 1);
+                run = 0;
+            }
+
+            uint8_t position = hash(pixel);
+            if(index[position] == pixel) {
+                *output++ = op_index | position;
+            } else {
+                index[position] = pixel;
+
+                if(pixel.a == previous.a) {
+                    int8_t dr = static_cast<int8_t>(pixel.r - previous.r);
+                    int8_t dg = static_cast<int8_t>(pixel.g - previous.g);
+                    int8_t db = static_cast<int8_t>(pixel.b - previous.b);
+                    int dr_dg = dr - dg;
+                    int db_dg = db - dg;
+
+                    if(dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                        *output++ = op_diff | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2);
+                    } else if(dg >= -32 && dg <= 31 && dr_dg >= -8 && dr_dg <= 7 && db_dg >= -8 && db_dg <= 7) {
+                        *output++ = op_luma | (dg + 32);
+                        *output++ = (dr_dg + 8) << 4 | (db_dg + 8);
+                    } else {
+                        *output++ = op_rgb;
+                        *output++ = pixel.r;
+                        *output++ = pixel.g;
+                        *output++ = pixel.b;
+                    }
+                } else {
+                    *output++ = op_rgba;
+                    *output++ = pixel.r;
+                    *output++ = pixel.g;
+                    *output++ = pixel.b;
+                    *output++ = pixel.a;
+                }
+            }
+
+            previous = pixel;
+        }
+    }
+
+    if(run > 0) { *output++ = op_run | (run - 1); }
+
+    std::memcpy(output, end_marker, sizeof(end_marker));
+    output += sizeof(end_marker);
+
+    encoded.resize(output - reinterpret_cast<uint8_t*>(encoded.data()));
+    return encoded;
+}
+
+QoiHeader qoi_read_header(std::span<const std::byte> data) {
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(data.data());
+
+    if(data.size() < header_size + sizeof(end_marker) || std::memcmp(input, magic, sizeof(magic)) != 0) {
+        throw std::runtime_error("Couldn't decode QOI data: invalid header");
+    }
+
+    QoiHeader header { read_u32(input + 4), read_u32(input + 8), input[12], input[13] };
+    if(header.width == 0 || header.height == 0 || (header.channels != 3 && header.channels != 4)
+       || header.colorspace > 1 || uint64_t(header.width) * header.height > max_pixels) {
+        throw std::runtime_error("Couldn't decode QOI data: invalid header");
+    }
+
+    return header;
+}
+
+void qoi_decode(std::span<const std::byte> data, uint8_t* pixels, std::size_t channels) {
+    if(channels != 3 && channels != 4) { throw std::runtime_error("Couldn't decode QOI data: unsupported channel count"); }
+
+    QoiHeader header = qoi_read_header(data);
+    const uint8_t* input = reinterpret_cast<const uint8_t*>(data.data());
+
+    // Chunks are at most 5 bytes long and the end marker is 8 bytes long, so a chunk starting before
+    // the end marker can be read without checking the size.
+    std::size_t chunks_end = data.size() - sizeof(end_marker);
+    std::size_t position = header_size;
+
+    Pixel index[64] {};
+    Pixel pixel { 0, 0, 0, 255 };
+    unsigned int run = 0;
+
+    std::size_t count = std::size_t(header.width) * header.height;
+    for(std::size_t i = 0 ; i < count ; ++i) {
+        if(run > 0) {
+            --run;
+        } else if(position < chunks_end) {
+            uint8_t tag = input[position++];
+
+            if(tag == op_rgb) {
+                pixel.r = input[position];
+                pixel.g = input[position + 1];
+                pixel.b = input[position + 2];
+                position += 3;
+            } else if(tag == op_rgba) {
+                pixel.r = input[position];
+                pixel.g = input[position + 1];
+                pixel.b = input[position + 2];
+                pixel.a = input[position + 3];
+                position += 4;
+            } else if((tag & op_mask) == op_index) {
+                pixel = index[tag];
+            } else if((tag & op_mask) == op_diff) {
+                pixel.r += ((tag >> 4) & 0x03) - 2;
+                pixel.g += ((tag >> 2) & 0x03) - 2;
+                pixel.b += (tag & 0x03) - 2;
+            } else if((tag & op_mask) == op_luma) {
+                uint8_t next = input[position++];
+                int dg = (tag & 0x3F) - 32;
+                pixel.r += dg - 8 + ((next >> 4) & 0x0F);
+                pixel.g += dg;
+                pixel.b += dg - 8 + (next & 0x0F);
+            } else {
+                run = tag & 0x3F;
+            }
+
+            index[hash(pixel)] = pixel;
+        }
+
+        uint8_t* destination = pixels + i * channels;
+        destination[0] = pixel.r;
+        destination[1] = pixel.g;
+        destination[2] = pixel.b;
+        if(channels == 4) { destination[3] = pixel.a; }
+    }
+}
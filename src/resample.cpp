@@ -0,0 +1,255 @@
+/***************************************************************************************************
+ * @file  resample.cpp
+ * @brief Implementation of the separable resampling of images to other dimensions
+ **************************************************************************************************/
+
+#include "resample.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include "Array.hpp"
+#include "array_math.hpp"
+#include "parallel.hpp"
+
+namespace {
+    /// The 3 channels of a pixel and a fourth unused one, loaded and stored at once.
+    typedef float PixelVector __attribute__((vector_size(16)));
+
+    /// Minimum number of destination rows of a band, so that the source rows shared by consecutive
+    /// bands, which are resampled horizontally by both, stay a small part of the work.
+    constexpr std::size_t min_band_rows = 32;
+
+    /**
+     * @param filter A filter.
+     * @return The radius of the filter, in destination pixels.
+     */
+    double radius_of(ResampleFilter filter) {
+        switch(filter) {
+            case ResampleFilter::Nearest: return 0.5;
+            case ResampleFilter::Bilinear: return 1.0;
+            case ResampleFilter::Bicubic:
+            case ResampleFilter::Mitchell: return 2.0;
+            case ResampleFilter::Lanczos3: return 3.0;
+        }
+        return 1.0;
+    }
+
+    /**
+     * @param x A value.
+     * @return The normalized sinc of the value.
+     */
+    double sinc(double x) {
+        if(std::abs(x) < 1e-8) { return 1.0; }
+        x *= std::numbers::pi;
+        return std::sin(x) / x;
+    }
+
+    /**
+     * @param filter A filter other than Nearest.
+     * @param x The distance to the center of the filter, in destination pixels.
+     * @return The unnormalized weight of the filter at that distance.
+     */
+    double weight_of(ResampleFilter filter, double x) {
+        x = std::abs(x);
+        switch(filter) {
+            case ResampleFilter::Bilinear:
+                return x < 1.0 ? 1.0 - x : 0.0;
+            case ResampleFilter::Bicubic: {
+                constexpr double a = -0.5;
+                if(x < 1.0) { return ((a + 2.0) * x - (a + 3.0)) * x * x + 1.0; }
+                if(x < 2.0) { return ((a * x - 5.0 * a) * x + 8.0 * a) * x - 4.0 * a; }
+                return 0.0;
+            }
+            case ResampleFilter::Mitchell: {
+                constexpr double b = 1.0 / 3.0;
+                constexpr double c = 1.0 / 3.0;
+                if(x < 1.0) { return ((12.0 - 9.0 * b - 6.0 * c) * x * x * x + (-18.0 + 12.0 * b + 6.0 * c) * x * x + (6.0 - 2.0 * b)) / 6.0; }
+                if(x < 2.0) {
+                    return ((-b - 6.0 * c) * x * x * x + (6.0 * b + 30.0 * c) * x * x + (-12.0 * b - 48.0 * c) * x + (8.0 * b + 24.0 * c)) / 6.0;
+                }
+                return 0.0;
+            }
+            case ResampleFilter::Lanczos3:
+                return x < 3.0 ? sinc(x) * sinc(x / 3.0) : 0.0;
+            default:
+                return 0.0;
+        }
+    }
+
+    /**
+     * @brief Resamples a row horizontally, a pixel at a time, the 3 channels of a pixel being
+     * accumulated in a single vector.
+     * @param row The source row, padded with its edge pixels so that taps never need to be clamped,
+     * followed by an extra float.
+     * @param padding The number of pixels padding the left of the row.
+     * @param weights The horizontal weights.
+     * @param destination The resampled row.
+     * @param width The number of destination pixels.
+     */
+    void resample_row(const float* row, std::ptrdiff_t padding, const ResampleWeights& weights,
+                      float* destination, std::size_t width) {
+        std::size_t taps = weights.taps;
+
+        for(std::size_t j = 0 ; j < width ; ++j) {
+            const float* pixels = row + 3 * (weights.first[j] + padding);
+            const float* pixel_weights = &weights.weights[j * taps];
+
+            // Two accumulators halve the chain of dependent additions.
+            PixelVector sums[2] {};
+            std::size_t t = 0;
+            for(; t + 2 <= taps ; t += 2) {
+                PixelVector pixel[2];
+                __builtin_memcpy(pixel, pixels + 3 * t, sizeof(PixelVector));
+                __builtin_memcpy(pixel + 1, pixels + 3 * t + 3, sizeof(PixelVector));
+                sums[0] += pixel_weights[t] * pixel[0];
+                sums[1] += pixel_weights[t + 1] * pixel[1];
+            }
+            if(t < taps) {
+                PixelVector pixel;
+                __builtin_memcpy(&pixel, pixels + 3 * t, sizeof(pixel));
+                sums[0] += pixel_weights[t] * pixel;
+            }
+            PixelVector sum = sums[0] + sums[1];
+
+            // The fourth float is overwritten by the next pixel, except for the last one.
+            __builtin_memcpy(destination + 3 * j, &sum, j + 1 < width ? sizeof(sum) : 3 * sizeof(float));
+        }
+    }
+}
+
+ResampleWeights compute_resample_weights(std::size_t source_size, std::size_t destination_size, ResampleFilter filter) {
+    ResampleWeights weights;
+    if(source_size == 0 || destination_size == 0) { return weights; }
+
+    double scale = static_cast<double>(source_size) / static_cast<double>(destination_size);
+    weights.first.resize(destination_size);
+
+    if(filter == ResampleFilter::Nearest) {
+        weights.taps = 1;
+        weights.weights.assign(destination_size, 1.0f);
+        for(std::size_t j = 0 ; j < destination_size ; ++j) {
+            weights.first[j] = std::min(static_cast<std::ptrdiff_t>((j + 0.5) * scale),
+                                        static_cast<std::ptrdiff_t>(source_size) - 1);
+        }
+        return weights;
+    }
+
+    // Shrinking widens the filter, so that it covers every source pixel.
+    double filter_scale = std::max(scale, 1.0);
+    double support = radius_of(filter) * filter_scale;
+
+    // The taps of pixel j are the source pixels whose center lies within the support.
+    auto first_of = [&](std::size_t j) {
+        return static_cast<std::ptrdiff_t>(std::ceil((j + 0.5) * scale - support - 0.5));
+    };
+    auto last_of = [&](std::size_t j) {
+        return static_cast<std::ptrdiff_t>(std::floor((j + 0.5) * scale + support - 0.5));
+    };
+    for(std::size_t j = 0 ; j < destination_size ; ++j) {
+        weights.first[j] = first_of(j);
+        weights.taps = std::max(weights.taps, static_cast<std::size_t>(last_of(j) - first_of(j) + 1));
+    }
+
+    weights.weights.resize(destination_size * weights.taps);
+    std::vector<double> values(weights.taps);
+    for(std::size_t j = 0 ; j < destination_size ; ++j) {
+        double center = (j + 0.5) * scale;
+        double sum = 0.0;
+        for(std::size_t t = 0 ; t < weights.taps ; ++t) {
+            double pixel = static_cast<double>(weights.first[j] + static_cast<std::ptrdiff_t>(t)) + 0.5;
+            values[t] = weight_of(filter, (pixel - center) / filter_scale);
+            sum += values[t];
+        }
+        for(std::size_t t = 0 ; t < weights.taps ; ++t) {
+            weights.weights[j * weights.taps + t] = static_cast<float>(values[t] / sum);
+        }
+    }
+
+    return weights;
+}
+
+void resample(Array2DView<const vec3> source, Array2DView<vec3> destination, ResampleFilter filter, ThreadPool& pool) {
+    if(destination.empty()) { return; }
+    if(source.empty()) { throw std::invalid_argument("Couldn't resample an empty image"); }
+
+    std::size_t height = destination.get_height();
+    std::size_t width = destination.get_width();
+    ResampleWeights rows = compute_resample_weights(source.get_height(), height, filter);
+    ResampleWeights columns = compute_resample_weights(source.get_width(), width, filter);
+    std::size_t grain = std::max(min_band_rows, default_tile_bytes / (sizeof(vec3) * width));
+
+    if(filter == ResampleFilter::Nearest) {
+        parallel_for(0, height, grain, [&](std::size_t begin, std::size_t end) {
+            for(std::size_t i = begin ; i < end ; ++i) {
+                ArrayView<const vec3> row = source[rows.first[i]];
+                ArrayView<vec3> output = destination[i];
+                for(std::size_t j = 0 ; j < width ; ++j) { output[j] = row[columns.first[j]]; }
+            }
+        }, pool);
+        return;
+    }
+
+    auto clamp_row = [&](std::ptrdiff_t row) {
+        return static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(row, 0, static_cast<std::ptrdiff_t>(source.get_height()) - 1));
+    };
+
+    // The padding of source rows, so that horizontal taps never leave them.
+    std::size_t source_width = source.get_width();
+    std::ptrdiff_t left = std::max<std::ptrdiff_t>(-columns.first.front(), 0);
+    std::ptrdiff_t right = std::max<std::ptrdiff_t>(columns.first.back() + static_cast<std::ptrdiff_t>(columns.taps)
+                                                    - static_cast<std::ptrdiff_t>(source_width), 0);
+    std::size_t padded_width = source_width + left + right;
+
+    /*
+     * The horizontal pass is the costliest, its taps gathering whole pixels. Shrinking vertically
+     * first runs it on the destination rows only, and enlarging vertically last on the source rows
+     * only. Either way, the vertical pass is a vectorized weighted sum of whole rows.
+     */
+    bool vertical_first = height <= source.get_height();
+
+    parallel_for(0, height, grain, [&](std::size_t begin, std::size_t end) {
+        Array<float> padded(3 * padded_width + 1, uninitialized);
+        vec3* padded_pixels = reinterpret_cast<vec3*>(padded.get_data());
+        padded[3 * padded_width] = 0.0f;
+        std::vector<const float*> sources(rows.taps);
+
+        auto pad = [&] {
+            std::fill_n(padded_pixels, left, padded_pixels[left]);
+            std::fill_n(padded_pixels + left + source_width, right, padded_pixels[left + source_width - 1]);
+        };
+
+        if(vertical_first) {
+            for(std::size_t i = begin ; i < end ; ++i) {
+                for(std::size_t t = 0 ; t < rows.taps ; ++t) {
+                    sources[t] = &source[clamp_row(rows.first[i] + static_cast<std::ptrdiff_t>(t))][0].x;
+                }
+                weighted_sum_n(sources.data(), &rows.weights[i * rows.taps], rows.taps,
+                               padded.get_data() + 3 * left, 3 * source_width);
+                pad();
+                resample_row(padded.get_data(), left, columns, &destination[i][0].x, width);
+            }
+            return;
+        }
+
+        // Every source row the band's vertical taps read is resampled horizontally first.
+        std::size_t first_row = clamp_row(rows.first[begin]);
+        std::size_t last_row = clamp_row(rows.first[end - 1] + static_cast<std::ptrdiff_t>(rows.taps) - 1);
+        Array<float> band((last_row - first_row + 1) * 3 * width, uninitialized);
+
+        for(std::size_t r = first_row ; r <= last_row ; ++r) {
+            std::ranges::copy(source[r], padded_pixels + left);
+            pad();
+            resample_row(padded.get_data(), left, columns, &band[(r - first_row) * 3 * width], width);
+        }
+
+        for(std::size_t i = begin ; i < end ; ++i) {
+            for(std::size_t t = 0 ; t < rows.taps ; ++t) {
+                std::size_t row = clamp_row(rows.first[i] + static_cast<std::ptrdiff_t>(t));
+                sources[t] = &band[(row - first_row) * 3 * width];
+            }
+            weighted_sum_n(sources.data(), &rows.weights[i * rows.taps], rows.taps, &destination[i][0].x, 3 * width);
+        }
+    }, pool);
+}
@@ -0,0 +1,42 @@
+/***************************************************************************************************
+ * @file  simd.cpp
+ * @brief Implementation of the runtime SIMD instruction set selection
+ **************************************************************************************************/
+
+#include "simd.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+SimdLevel detect_simd_level() {
+#if defined(__x86_64__)
+    // libgcc only reports AVX features when the operating system saves the wide registers.
+    if(__builtin_cpu_supports("avx512f")) { return SimdLevel::AVX512; }
+    if(__builtin_cpu_supports("avx2")) { return SimdLevel::AVX2; }
+    return SimdLevel::SSE2;
+#else
+    return SimdLevel::Scalar;
+#endif
+}
+
+/// The instruction set the kernels dispatch to.
+static std::atomic<SimdLevel> current_level = detect_simd_level();
+
+SimdLevel get_simd_level() {
+    return current_level.load(std::memory_order_relaxed);
+}
+
+void set_simd_level(SimdLevel level) {
+    current_level.store(std::min(level, detect_simd_level()), std::memory_order_relaxed);
+}
+
+const char* to_string(SimdLevel level) {
+    switch(level) {
+        case SimdLevel::Scalar: return "Scalar";
+        case SimdLevel::SSE2: return "SSE2";
+        case SimdLevel::AVX2: return "AVX2";
+        case SimdLevel::AVX512: return "AVX-512";
+    }
+
+    return "Unknown";
+}
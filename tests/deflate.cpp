@@ -0,0 +1,117 @@
+/***************************************************************************************************
+ * @file  deflate.cpp
+ * @brief Round-trips the deflate compressor and the PNG encoder through stb_image's decoders
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "deflate.hpp"
+#include "png.hpp"
+#include "stb_image.h"
+#include "ThreadPool.hpp"
+#include "tests.hpp"
+
+/**
+ * @brief Generates data alternating runs of random bytes, which end up in stored blocks, and runs
+ * drawn from a few bytes with repeats, which end up in Huffman blocks with matches.
+ * @param size The number of bytes.
+ * @param random The random generator.
+ * @return The data.
+ */
+static std::vector<uint8_t> mixed_data(std::size_t size, std::mt19937& random) {
+    std::vector<uint8_t> data;
+    data.reserve(size);
+    while(data.size() < size) {
+        std::size_t run = std::min<std::size_t>(size - data.size(), random() % 20000 + 1);
+        switch(random() % 3) {
+            case 0:
+                for(std::size_t i = 0 ; i < run ; ++i) { data.push_back(static_cast<uint8_t>(random())); }
+                break;
+            case 1:
+                for(std::size_t i = 0 ; i < run ; ++i) { data.push_back(static_cast<uint8_t>('a' + random() % 4)); }
+                break;
+            default:
+                for(std::size_t i = 0 ; i < run ; ++i) {
+                    data.push_back(data.size() >= 37 && random() % 8 != 0 ? data[data.size() - 37]
+                                                                            : static_cast<uint8_t>(random()));
+                }
+                break;
+        }
+    }
+    return data;
+}
+
+/**
+ * @brief Decompresses raw deflate data with stb_image's inflater and compares it to the original.
+ * @param compressed The raw deflate data.
+ * @param data The original data.
+ * @param what The description of the data, for the failure message.
+ */
+static void check_inflate(const std::vector<std::byte>& compressed, const std::vector<uint8_t>& data,
+                          const std::string& what) {
+    int size = 0;
+    char* inflated = stbi_zlib_decode_noheader_malloc(reinterpret_cast<const char*>(compressed.data()),
+                                                      static_cast<int>(compressed.size()), &size);
+    bool same = inflated != nullptr && static_cast<std::size_t>(size) == data.size()
+                && (data.empty() || std::memcmp(inflated, data.data(), data.size()) == 0);
+    std::free(inflated);
+    check(same, "Inflating " + what + " didn't give the original data");
+}
+
+void test_deflate() {
+    std::mt19937 random(1234);
+
+    // Sizes around and well above a block of symbols, so that blocks are split in every way.
+    for(std::size_t size : { 0, 1, 100, 16383, 16385, 70000, 300000 }) {
+        std::vector<uint8_t> data = mixed_data(size, random);
+        for(int level = 0 ; level <= max_compression_level ; ++level) {
+            std::string what = std::to_string(size) + " bytes at level " + std::to_string(level);
+
+            std::vector<std::byte> compressed;
+            deflate(data.data(), data.size(), level, DeflateFlush::Finish, compressed);
+            check_inflate(compressed, data, what);
+
+            // Pieces ended by sync flushes, as compressed by the PNG encoder.
+            compressed.clear();
+            std::size_t half = size / 2;
+            deflate(data.data(), half, level, DeflateFlush::Sync, compressed);
+            deflate(data.data() + half, size - half, level, DeflateFlush::Finish, compressed);
+            check_inflate(compressed, data, what + " in 2 pieces");
+        }
+    }
+
+    // Noise, partly smoothed so that some rows compress, for every number of channels.
+    ThreadPool pool(4);
+    for(std::size_t channels = 1 ; channels <= 4 ; ++channels) {
+        for(int level : { 0, 1, 4, 5, 9 }) {
+            std::size_t width = random() % 700 + 1;
+            std::size_t height = random() % 700 + 1;
+            std::vector<uint8_t> pixels(width * height * channels);
+            for(std::size_t i = 0 ; i < pixels.size() ; ++i) {
+                pixels[i] = i >= channels && random() % 4 == 0 ? pixels[i - channels] : static_cast<uint8_t>(random());
+            }
+            std::string what = std::to_string(width) + "x" + std::to_string(height) + "x" + std::to_string(channels)
+                               + " PNG at level " + std::to_string(level);
+
+            std::vector<std::byte> encoded = png_encode(pixels.data(), static_cast<std::ptrdiff_t>(width * channels),
+                                                        width, height, channels, level, pool);
+            int decoded_width = 0;
+            int decoded_height = 0;
+            int decoded_channels = 0;
+            stbi_uc* decoded = stbi_load_from_memory(reinterpret_cast<const stbi_uc*>(encoded.data()),
+                                                     static_cast<int>(encoded.size()), &decoded_width,
+                                                     &decoded_height, &decoded_channels, static_cast<int>(channels));
+            bool same = decoded != nullptr && static_cast<std::size_t>(decoded_width) == width
+                        && static_cast<std::size_t>(decoded_height) == height
+                        && std::memcmp(decoded, pixels.data(), pixels.size()) == 0;
+            stbi_image_free(decoded);
+            check(same, "Decoding a " + what + " didn't give the original pixels");
+        }
+    }
+}
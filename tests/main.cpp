@@ -0,0 +1,45 @@
+/***************************************************************************************************
+ * @file  main.cpp
+ * @brief Runs the tests given on the command line, or all of them
+ **************************************************************************************************/
+
+#include <exception>
+#include <iostream>
+#include <string_view>
+
+#include "tests.hpp"
+
+/**
+ * @struct Test
+ * @brief A test that can be selected by name on the command line.
+ */
+struct Test {
+    std::string_view name; ///< The name of the test.
+    void (*run)();         ///< The function running the test.
+};
+
+/// All the available tests.
+static constexpr Test tests[] = {
+    { "deflate", test_deflate },
+    { "tiled_image", test_tiled_image },
+};
+
+int main(int argc, char** argv) {
+    int failures = 0;
+
+    for(const Test& test : tests) {
+        bool selected = argc == 1;
+        for(int i = 1 ; i < argc ; ++i) { selected |= test.name == argv[i]; }
+        if(!selected) { continue; }
+
+        try {
+            test.run();
+            std::cout << "PASSED " << test.name << '\n';
+        } catch(const std::exception& exception) {
+            std::cerr << "FAILED " << test.name << " : " << exception.what() << '\n';
+            ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
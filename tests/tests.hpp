@@ -0,0 +1,31 @@
+/***************************************************************************************************
+ * @file  tests.hpp
+ * @brief Declaration of the tests and of their shared helpers
+ **************************************************************************************************/
+
+#pragma once
+
+#include <stdexcept>
+#include <string>
+
+/**
+ * @brief Fails the running test if a condition doesn't hold.
+ * @param condition The condition.
+ * @param message What went wrong, printed when the condition doesn't hold.
+ * @note Throws a std::runtime_error with the message if the condition doesn't hold.
+ */
+inline void check(bool condition, const std::string& message) {
+    if(!condition) { throw std::runtime_error(message); }
+}
+
+/**
+ * @brief Round-trips raw deflate data, for every compression level and for inputs larger than a
+ * block, and PNG files through stb_image's decoders.
+ */
+void test_deflate();
+
+/**
+ * @brief Checks that the regions read from a TiledImage replicate its edges, including regions
+ * further from the image than its size.
+ */
+void test_tiled_image();
@@ -0,0 +1,52 @@
+/***************************************************************************************************
+ * @file  tiled_image.cpp
+ * @brief Checks the regions read from a TiledImage, inside and around the image
+ **************************************************************************************************/
+
+#include <algorithm>
+#include <string>
+
+#include "Array2D.hpp"
+#include "TiledImage.hpp"
+#include "vec.hpp"
+#include "tests.hpp"
+
+void test_tiled_image() {
+    // Tiles small enough that regions span several of them, and too few to keep them all in memory.
+    TiledImageOptions options;
+    options.tile_size = 2;
+    options.max_resident_tiles = 3;
+
+    // Images smaller than, as large as and larger than a tile.
+    for(auto [height, width] : { std::pair<std::size_t, std::size_t>(3, 3), { 1, 5 }, { 2, 2 }, { 7, 5 } }) {
+        TiledImage image(height, width, options);
+
+        Array2D<vec3> pixels(height, width);
+        for(std::size_t i = 0 ; i < height ; ++i) {
+            for(std::size_t j = 0 ; j < width ; ++j) { pixels(i, j) = vec3(i, j, i * width + j); }
+        }
+        image.write_region(0, 0, pixels);
+
+        // Regions inside the image, overlapping it, and outside of it with aprons larger than it.
+        for(std::ptrdiff_t row = -12 ; row <= 12 ; ++row) {
+            for(std::ptrdiff_t column = -12 ; column <= 12 ; ++column) {
+                for(auto [rows, columns] : { std::pair<std::size_t, std::size_t>(1, 1), { 4, 11 }, { 20, 3 } }) {
+                    Array2D<vec3> region(rows, columns);
+                    image.read_region(row, column, region);
+
+                    for(std::size_t i = 0 ; i < rows ; ++i) {
+                        for(std::size_t j = 0 ; j < columns ; ++j) {
+                            std::size_t y = std::clamp<std::ptrdiff_t>(row + i, 0, height - 1);
+                            std::size_t x = std::clamp<std::ptrdiff_t>(column + j, 0, width - 1);
+                            check(region(i, j) == pixels(y, x),
+                                  "Reading a " + std::to_string(rows) + "x" + std::to_string(columns) + " region at ("
+                                  + std::to_string(row) + ", " + std::to_string(column) + ") of a "
+                                  + std::to_string(height) + "x" + std::to_string(width)
+                                  + " image didn't clamp to the edges");
+                        }
+                    }
+                }
+            }
+        }
+    }
+}